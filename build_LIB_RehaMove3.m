@@ -42,8 +42,8 @@ def.OutputFcnSpec =    'void lctRM3_InputOutput( void **work1, double u1[p6][p5]
 def.TerminateFcnSpec = 'void lctRM3_Deinitialise( void **work1 )';
 def.IncPaths     = {fullfile(pwd, 'srcRehaMove_LibV3.2', 'src'), fullfile(pwd, 'incRehaMove_LibV3.2_lin_x86_64', 'include', 'general'), fullfile(pwd, 'incRehaMove_LibV3.2_lin_x86_64', 'include', 'low-level'), fullfile(pwd, 'incRehaMove_LibV3.2_lin_x86_64', 'include', 'mid-level')};
 def.SrcPaths     = {fullfile(pwd, 'srcRehaMove_LibV3.2', 'src')};
-def.HeaderFiles  = {'RehaMove3Interface_SMPT32X.hpp', 'block_RehaMove3_01.hpp'};
-def.SourceFiles  = {'RehaMove3Interface_SMPT32X.cpp', 'block_RehaMove3_01.cpp'};
+def.HeaderFiles  = {'RehaMove3Interface_SMPT32X.hpp', 'RehaMove3Telemetry.hpp', 'RehaMove3Trace.hpp', 'RehaMove3BinaryLog.hpp', 'RehaMove3Manager.hpp', 'RehaMove3Registry.hpp', 'block_RehaMove3_01.hpp'};
+def.SourceFiles  = {'RehaMove3Interface_SMPT32X.cpp', 'RehaMove3Trace.cpp', 'RehaMove3Manager.cpp', 'RehaMove3Registry.cpp', 'block_RehaMove3_01.cpp'};
 def.LibPaths     = {fullfile(pwd, 'incRehaMove_LibV3.2_lin_x86_64', 'lib')};
 def.HostLibFiles = {'libsmpt.a'};
 def.TargetLibFiles  = {'libsmpt.a'};
@@ -52,6 +52,12 @@ def.Options.useTlcWithAccel = false;
 def.SampleTime   = 'parameterized';
 if (isSmptLibAvailable( 'smpt_rm3_gcc_linux_x86_amd64_static', 'incRehaMove_LibV3.2_lin_x86_64' ))
     defs{end+1} = def;
+    % same block with the step timing as second output
+    % -> [execution time (ms), period (ms), max. execution time (ms), max. period jitter (ms), execution overruns, period overruns]
+    defTiming = def;
+    defTiming.SFunctionName = 'sfunc_RehaMove3_01_timing';
+    defTiming.OutputFcnSpec = 'void lctRM3_InputOutputTiming( void **work1, double u1[p6][p5], double u2[p7][p5], double y1[2], double y2[6] )';
+    defs{end+1} = defTiming;
     srtAddPath{end+1} = fullfile(pwd, 'scripts', 'block_RehaMove3'); 
     srtAddPath{end+1} = fullfile(pwd, 'html', 'block_RehaMove3');
 else
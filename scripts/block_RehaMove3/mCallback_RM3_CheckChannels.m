@@ -1,5 +1,6 @@
 function mCallback_RM3_CheckChannels( )
-%MCALLBACK_RM3_CHECKCHANNELS checks that the input channels are only 1 ... 4.
+%MCALLBACK_RM3_CHECKCHANNELS checks that the input channels are only 1 ... 4 (per device).
+%   Several devices are given as comma separated paths or serial numbers -> channels 5 ... 8 are on the second device.
 
 %   TU Berlin --- Fachgebiet Regelungssystem
 %   Author: Markus Valtin
@@ -15,8 +16,13 @@ function mCallback_RM3_CheckChannels( )
     channelsStr = get_param(gcb, 'stimChannels');
     channels = round( evalin('caller', channelsStr) );
 
+    % number of devices -> comma separated lists of device paths or serial numbers
+    nDevices = max([numel(strfind(get_param(gcb, 'stimDevicePath'), ',')), numel(strfind(get_param(gcb, 'stimDeviceSerial'), ','))]) +1;
+    nDevices = min(nDevices, 3);
+    maxChannel = 4*nDevices;
+
     mode = get_param(gcb, 'stimRehaMoveProProtocol');
-    channelSet = [false, false, false, false];
+    channelSet = false(1, maxChannel);
     
     has_error = false;
     has_errorML = false;
@@ -25,7 +31,7 @@ function mCallback_RM3_CheckChannels( )
             channels(i) = 0; 
             has_error = true;
         end
-        if (channels(i) > 4)
+        if (channels(i) > maxChannel)
             channels(i) = 0; 
             has_error = true;
         end
@@ -47,7 +53,7 @@ function mCallback_RM3_CheckChannels( )
         end
     end
     if (has_error)
-        errordlg('Channels must be integers from 1 to 4!','Channel Config Error');
+        errordlg(sprintf('Channels must be integers from 1 to %d!', maxChannel),'Channel Config Error');
     end
     if (has_errorML)
         errordlg('The MidLevel Mode allows each channel only ONCE!','Channel Config Error');
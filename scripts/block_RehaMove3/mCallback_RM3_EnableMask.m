@@ -11,21 +11,27 @@ function mCallback_RM3_EnableMask( )
 %   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
 %   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
-tabStim = {'on','on','on','on','on','on','on','on','off','off','on','on','on','on'};
+% threads -> scheduling, CPUs and memory locking only with the advanced settings
+if (strcmp(get_param(gcb, 'miscEnableAdvancedSettings'), 'on'))
+    tabStimThreads = {'on','on','on','on'};
+else
+    tabStimThreads = {'off','off','off','off'};
+end
+tabStim = [{'on','on','on','on','on','on','on','on','off','off','on','on','on','on'}, tabStimThreads, {'on','on'}];
 
 switch get_param(gcb, 'stimRehaMoveProProtocol')
     case 'Use the LowLevel protocol   -> Each stimulation pulse is send separatly.'
-        tabLowLevel = { 'on','off','on','off' };
-        tabMidLevel = { 'off', 'off', 'off', 'off', 'off', 'off', 'off' };
+        tabLowLevel = { 'on','off','on','off','on' };
+        tabMidLevel = { 'off', 'off', 'off', 'off', 'off', 'off', 'off', 'off', 'off' };
     case 'Use the LowLevel protocol and use the user provieded pulse configs.'
-        tabLowLevel = { 'off','on','on','off' };
-        tabMidLevel = { 'off', 'off', 'off', 'off', 'off', 'off', 'off' };
+        tabLowLevel = { 'off','on','on','off','off' };
+        tabMidLevel = { 'off', 'off', 'off', 'off', 'off', 'off', 'off', 'off', 'off' };
     case 'Use the MidLevel protocol   -> Only stimulation pulse updates are send.'
-        tabLowLevel = { 'off','off','off','off' };
-        tabMidLevel = { 'on', 'on', 'on', 'on', 'on', 'on', 'on' };
+        tabLowLevel = { 'off','off','off','off','off' };
+        tabMidLevel = { 'on', 'on', 'on', 'on', 'on', 'on', 'on', 'on', 'on' };
     otherwise
-        tabLowLevel = { 'off','off','off','off' };
-        tabMidLevel = { 'off', 'off', 'off', 'off', 'off', 'off', 'off' };
+        tabLowLevel = { 'off','off','off','off','off' };
+        tabMidLevel = { 'off', 'off', 'off', 'off', 'off', 'off', 'off', 'off', 'off' };
         warning(['Unknown protocol: "', get_param(gcb, 'stimRehaMoveProProtocol'),'"']);
 end
 
@@ -36,8 +42,9 @@ if (strcmp(get_param(gcb, 'miscEnableAdvancedSettings'), 'on'))
 else
     tabMisc2 = {'on','off'};
 end
+tabMisc3 = {'on','on'};
 
-myEnableMask = [tabStim, tabLowLevel, tabMidLevel, tabMisc1, tabMisc2];
+myEnableMask = [tabStim, tabLowLevel, tabMidLevel, tabMisc1, tabMisc2, tabMisc3];
 enableMask = get_param(gcb,'MaskEnables')';
 
 if (min(strcmp(myEnableMask, enableMask)) == 0)
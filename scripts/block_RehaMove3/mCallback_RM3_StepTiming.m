@@ -0,0 +1,28 @@
+function mCallback_RM3_StepTiming( )
+%MCALLBACK_RM3_STEPTIMING selects the S-function with or without the step timing output.
+%   sfunc_RehaMove3_01_timing has the step timing as second output:
+%   [execution time (ms), period (ms), max. execution time (ms), max. period jitter (ms), execution overruns, period overruns]
+
+%   TU Berlin --- Fachgebiet Regelungssystem
+%   Author: agent
+%   Copyright © 2026 agent. All rights reserved.
+%
+%   This program is free software: you can redistribute it and/or modify it under the terms of the
+%   GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or any later version.
+%
+%   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+%   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+if (strcmp(get_param(gcb, 'miscStepTimingOutput'), 'on'))
+    functionName = 'sfunc_RehaMove3_01_timing';
+else
+    functionName = 'sfunc_RehaMove3_01';
+end
+
+%% set the updatet value
+if (~strcmp(get_param(gcb, 'FunctionName'), functionName))
+    set_param(gcb, 'FunctionName', functionName);
+end
+
+end
+
@@ -0,0 +1,337 @@
+/*
+ * RehaMove3ClockTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: agent
+ *
+ *  Host test of the timing of the interface class without a device: the SMPT library is replaced by a fake device, which
+ *  acknowledges every command at once, and the clock of the class by a virtual clock (SetClock), which is advanced by the test.
+ *  -> keep alive timer: one keep alive signal per KeepAlivePeriod_ms of the virtual time
+ *  -> keep alive of the update calls: one keep alive signal per KeepAliveNumberOfUpdateCalls +1 update calls, also if the updates
+ *     are coalesced by the update threat (UseUpdateMailbox, UpdateMinPeriod_ms)
+ *
+ *  Build: g++ -I../src -I<SMPT include directories> RehaMove3ClockTest.cpp ../src/RehaMove3Interface_SMPT32X.cpp ../src/RehaMove3Manager.cpp -lpthread -lrt -o RehaMove3ClockTest
+ *         (without libsmpt.a -> the SMPT functions are defined below)
+ *  Usage: RehaMove3ClockTest -> returns 0, if all tests passed
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <RehaMove3Interface_SMPT32X.hpp>
+
+using namespace nsRehaMove3_SMPT_32X_01;
+
+/*
+ * Virtual clock -> the time only advances with AdvanceTime_ms() and with the sleeps of the test thread (timeouts of the initialisation);
+ * the sleeps of the helper threats only yield
+ */
+static uint64_t  VirtualTime_ns = 1000000000;
+static pthread_t TestThread;
+
+static uint64_t VirtualNow_ns(void *Context)
+{
+	(void)Context;
+	return __atomic_load_n(&VirtualTime_ns, __ATOMIC_ACQUIRE);
+}
+
+static void VirtualSleep_us(void *Context, uint32_t Duration_us)
+{
+	(void)Context;
+	if (pthread_equal(pthread_self(), TestThread)){
+		__atomic_fetch_add(&VirtualTime_ns, (uint64_t)Duration_us *1000, __ATOMIC_ACQ_REL);
+	}
+	usleep(50);
+}
+
+static void AdvanceTime_ms(uint32_t Duration_ms)
+{
+	// 1ms per step -> the helper threats see every step
+	for (uint32_t i = 0; i < Duration_ms; i++){
+		__atomic_fetch_add(&VirtualTime_ns, (uint64_t)1000000, __ATOMIC_ACQ_REL);
+		usleep(3000);
+	}
+}
+
+/*
+ * Fake device -> every command is acknowledged at once
+ */
+#define FAKE_QUEUE_SIZE		4096
+static pthread_mutex_t FakeLock = PTHREAD_MUTEX_INITIALIZER;
+static Smpt_ack FakeQueue[FAKE_QUEUE_SIZE];
+static uint32_t FakeHead = 0, FakeTail = 0;
+static Smpt_ack FakeLastAck;
+static uint32_t FakeKeepAliveSignals = 0;
+static uint32_t FakeUpdates = 0;
+
+static bool FakeAck(uint8_t PacketNumber, Smpt_Cmd Command)
+{
+	pthread_mutex_lock(&FakeLock);
+	if (FakeHead - FakeTail < FAKE_QUEUE_SIZE){
+		Smpt_ack *Ack = &FakeQueue[FakeHead % FAKE_QUEUE_SIZE];
+		memset(Ack, 0, sizeof(Smpt_ack));
+		Ack->packet_number  = PacketNumber;
+		Ack->command_number = Command;
+		Ack->result 		= Smpt_Result_Successful;
+		FakeHead++;
+	}
+	pthread_mutex_unlock(&FakeLock);
+	return true;
+}
+
+static uint32_t FakeGetCounter(uint32_t *Counter)
+{
+	pthread_mutex_lock(&FakeLock);
+	uint32_t Value = *Counter;
+	pthread_mutex_unlock(&FakeLock);
+	return Value;
+}
+
+static void FakeResetCounters(void)
+{
+	pthread_mutex_lock(&FakeLock);
+	FakeKeepAliveSignals = 0;
+	FakeUpdates = 0;
+	pthread_mutex_unlock(&FakeLock);
+}
+
+extern "C" {
+void smpt_init_error_callback(Smpt_error_callback Callback) { (void)Callback; }
+Smpt_version smpt_library_version(void)
+{
+	Smpt_version Version;
+	memset(&Version, 0, sizeof(Version));
+	Version.major = RM3_SupportedVersionsSMPT[0][0]; Version.minor = RM3_SupportedVersionsSMPT[0][1]; Version.revision = RM3_SupportedVersionsSMPT[0][2];
+	return Version;
+}
+bool smpt_open_serial_port(Smpt_device *const device, const char *const device_name) { (void)device; (void)device_name; return true; }
+bool smpt_close_serial_port(Smpt_device *const device) { (void)device; return true; }
+bool smpt_new_packet_received(Smpt_device *const device)
+{
+	(void)device;
+	pthread_mutex_lock(&FakeLock);
+	bool Received = (FakeHead != FakeTail);
+	pthread_mutex_unlock(&FakeLock);
+	return Received;
+}
+void smpt_last_ack(Smpt_device *const device, Smpt_ack *const ack)
+{
+	(void)device;
+	pthread_mutex_lock(&FakeLock);
+	if (FakeHead != FakeTail){
+		FakeLastAck = FakeQueue[FakeTail % FAKE_QUEUE_SIZE];
+		FakeTail++;
+	}
+	*ack = FakeLastAck;
+	pthread_mutex_unlock(&FakeLock);
+}
+void smpt_clear_ack(Smpt_ack *const ack) { memset(ack, 0, sizeof(Smpt_ack)); }
+
+bool smpt_send_reset(Smpt_device *const device, uint8_t packet_number) 			 { (void)device; return FakeAck(packet_number, Smpt_Cmd_Reset_Ack); }
+bool smpt_send_get_device_id(Smpt_device *const device, uint8_t packet_number) 	 { (void)device; return FakeAck(packet_number, Smpt_Cmd_Get_Device_Id_Ack); }
+bool smpt_send_get_battery_status(Smpt_device *const device, uint8_t packet_number) { (void)device; return FakeAck(packet_number, Smpt_Cmd_Get_Battery_Status_Ack); }
+bool smpt_send_get_main_status(Smpt_device *const device, uint8_t packet_number) 	 { (void)device; return FakeAck(packet_number, Smpt_Cmd_Get_Main_Status_Ack); }
+bool smpt_send_get_stim_status(Smpt_device *const device, uint8_t packet_number) 	 { (void)device; return FakeAck(packet_number, Smpt_Cmd_Get_Stim_Status_Ack); }
+bool smpt_send_get_version_main(Smpt_device *const device, uint8_t packet_number)  { (void)device; return FakeAck(packet_number, Smpt_Cmd_Get_Version_Main_Ack); }
+bool smpt_send_get_version_stim(Smpt_device *const device, uint8_t packet_number)  { (void)device; return FakeAck(packet_number, Smpt_Cmd_Get_Version_Stim_Ack); }
+
+void smpt_clear_get_device_id_ack(Smpt_get_device_id_ack *const a) { memset(a, 0, sizeof(*a)); }
+bool smpt_get_get_device_id_ack(Smpt_device *const device, Smpt_get_device_id_ack *const a)
+{
+	(void)device;
+	memset(a->device_id, '0', sizeof(a->device_id));
+	a->packet_number = FakeLastAck.packet_number;
+	return true;
+}
+void smpt_clear_get_version_ack(Smpt_get_version_ack *const a) { memset(a, 0, sizeof(*a)); }
+static void FakeVersion(Smpt_get_version_ack *const a, const uint8_t FwVersion[3])
+{
+	a->packet_number = FakeLastAck.packet_number;
+	a->uc_version.fw_version.major = FwVersion[0]; a->uc_version.fw_version.minor = FwVersion[1]; a->uc_version.fw_version.revision = FwVersion[2];
+	a->uc_version.smpt_version.major = RM3_SupportedVersionsSMPT[0][0]; a->uc_version.smpt_version.minor = RM3_SupportedVersionsSMPT[0][1]; a->uc_version.smpt_version.revision = RM3_SupportedVersionsSMPT[0][2];
+}
+bool smpt_get_get_version_main_ack(Smpt_device *const device, Smpt_get_version_ack *const a) { (void)device; FakeVersion(a, RM3_SupportedVersionsMain[0]); return true; }
+bool smpt_get_get_version_stim_ack(Smpt_device *const device, Smpt_get_version_ack *const a) { (void)device; FakeVersion(a, RM3_SupportedVersionsStim[0]); return true; }
+void smpt_clear_get_battery_status_ack(Smpt_get_battery_status_ack *const a) { memset(a, 0, sizeof(*a)); }
+bool smpt_get_get_battery_status_ack(Smpt_device *const device, Smpt_get_battery_status_ack *const a) { (void)device; a->battery_level = 100; a->battery_voltage = 4000; return true; }
+void smpt_clear_get_main_status_ack(Smpt_get_main_status_ack *const a) { memset(a, 0, sizeof(*a)); }
+bool smpt_get_get_main_status_ack(Smpt_device *const device, Smpt_get_main_status_ack *const a) { (void)device; (void)a; return true; }
+void smpt_clear_get_stim_status_ack(Smpt_get_stim_status_ack *const a) { memset(a, 0, sizeof(*a)); }
+bool smpt_get_get_stim_status_ack(Smpt_device *const device, Smpt_get_stim_status_ack *const a) { (void)device; (void)a; return true; }
+
+// LowLevel -> not used by the tests
+void smpt_clear_ll_init(Smpt_ll_init *const a) { memset(a, 0, sizeof(*a)); }
+bool smpt_is_valid_ll_init(const Smpt_ll_init *const a) { (void)a; return true; }
+bool smpt_send_ll_init(Smpt_device *const device, const Smpt_ll_init *const a) { (void)device; return FakeAck(a->packet_number, Smpt_Cmd_Ll_Init_Ack); }
+void smpt_clear_ll_init_ack(Smpt_ll_init_ack *const a) { memset(a, 0, sizeof(*a)); }
+bool smpt_get_ll_init_ack(Smpt_device *const device, Smpt_ll_init_ack *const a) { (void)device; (void)a; return true; }
+void smpt_clear_ll_channel_config(Smpt_ll_channel_config *const a) { memset(a, 0, sizeof(*a)); }
+bool smpt_is_valid_ll_channel_config(const Smpt_ll_channel_config *const a) { (void)a; return true; }
+bool smpt_send_ll_channel_config(Smpt_device *const device, const Smpt_ll_channel_config *const a) { (void)device; return FakeAck(a->packet_number, Smpt_Cmd_Ll_Channel_Config_Ack); }
+void smpt_clear_ll_channel_config_ack(Smpt_ll_channel_config_ack *const a) { memset(a, 0, sizeof(*a)); }
+bool smpt_get_ll_channel_config_ack(Smpt_device *const device, Smpt_ll_channel_config_ack *const a) { (void)device; a->packet_number = FakeLastAck.packet_number; return true; }
+bool smpt_send_ll_stop(Smpt_device *const device, uint8_t packet_number) { (void)device; return FakeAck(packet_number, Smpt_Cmd_Ll_Stop_Ack); }
+
+// MidLevel
+void smpt_clear_ml_init(Smpt_ml_init *const a) { memset(a, 0, sizeof(*a)); }
+bool smpt_is_valid_ml_init(const Smpt_ml_init *const a) { (void)a; return true; }
+bool smpt_send_ml_init(Smpt_device *const device, const Smpt_ml_init *const a) { (void)device; return FakeAck(a->packet_number, Smpt_Cmd_Ml_Init_Ack); }
+void smpt_clear_ml_update(Smpt_ml_update *const a) { memset(a, 0, sizeof(*a)); }
+bool smpt_is_valid_ml_update(const Smpt_ml_update *const a) { (void)a; return true; }
+bool smpt_send_ml_update(Smpt_device *const device, const Smpt_ml_update *const a)
+{
+	(void)device;
+	pthread_mutex_lock(&FakeLock);
+	FakeUpdates++;
+	pthread_mutex_unlock(&FakeLock);
+	return FakeAck(a->packet_number, Smpt_Cmd_Ml_Update_Ack);
+}
+void smpt_clear_ml_get_current_data(Smpt_ml_get_current_data *const a) { memset(a, 0, sizeof(*a)); }
+bool smpt_send_ml_get_current_data(Smpt_device *const device, const Smpt_ml_get_current_data *const a)
+{
+	(void)device;
+	pthread_mutex_lock(&FakeLock);
+	FakeKeepAliveSignals++;
+	pthread_mutex_unlock(&FakeLock);
+	return FakeAck(a->packet_number, Smpt_Cmd_Ml_Get_Current_Data_Ack);
+}
+void smpt_clear_ml_get_current_data_ack(Smpt_ml_get_current_data_ack *const a) { memset(a, 0, sizeof(*a)); }
+bool smpt_get_ml_get_current_data_ack(Smpt_device *const device, Smpt_ml_get_current_data_ack *const a)
+{
+	(void)device;
+	a->packet_number = FakeLastAck.packet_number;
+	a->stimulation_data.stimulation_state = Smpt_Ml_Stimulation_Running;
+	return true;
+}
+bool smpt_send_ml_stop(Smpt_device *const device, uint8_t packet_number) { (void)device; return FakeAck(packet_number, Smpt_Cmd_Ml_Stop_Ack); }
+} // extern "C"
+
+
+/*
+ * Tests
+ */
+static RehaMove3* OpenDevice(const char *InterfaceFile, RehaMove3::rmInitSettings_t *InitSetup)
+{
+	RehaMove3 *Device = new RehaMove3("ClockTest", InterfaceFile);
+	RehaMove3::rmClock_t Clock;
+	Clock.Now_ns   = VirtualNow_ns;
+	Clock.Sleep_us = VirtualSleep_us;
+	Clock.Context  = NULL;
+	RehaMove3::actionResult_t Result;
+	if (!Device->SetClock(&Clock) || !Device->InitialiseRehaMove3(InitSetup, &Result)){
+		printf("Error: The fake device could not be initialised!\n");
+		delete Device;
+		return NULL;
+	}
+	return Device;
+}
+
+static void CloseDevice(RehaMove3 *Device)
+{
+	Device->DeInitialiseDevice(false, false);
+	delete Device;
+}
+
+static void SetupMidLevel(RehaMove3::rmInitSettings_t *InitSetup)
+{
+	memset(InitSetup, 0, sizeof(RehaMove3::rmInitSettings_t));
+	InitSetup->StimConfig.rmProtocol 	   = REHAMOVE_MODE_MIDLEVEL;
+	InitSetup->StimConfig.StimFrequency   = 20;
+	InitSetup->StimConfig.ErrorAbortAfter  = 2;
+	InitSetup->StimConfig.ErrorRetestAfter = 20;
+	InitSetup->StimConfig.PulseWidthMax   = 500;
+	InitSetup->StimConfig.CurrentMax      = 50.0;
+	InitSetup->MidLevelConfig.GeneralStimFrequency = 20;
+	InitSetup->DebugConfig.disableVersionCheck = true;
+}
+
+static bool CheckCount(const char *Name, uint32_t Count, uint32_t Expected, uint32_t Tolerance)
+{
+	bool Passed = (Count + Tolerance >= Expected) && (Count <= Expected + Tolerance);
+	printf("%s %s: %u (expected: %u +-%u)\n", Passed ? "PASSED" : "FAILED", Name, Count, Expected, Tolerance);
+	return Passed;
+}
+
+static bool TestKeepAliveTimer(const char *InterfaceFile)
+{
+	// the keep alive threat sends one signal per period of the virtual time
+	RehaMove3::rmInitSettings_t InitSetup;
+	SetupMidLevel(&InitSetup);
+	InitSetup.MidLevelConfig.UseTimerForKeepAliveSignal = true;
+	InitSetup.MidLevelConfig.KeepAlivePeriod_ms = 100.0;
+	RehaMove3 *Device = OpenDevice(InterfaceFile, &InitSetup);
+	if (Device == NULL){
+		return false;
+	}
+	// the threat takes its first deadline, when it starts
+	usleep(20000);
+	FakeResetCounters();
+	AdvanceTime_ms(1000);
+	uint32_t KeepAliveSignals = FakeGetCounter(&FakeKeepAliveSignals);
+	CloseDevice(Device);
+	return CheckCount("keep alive timer (1000ms, period 100ms)", KeepAliveSignals, 10, 1);
+}
+
+static bool TestKeepAliveUpdateCalls(const char *InterfaceFile, bool UseUpdateMailbox)
+{
+	// one keep alive signal per KeepAliveNumberOfUpdateCalls +1 update calls -> the update threat sends at most every 10ms
+	RehaMove3::rmInitSettings_t InitSetup;
+	SetupMidLevel(&InitSetup);
+	InitSetup.MidLevelConfig.SendKeepAliveSignalDuringPeriodicMlUpdateCall = true;
+	InitSetup.MidLevelConfig.KeepAliveNumberOfUpdateCalls = 49;
+	InitSetup.MidLevelConfig.UseUpdateMailbox   = UseUpdateMailbox;
+	InitSetup.MidLevelConfig.UpdateMinPeriod_ms = 10.0;
+	RehaMove3 *Device = OpenDevice(InterfaceFile, &InitSetup);
+	if (Device == NULL){
+		return false;
+	}
+	RehaMove3::MlUpdateConfig_t UpdateConfig;
+	memset(&UpdateConfig, 0, sizeof(UpdateConfig));
+	UpdateConfig.ActiveChannels[0] = true;
+	UpdateConfig.PulseConfig[0].Channel    = 1;
+	UpdateConfig.PulseConfig[0].Shape      = Shape_Balanced_Symetric_Biphasic;
+	UpdateConfig.PulseConfig[0].PulseWidth = 200;
+	UpdateConfig.PulseConfig[0].Current    = 10.0;
+	UpdateConfig.PulseConfig[0].Frequency  = 20.0;
+
+	// 1000 update calls (1ms step) with the same config -> one update and the keep alive signals
+	FakeResetCounters();
+	for (uint32_t iStep = 0; iStep < 1000; iStep++){
+		RehaMove3::MlUpdateConfig_t StepConfig = UpdateConfig;
+		Device->SendMidLevelUpdate(&StepConfig);
+		AdvanceTime_ms(1);
+	}
+	AdvanceTime_ms(20);
+	uint32_t KeepAliveSignals = FakeGetCounter(&FakeKeepAliveSignals);
+	uint32_t Updates = FakeGetCounter(&FakeUpdates);
+	CloseDevice(Device);
+	bool Passed = CheckCount(UseUpdateMailbox ? "updates (update threat)" : "updates", Updates, 1, 0);
+	// the first signal follows 3 calls after the update, then every 50 calls
+	return CheckCount(UseUpdateMailbox ? "keep alive per update calls (update threat, 1000 calls)" : "keep alive per update calls (1000 calls)", KeepAliveSignals, 20, 1) && Passed;
+}
+
+int main(int argc, char *argv[]) {
+	(void)argc; (void)argv;
+	TestThread = pthread_self();
+
+	// the interface must exist and be read- and writeable -> a temporary file
+	char InterfaceFile[] = "/tmp/RehaMove3ClockTestXXXXXX";
+	int File = mkstemp(InterfaceFile);
+	if (File < 0){
+		printf("Error: The temporary interface file could not be created!\n");
+		return 1;
+	}
+	close(File);
+
+	bool Passed = true;
+	Passed &= TestKeepAliveTimer(InterfaceFile);
+	Passed &= TestKeepAliveUpdateCalls(InterfaceFile, false);
+	Passed &= TestKeepAliveUpdateCalls(InterfaceFile, true);
+
+	unlink(InterfaceFile);
+	printf("\n%s\n", Passed ? "All tests passed." : "Some tests FAILED!");
+	return Passed ? 0 : 1;
+}
@@ -73,6 +73,8 @@ int main(int argc, char *argv[]) {
 
 	RehaMove3::rmInitSettings_t InitSetup = {0};
 
+//	InitSetup.checkDeviceIDs = true;			// with the devicename "" the device is searched by its serial number
+//	snprintf(InitSetup.RequestedDeviceID, sizeof(InitSetup.RequestedDeviceID), "123456789");
 	InitSetup.StimConfig.rmProtocol = 1;
 	// LowLevel
 	InitSetup.StimConfig.StimFrequency = 20;
@@ -82,6 +84,13 @@ int main(int argc, char *argv[]) {
 	InitSetup.StimConfig.CurrentMax    = 50.0;
 	InitSetup.StimConfig.UseThreadForInit = false;
 	InitSetup.StimConfig.UseThreadForAcks = true;
+	InitSetup.StimConfig.StatusPollPeriod_ms = 1000.0;
+//	InitSetup.StimConfig.ThreadSchedPolicy = SCHED_FIFO;	// needs root or CAP_SYS_NICE
+//	InitSetup.StimConfig.ThreadSchedPriority = 80;
+//	InitSetup.StimConfig.ThreadCpuAffinity = 0x2;		// CPU 1
+//	InitSetup.StimConfig.LockMemory = true;
+//	snprintf(InitSetup.StimConfig.DeviceCacheFile, sizeof(InitSetup.StimConfig.DeviceCacheFile), "rehamove3_devices.txt"); // known devices are checked after the init
+//	InitSetup.StimConfig.AutoReconnect = true;		// open and initialise the device again after a disconnect
 	InitSetup.LowLevelConfig.HighVoltageLevel = Smpt_High_Voltage_60V;
 	InitSetup.LowLevelConfig.UseDenervation = false;
 	// Debug
@@ -97,6 +106,12 @@ int main(int argc, char *argv[]) {
 //	InitSetup.DebugConfig.printStimInfos = true;
 	InitSetup.DebugConfig.disableVersionCheck = true;
 	InitSetup.DebugConfig.useColors = true;
+//	snprintf(InitSetup.DebugConfig.StatsExportFile, sizeof(InitSetup.DebugConfig.StatsExportFile), "/var/lib/node_exporter/textfile_collector/rehamove3.prom");
+//	InitSetup.DebugConfig.StatsExportPeriod_ms = 5000.0;
+//	snprintf(InitSetup.DebugConfig.TelemetrySegmentName, sizeof(InitSetup.DebugConfig.TelemetrySegmentName), "rehamove3_standalone");
+//	InitSetup.DebugConfig.TelemetryPeriod_ms = 10.0;
+//	snprintf(InitSetup.DebugConfig.TraceFile, sizeof(InitSetup.DebugConfig.TraceFile), "rehamove3_trace.bin"); // needs -DREHAMOVE_ENABLE_TRACE
+//	snprintf(InitSetup.DebugConfig.BinaryLogFile, sizeof(InitSetup.DebugConfig.BinaryLogFile), "rehamove3_log.bin"); // decode with RehaMove3LogDecoder
 
 	RehaMove3::LlSequenceConfig_t SC = {};
 	SC.NumberOfPulses = 1;
@@ -0,0 +1,73 @@
+/*
+ * RehaMove3LogDecoder.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: agent
+ *
+ *  Converts a binary log written by the RehaMove3 interface class (DebugConfig.BinaryLogFile) into text.
+ *  The messages are the same as printed with printStimInfos, printReceivedAckInfos and printSendCmdInfos.
+ *
+ *  Build: g++ -I../src RehaMove3LogDecoder.cpp -o RehaMove3LogDecoder
+ *  Usage: RehaMove3LogDecoder <log file> [text file]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <RehaMove3BinaryLog.hpp>
+
+int main(int argc, char *argv[]) {
+	if (argc < 2){
+		printf("Usage: %s <log file> [text file]\n", argv[0]);
+		return 1;
+	}
+
+	FILE *In = fopen(argv[1], "rb");
+	if (In == NULL){
+		printf("Error: The log file %s could not be opened!\n", argv[1]);
+		return 1;
+	}
+	rmBinLogFileHeader_t FileHeader;
+	if ((fread(&FileHeader, sizeof(FileHeader), 1, In) != 1) || (FileHeader.Magic != REHAMOVE_BINLOG_MAGIC) ||
+		(FileHeader.Version != REHAMOVE_BINLOG_VERSION) || (FileHeader.RecordSize != sizeof(rmBinLogRecord_t))){
+		printf("Error: The file %s is not a RehaMove3 binary log (version %u)!\n", argv[1], REHAMOVE_BINLOG_VERSION);
+		fclose(In);
+		return 1;
+	}
+	FileHeader.DeviceID[sizeof(FileHeader.DeviceID) -1] = 0;
+	if (FileHeader.NumberOfMessages > rmLog_NumberOfMessages){
+		printf("Warning: The log was written with %u message types, but only %u are known.\n", FileHeader.NumberOfMessages, rmLog_NumberOfMessages);
+	}
+
+	FILE *Out = stdout;
+	if (argc > 2){
+		Out = fopen(argv[2], "w");
+		if (Out == NULL){
+			printf("Error: The text file %s could not be opened!\n", argv[2]);
+			fclose(In);
+			return 1;
+		}
+	}
+
+	/*
+	 * Every message is prefixed with the time since the log was opened in s
+	 */
+	rmBinLogRecord_t Record;
+	char Text[1024];
+	uint64_t NumberOfRecords = 0;
+	while (fread(&Record, sizeof(Record), 1, In) == 1){
+		uint8_t NumberOfArgs = (Record.NumberOfArgs > REHAMOVE_BINLOG_MAX_ARGS) ? REHAMOVE_BINLOG_MAX_ARGS : Record.NumberOfArgs;
+		rmLogFormat(Text, sizeof(Text), Record.MessageID, FileHeader.DeviceID, Record.Args, NumberOfArgs);
+		double Time_s = ((double)((int64_t)(Record.Time_ns - FileHeader.StartTime_ns))) /1e9;
+		fprintf(Out, "[%12.6f] %s", Time_s, Text);
+		NumberOfRecords++;
+	}
+	fclose(In);
+
+	if (Out != stdout){
+		fclose(Out);
+		printf("%lu messages were written to %s.\n", (unsigned long)NumberOfRecords, argv[2]);
+	}
+	return 0;
+}
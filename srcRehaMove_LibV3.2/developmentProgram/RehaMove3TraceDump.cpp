@@ -0,0 +1,86 @@
+/*
+ * RehaMove3TraceDump.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: agent
+ *
+ *  Converts a trace file written by rmTraceDump() (RehaMove3 interface class compiled with REHAMOVE_ENABLE_TRACE)
+ *  into the Chrome trace format (JSON), which can be opened with chrome://tracing or https://ui.perfetto.dev
+ *
+ *  Build: g++ -I../src RehaMove3TraceDump.cpp -o RehaMove3TraceDump
+ *  Usage: RehaMove3TraceDump <trace file> <json file>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <RehaMove3Trace.hpp>
+
+int main(int argc, char *argv[]) {
+	if (argc < 3){
+		printf("Usage: %s <trace file> <json file>\n", argv[0]);
+		return 1;
+	}
+
+	FILE *In = fopen(argv[1], "rb");
+	if (In == NULL){
+		printf("Error: The trace file %s could not be opened!\n", argv[1]);
+		return 1;
+	}
+	rmTraceFileHeader_t FileHeader;
+	if ((fread(&FileHeader, sizeof(FileHeader), 1, In) != 1) || (FileHeader.Magic != REHAMOVE_TRACE_MAGIC) ||
+		(FileHeader.Version != REHAMOVE_TRACE_VERSION) || (FileHeader.EventSize != sizeof(rmTraceEvent_t))){
+		printf("Error: The file %s is not a RehaMove3 trace file (version %u)!\n", argv[1], REHAMOVE_TRACE_VERSION);
+		fclose(In);
+		return 1;
+	}
+
+	FILE *Out = fopen(argv[2], "w");
+	if (Out == NULL){
+		printf("Error: The json file %s could not be opened!\n", argv[2]);
+		fclose(In);
+		return 1;
+	}
+
+	/*
+	 * The time stamps are written relative to the first event of the first thread in us
+	 */
+	uint64_t StartTime_ns = 0;
+	bool FirstEvent = true;
+	uint64_t NumberOfEvents = 0;
+	fprintf(Out, "{\"traceEvents\":[\n");
+	for (uint32_t iThread = 0; iThread < FileHeader.NumberOfThreads; iThread++){
+		rmTraceThreadHeader_t ThreadHeader;
+		if (fread(&ThreadHeader, sizeof(ThreadHeader), 1, In) != 1){
+			printf("Error: The trace file %s is truncated!\n", argv[1]);
+			break;
+		}
+		if (ThreadHeader.EventsOverwritten > 0){
+			printf("Thread %u: %lu events were overwritten.\n", ThreadHeader.ThreadID, (unsigned long)ThreadHeader.EventsOverwritten);
+		}
+		rmTraceEvent_t Event;
+		for (uint32_t iEvent = 0; iEvent < ThreadHeader.NumberOfEvents; iEvent++){
+			if (fread(&Event, sizeof(Event), 1, In) != 1){
+				printf("Error: The trace file %s is truncated!\n", argv[1]);
+				break;
+			}
+			if (FirstEvent){
+				StartTime_ns = Event.Time_ns;
+			}
+			const char *Name = (Event.EventID < rmTrace_NumberOfEvents) ? rmTraceEventNames[Event.EventID] : "Unknown";
+			// time stamps before the first event are possible, since the threads are written one after another
+			double Time_us = ((double)((int64_t)(Event.Time_ns - StartTime_ns))) /1000.0;
+			fprintf(Out, "%s{\"name\":\"%s\",\"cat\":\"RehaMove3\",\"ph\":\"%c\",\"ts\":%0.3f,\"pid\":1,\"tid\":%u%s,\"args\":{\"arg\":%u}}",
+					FirstEvent ? "" : ",\n", Name, Event.Phase, Time_us, ThreadHeader.ThreadID, (Event.Phase == rmTracePhase_Instant) ? ",\"s\":\"t\"" : "", Event.Arg);
+			FirstEvent = false;
+			NumberOfEvents++;
+		}
+	}
+	fprintf(Out, "\n],\"displayTimeUnit\":\"ns\"}\n");
+	fclose(Out);
+	fclose(In);
+
+	printf("%lu events of %u threads were written to %s.\n", (unsigned long)NumberOfEvents, FileHeader.NumberOfThreads, argv[2]);
+	return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ *      TU Berlin --- Fachgebiet Regelungssystem
+ *      C++ Interface class for the Hasomed GmbH device RehaMove3
+ *
+ *      Author: agent
+ *      Copyright © 2026 agent <agent@local>. All rights reserved.
+ *
+ *      File:           RehaMove3BinaryLog.hpp -> Messages and file layout of the binary log.
+ *      Version:        01 (2026)
+ *      Changelog:
+ *      	- 10.2026: initial release
+ *
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ *      NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef REHAMOVE3BINARYLOG_H
+#define REHAMOVE3BINARYLOG_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * The pulse, ack and send command messages are only stored as message ID + argument values, if
+ * DebugConfig.BinaryLogFile is set; the text is created offline by developmentProgram/RehaMove3LogDecoder.cpp
+ *
+ * -> the arguments are stored as double; the conversion of the format string decides how they are printed
+ * -> '%s' is always the device ID (stored once in the file header)
+ * -> new messages are appended, the IDs of the existing messages never change
+ */
+#define REHAMOVE_BINLOG_MAGIC								0x4C334D52	// "RM3L"
+#define REHAMOVE_BINLOG_VERSION								1
+#define REHAMOVE_BINLOG_MAX_ARGS							6
+#define REHAMOVE_BINLOG_ID_SIZE								128		// >= size of RehaMove3::DeviceIDClass
+
+enum rmLogMessageID_t {
+	rmLog_LlPulse 			= 0,	// pulse, channel, shape, pulse width, current
+	rmLog_LlPulseChannel 	= 1,	// pulse, channel
+	rmLog_PointConfig 		= 2,	// point, duration, current, mode, interpolation mode
+	rmLog_MlChannel 		= 3,	// channel, frequency, shape, pulse width, current, ramp
+	rmLog_HybridOffload 	= 4,	// time
+	rmLog_HybridFallback 	= 5,	// time
+	rmLog_ResponseReceived 	= 6,	// command, result, packet number
+	rmLog_CommandSend 		= 7,	// expected command
+	rmLog_CommandDuration 	= 8,	// command, duration
+	rmLog_NumberOfMessages
+};
+
+static const char* const rmLogMessageFormats[rmLog_NumberOfMessages] = {
+	"  Pulse %u -> Channel=%u; Shape=%u; PW=%u; I=%0.1f\n",
+	"  Pulse %u -> Channel=%u\n",
+	"     PointConfig% 3d: Duration=% 4iµs; Current=% +7.2fmA; (Mode=%i; IM=%i)\n",
+	"  Channel=%u; -> Frequency=%4.2fHz; Shape=%u; PW=%u; I=%0.1f; Ramp=%u\n",
+	"%s DEBUG: The LowLevel sequence is executed by the device now (time: %0.3f)\n",
+	"%s DEBUG: The LowLevel sequence is send by the host again (time: %0.3f)\n",
+	"%s DEBUG: Response received\n   -> Ack: %i; Result: %i; Package Number: %i\n",
+	"%s DEBUG: Command send for ACK %u\n",
+	"   -> ACK %u needed %f ms to finish\n"
+};
+
+// log file: rmBinLogFileHeader_t, followed by rmBinLogRecord_t until the end of the file
+struct rmBinLogFileHeader_t {
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t RecordSize;
+	uint32_t NumberOfMessages;
+	uint64_t StartTime_ns;			// CLOCK_MONOTONIC
+	char	 DeviceID[REHAMOVE_BINLOG_ID_SIZE];
+};
+struct rmBinLogRecord_t {
+	uint64_t Time_ns;				// CLOCK_MONOTONIC
+	uint16_t MessageID;
+	uint8_t	 NumberOfArgs;
+	uint8_t	 Reserved0;
+	uint32_t Reserved1;
+	double	 Args[REHAMOVE_BINLOG_MAX_ARGS];
+};
+
+/*
+ * Create the text of a message -> used by the interface class (text mode) and the decoder
+ * -> returns the length of the text like snprintf
+ */
+static inline int rmLogFormat(char *Text, size_t Size, uint16_t MessageID, const char *DeviceID, const double *Args, uint8_t NumberOfArgs)
+{
+	if ((Text == NULL) || (Size == 0)){
+		return 0;
+	}
+	if (MessageID >= rmLog_NumberOfMessages){
+		return snprintf(Text, Size, "Unknown message %u\n", MessageID);
+	}
+	const char *Format = rmLogMessageFormats[MessageID];
+	size_t Length = 0;
+	uint8_t iArg = 0;
+	char Spec[32];
+	Text[0] = 0;
+	while (*Format != 0){
+		if ((*Format != '%') || (Format[1] == '%')){
+			if (Length +1 < Size){
+				Text[Length] = *Format;
+				Text[Length +1] = 0;
+			}
+			Length++;
+			Format += (*Format == '%') ? 2 : 1;
+			continue;
+		}
+		// conversion -> copy the flags, width and precision; the length modifiers are not used
+		uint8_t iSpec = 0;
+		Spec[iSpec++] = *Format++;
+		while ((*Format != 0) && (strchr("diufFeEgGxXcs", *Format) == NULL) && (iSpec < sizeof(Spec) -3)){
+			if ((*Format != 'l') && (*Format != 'h')){
+				Spec[iSpec++] = *Format;
+			}
+			Format++;
+		}
+		char Conversion = *Format;
+		if (Conversion == 0){
+			break;
+		}
+		Spec[iSpec++] = Conversion;
+		Spec[iSpec] = 0;
+		Format++;
+		int Written = 0;
+		size_t Free = (Length < Size) ? (Size - Length) : 0;
+		char *Position = (Length < Size) ? &Text[Length] : NULL;
+		char Dummy[1];
+		if (Position == NULL){
+			Position = Dummy;
+			Free = 1;
+		}
+		if (Conversion == 's'){
+			Written = snprintf(Position, Free, Spec, (DeviceID != NULL) ? DeviceID : "");
+		} else {
+			double Value = (iArg < NumberOfArgs) ? Args[iArg] : 0.0;
+			iArg++;
+			switch (Conversion){
+			case 'd':
+			case 'i':
+			case 'c':
+				Written = snprintf(Position, Free, Spec, (int)Value);
+				break;
+			case 'u':
+			case 'x':
+			case 'X':
+				Written = snprintf(Position, Free, Spec, (unsigned int)Value);
+				break;
+			default:
+				Written = snprintf(Position, Free, Spec, Value);
+			}
+		}
+		Length += (Written > 0) ? (size_t)Written : 0;
+	}
+	return (int)Length;
+}
+
+#endif /* REHAMOVE3BINARYLOG_H */
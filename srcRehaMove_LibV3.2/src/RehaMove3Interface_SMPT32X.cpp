@@ -21,6 +21,7 @@
 
 
 #include <RehaMove3Interface_SMPT32X.hpp>
+#include <RehaMove3Manager.hpp>
 
 
 namespace nsRehaMove3_SMPT_32X_01 {
@@ -36,6 +37,29 @@ void PrintLibError(const char* format) {
 }
 }
 
+/*
+ * Default clock of the interface class
+ */
+static uint64_t DefaultClockNow_ns(void *Context)
+{
+	(void)Context;
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	return ((uint64_t)Time.tv_sec *1000000000) + (uint64_t)Time.tv_nsec;
+}
+
+static void DefaultClockSleep_us(void *Context, uint32_t Duration_us)
+{
+	(void)Context;
+	usleep(Duration_us);
+}
+
+/*
+ * Process wide lock of the device discovery -> the probes of two instances must not open the same interface at the same time
+ * -> held by OpenSerial() as well, while the file descriptor of the opened interface is looked up; no probe can have it open meanwhile
+ */
+static pthread_mutex_t DiscoveryLock_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 // #####
 // Todo: prüfen, ob der Pointer auf das result  beim abbrechen immer 0 ist !
 
@@ -61,12 +85,78 @@ void *ReceiverThreadFunc(void *data)
     pthread_exit(NULL);
 }
 
+void *KeepAliveThreadFunc(void *data)
+{
+	RehaMove3 *Device = (RehaMove3 *) data;
+	Device->RunMidLevelKeepAliveTimer();
+	pthread_exit(NULL);
+}
+
+void *MlUpdateThreadFunc(void *data)
+{
+	RehaMove3 *Device = (RehaMove3 *) data;
+	Device->RunMidLevelUpdateSender();
+	pthread_exit(NULL);
+}
+
+void *StatusPollThreadFunc(void *data)
+{
+	RehaMove3 *Device = (RehaMove3 *) data;
+	Device->RunStatusPoller();
+	pthread_exit(NULL);
+}
+
+void *StatsExportThreadFunc(void *data)
+{
+	RehaMove3 *Device = (RehaMove3 *) data;
+	Device->RunStatisticsExporter();
+	pthread_exit(NULL);
+}
+
+void *TelemetryThreadFunc(void *data)
+{
+	RehaMove3 *Device = (RehaMove3 *) data;
+	Device->RunTelemetryPublisher();
+	pthread_exit(NULL);
+}
+
+void *LoggerThreadFunc(void *data)
+{
+	RehaMove3 *Device = (RehaMove3 *) data;
+	Device->RunLogger();
+	pthread_exit(NULL);
+}
+
+void *DeviceCheckThreadFunc(void *data)
+{
+	RehaMove3 *Device = (RehaMove3 *) data;
+	Device->RunDeviceCheck();
+	pthread_exit(NULL);
+}
+
+void *ReconnectThreadFunc(void *data)
+{
+	RehaMove3 *Device = (RehaMove3 *) data;
+	Device->RunReconnectWatchdog();
+	pthread_exit(NULL);
+}
+
+void *DiscoveryThreadFunc(void *data)
+{
+	RehaMove3::rmDiscoveryProbe_t *Probe = (RehaMove3::rmDiscoveryProbe_t *) data;
+	Probe->Device->RunDiscoveryProbe(Probe);
+	pthread_exit(NULL);
+}
+
 RehaMove3::RehaMove3(const char *DeviceID, const char *SerialDeviceFile)
 {
 	/*
 	 * Initialise the private variables
 	 */
 	this->ClassInstanceInitialised = false;
+	this->Clock.Now_ns 	 = DefaultClockNow_ns;
+	this->Clock.Sleep_us = DefaultClockSleep_us;
+	this->Clock.Context  = NULL;
 	// Device specific initialisations
 	memset(&(this->Device),  0, sizeof(this->Device));
 	memset(  this->DeviceIDClass, 0, sizeof(this->DeviceIDClass));
@@ -80,7 +170,11 @@ RehaMove3::RehaMove3(const char *DeviceID, const char *SerialDeviceFile)
 		// the device filename could not be set up correctly, so opening the device will probably fail anyway -> return
 		return;
 	}
+	memset(  this->DeviceLinkName, 0, sizeof(this->DeviceLinkName));
+	this->InterfaceLockFile = -1;
+	this->Manager = NULL;
 	memset(&this->rmStatus, 0, sizeof(rmStatus_t));
+	this->rmStatus.InitPhase = rmInitPhase_NumberOfPhases;
 
 	// Setup specific initialisations
 	memset(&(this->rmSettings), 0, sizeof(this->rmSettings));
@@ -94,11 +188,37 @@ RehaMove3::RehaMove3(const char *DeviceID, const char *SerialDeviceFile)
 
 	this->InitThread = 0;
 	this->ReceiverThread = 0;
+	this->KeepAliveThread = 0;
+	this->MlUpdateThread = 0;
+	this->StatusPollThread = 0;
+	this->StatsExportThread = 0;
+	this->TelemetryThread = 0;
+	this->TelemetrySegment = NULL;
+	this->TelemetryFile = -1;
+	this->LoggerThread = 0;
+	this->DeviceCheckThread = 0;
+	this->ReconnectThread = 0;
+	memset(&(this->DeviceCacheEntry), 0, sizeof(this->DeviceCacheEntry));
 	pthread_mutex_init(&this->ReadPackage_mutex, NULL);
+	pthread_mutex_init(&this->SendPackage_mutex, NULL);
 	pthread_mutex_init(&this->AcksLock_mutex, NULL);
 	pthread_mutex_init(&this->ResponseQueueLock_mutex, NULL);
 	pthread_mutex_init(&this->LlSequenceQueueLock_mutex, NULL);
 
+	// Log specific initialisations -> the messages are printed directly, if the logger threat could not be started
+	memset(&(this->LogQueue), 0, sizeof(this->LogQueue));
+	for (uint64_t i=0; i<REHAMOVE_LOG_QUEUE_SIZE; i++){
+		this->LogQueue.Queue[i].Sequence.Store(i);
+	}
+	sem_init(&this->LogQueue.NewMessages, 0, 0);
+	memset(&(this->BinaryLog), 0, sizeof(this->BinaryLog));
+	for (uint64_t i=0; i<REHAMOVE_BINLOG_QUEUE_SIZE; i++){
+		this->BinaryLog.Queue[i].Sequence.Store(i);
+	}
+	this->BinaryLog.File = NULL;
+	pthread_mutex_init(&this->BinaryLog.File_mutex, NULL);
+	RehaMove3::StartLogger();
+
 	// the initialisation of the class instance is done
 	this->ClassInstanceInitialised = true;
 
@@ -109,17 +229,30 @@ RehaMove3::RehaMove3(const char *DeviceID, const char *SerialDeviceFile)
 }
 
 RehaMove3::~RehaMove3(void) {
-	if (this->rmStatus.DeviceIsOpen) {
-		while(this->rmStatus.InitThreatRunning){
-			this->rmStatus.InitThreatActive  = false;
+	RehaMove3::StopReconnectWatchdog();
+	if (this->rmStatus.DeviceIsOpen.Load()) {
+		while(this->rmStatus.InitThreatRunning.Load()){
+			this->rmStatus.InitThreatActive.Store(false);
 			usleep(100000); // 100ms
 		}
 		RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: Closing serial interface\n");
 		RehaMove3::CloseSerial();
 	}
+	if (this->Manager != NULL){
+		this->Manager->RemoveDevice(this);
+	}
+	// print the remaining messages
+	RehaMove3::CloseBinaryLog();
+	RehaMove3::StopLogger();
+	sem_destroy(&this->LogQueue.NewMessages);
+	pthread_mutex_destroy(&this->BinaryLog.File_mutex);
+	if (this->rmStatus.MemoryLocked){
+		munlock(this, sizeof(RehaMove3));
+	}
 
 	pthread_mutex_unlock(&this->ReadPackage_mutex);
 	pthread_mutex_destroy(&this->ReadPackage_mutex);
+	pthread_mutex_destroy(&this->SendPackage_mutex);
 	pthread_mutex_destroy(&this->AcksLock_mutex);
 	pthread_mutex_destroy(&this->ResponseQueueLock_mutex);
 	pthread_mutex_destroy(&this->LlSequenceQueueLock_mutex);
@@ -127,7 +260,32 @@ RehaMove3::~RehaMove3(void) {
 
 bool RehaMove3::IsDeviceInitialised(actionResult_t *InitResult) {
 	memcpy(InitResult, &this->rmInitResult, sizeof(this->rmInitResult));
-	return this->rmStatus.DeviceInitialised;
+	return this->rmStatus.DeviceInitialised.Load();
+}
+
+bool RehaMove3::IsReconnecting(void) {
+	return this->rmStatus.Reconnecting.Load();
+}
+
+bool RehaMove3::SetManager(RehaMove3Manager *NewManager)
+{
+	// the receiver can not be changed while the interface is open
+	if ((NewManager != NULL) && this->rmStatus.DeviceIsOpen.Load()){
+		RehaMove3::printMessage(printMSG_error, "%s Error: The device can only be added to a manager before the initialisation!\n", this->DeviceIDClass);
+		return false;
+	}
+	this->Manager = NewManager;
+	return true;
+}
+
+bool RehaMove3::GetInitTiming(rmInitTiming_t *InitTiming)
+{
+	// the values are written by the initialisation threat -> only valid after it has finished
+	if ((InitTiming == NULL) || this->rmStatus.InitThreatRunning.Load()){
+		return false;
+	}
+	memcpy(InitTiming, &this->rmStatus.InitTiming, sizeof(rmInitTiming_t));
+	return true;
 }
 
 
@@ -145,7 +303,7 @@ bool RehaMove3::InitialiseRehaMove3(rmInitSettings_t *InitSetup, actionResult_t
 		return false;
 	}
 	// Check that the thread is not already running
-	if (this->rmStatus.InitThreatRunning) {
+	if (this->rmStatus.InitThreatRunning.Load()) {
 		// thread is running
 		RehaMove3::printMessage(printMSG_error, "%s Error: The initialisation thread is already running!\n", this->DeviceIDClass);
 		return false;
@@ -173,6 +331,25 @@ bool RehaMove3::InitialiseRehaMove3(rmInitSettings_t *InitSetup, actionResult_t
 
 	// Save the init struct
 	memcpy(&(this->rmInitSettings), InitSetup, sizeof(this->rmInitSettings));
+	if (this->rmInitSettings.StimConfig.LockMemory){
+		/*
+		 * lock the buffers of the library -> the response, sequence, log and binary log queues are part of the object; the trace rings
+		 * -> the pages of the host process (e.g. Simulink) are not locked; use mlockall() in the host or the real time settings of the
+		 *    target, if the whole process should be locked
+		 */
+		if (!this->rmStatus.MemoryLocked){
+			if (mlock(this, sizeof(RehaMove3)) != 0){
+				RehaMove3::printMessage(printMSG_warning, "%s Warning: The memory could not be locked:\n     -> %s (%d)\n", this->DeviceIDClass, strerror(errno), errno);
+			} else {
+				this->rmStatus.MemoryLocked = true;
+			}
+		}
+		RM3_TRACE_LOCK_MEMORY();
+		RehaMove3::PrefaultStack();
+	}
+	if (this->rmInitSettings.DebugConfig.BinaryLogFile[0] != 0){
+		RehaMove3::OpenBinaryLog(this->rmInitSettings.DebugConfig.BinaryLogFile);
+	}
 
 	// update the settings
 	this->rmSettings.StimFrequency 	 = InitSetup->StimConfig.StimFrequency;
@@ -181,27 +358,32 @@ bool RehaMove3::InitialiseRehaMove3(rmInitSettings_t *InitSetup, actionResult_t
 	this->rmSettings.MaxPulseWidth 	 = InitSetup->StimConfig.PulseWidthMax;
 	this->rmSettings.MaxCurrent     	 = fabsf(InitSetup->StimConfig.CurrentMax);
 	this->rmSettings.UseThreadForInit   = InitSetup->StimConfig.UseThreadForInit;
-	this->rmSettings.UseThreadForAcks   = InitSetup->StimConfig.UseThreadForAcks;
+	// the receiver threat of the manager reads the acknowledgements like an own receiver threat
+	this->rmSettings.UseThreadForAcks   = InitSetup->StimConfig.UseThreadForAcks || (this->Manager != NULL);
+	this->rmSettings.MidLevel.KeepAlivePeriod_ms = InitSetup->MidLevelConfig.KeepAlivePeriod_ms;
 
-	// save the current time as offset
+	// save the current time as offset; the wall clock is only used to report the start of the session
 	struct timeval time;
 	gettimeofday(&time,NULL);
-	this->rmStatus.StartTime_ms = (uint64_t)(time.tv_sec*1000.0) + (uint64_t)(time.tv_usec/1000.0);
+	this->rmStatus.StartWallTime_us = ((uint64_t)time.tv_sec *1000000) + (uint64_t)time.tv_usec;
+	this->rmStatus.StartTime_ns = RehaMove3::GetTimeStamp_ns();
+	this->rmStatus.CurrentTime_ns.Store(0);
 
 	// use a thread for the initialisation?
 	bool returnValue = false;
 	this->rmInitResultExtern = InitResult;
 	if (this->rmSettings.UseThreadForInit){
-		this->rmStatus.InitThreatActive = true;
-		if (pthread_create(&(this->InitThread), NULL, InitialisationThreadFunc, (void *)this) != 0) {
-			RehaMove3::printMessage(printMSG_error, "%s Error: The initialisation threat could not be started:\n     -> %s (%d)\n", this->DeviceIDClass, strerror(errno), errno);
+		this->rmStatus.InitThreatActive.Store(true);
+		int ThreadReturnValue = RehaMove3::CreateRealTimeThread(&(this->InitThread), InitialisationThreadFunc, "initialisation");
+		if (ThreadReturnValue != 0) {
+			RehaMove3::printMessage(printMSG_error, "%s Error: The initialisation threat could not be started:\n     -> %s (%d)\n", this->DeviceIDClass, strerror(ThreadReturnValue), ThreadReturnValue);
 			returnValue = RehaMove3::InitialiseDevice();
 			memcpy(InitResult, &this->rmInitResult, sizeof(this->rmInitResult));
 			return returnValue;
 		}
 		RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: Starting the initialisation threat was successfully.\n");
 	} else {
-		this->rmStatus.InitThreatActive = true;
+		this->rmStatus.InitThreatActive.Store(true);
 		returnValue = RehaMove3::InitialiseDevice();
 		memcpy(InitResult, &this->rmInitResult, sizeof(this->rmInitResult));
 		return returnValue;
@@ -211,10 +393,26 @@ bool RehaMove3::InitialiseRehaMove3(rmInitSettings_t *InitSetup, actionResult_t
 
 bool RehaMove3::InitialiseDevice(void)
 {
-	if (!this->rmStatus.InitThreatActive){
+	if (!this->rmStatus.InitThreatActive.Load()){
 		return false;
 	}
-	this->rmStatus.InitThreatRunning = true;
+	this->rmStatus.InitThreatRunning.Store(true);
+	memset(&this->rmStatus.InitTiming, 0, sizeof(rmInitTiming_t));
+	this->rmStatus.InitStart_ns = RehaMove3::GetTimeStamp_ns();
+	this->rmStatus.InitPhase = rmInitPhase_NumberOfPhases;
+	RehaMove3::SetInitPhase(rmInitPhase_Open);
+	/*
+	 * no interface given -> search the device by its serial number
+	 */
+	if ((this->DeviceFileName[0] == 0) && this->rmInitSettings.checkDeviceIDs){
+		if (!RehaMove3::DiscoverDevice(this->rmInitSettings.RequestedDeviceID, REHAMOVE_DISCOVERY_TIMEOUT_MS)){
+			this->rmInitResult.errorCode = actionError_openingDevice;
+			snprintf(this->rmInitResult.errorMessage, sizeof(this->rmInitResult.errorMessage), "The device with the serial number '%s' was not found!\n", this->rmInitSettings.RequestedDeviceID);
+			RehaMove3::printMessage(printMSG_error, "%s Error: The device with the serial number '%s' was not found!\n     -> Please check that the device is connected and switched on!\n", this->DeviceIDClass, this->rmInitSettings.RequestedDeviceID);
+			RehaMove3::AbortDeviceInitialisation();
+			return false;
+		}
+	}
 	/*
 	 * open the device and start the receiver threat
 	 */
@@ -223,15 +421,21 @@ bool RehaMove3::InitialiseDevice(void)
 		RehaMove3::AbortDeviceInitialisation();
 		return false;
 	}
+	// the link of the interface is needed to find the device again after a disconnect
+	if (this->rmInitSettings.StimConfig.AutoReconnect && !this->rmStatus.Reconnecting.Load()){
+		RehaMove3::FindSerialLink();
+	}
 
 	/*
 	 * Reset the device
+	 * -> the device is probed first; a running device is stopped and initialised again without a reset
 	 */
 	bool DoDeviceReset = false;
 	uint8_t ResetCounter = 0;
 	do {
 		if (DoDeviceReset){
 			// reset the device only when needed because the reset takes about 10-15 seconds
+			RehaMove3::SetInitPhase(rmInitPhase_Reset);
 			if (ResetCounter >= REHAMOVE_MAX_RESETS_INIT){
 				RehaMove3::printMessage(printMSG_error, "%s Error: The device was reseted %d times but the initialisation still does fail!\n     -> Initialisation aborted!\n", this->DeviceIDClass, (int)ResetCounter);
 				RehaMove3::AbortDeviceInitialisation();
@@ -239,7 +443,10 @@ bool RehaMove3::InitialiseDevice(void)
 			} else {
 				RehaMove3::printMessage(printMSG_warning, "\n%s: Executing a device reset ... ", this->DeviceIDClass);
 				fflush(stdout);
-				if (smpt_send_reset(&(this->Device), RehaMove3::GetPackageNumber())) {
+				pthread_mutex_lock(&(this->SendPackage_mutex));
+				bool ResetSend = smpt_send_reset(&(this->Device), RehaMove3::GetPackageNumber());
+				pthread_mutex_unlock(&(this->SendPackage_mutex));
+				if (ResetSend) {
 					int ret;
 					for (uint8_t i = 0; i<15; i++){
 						if ((ret = RehaMove3::GetResponse(Smpt_Cmd_Reset_Ack, true, 1000)) == Smpt_Cmd_Reset_Ack) {
@@ -247,7 +454,7 @@ bool RehaMove3::InitialiseDevice(void)
 							break;
 						}
 						// check if the initialise thread should still be running
-						if (!this->rmStatus.InitThreatActive){
+						if (!this->rmStatus.InitThreatActive.Load()){
 							RehaMove3::AbortDeviceInitialisation();
 							return false;
 						}
@@ -262,170 +469,214 @@ bool RehaMove3::InitialiseDevice(void)
 				}
 				DoDeviceReset = false;
 				ResetCounter++;
+				this->rmStatus.InitTiming.NumberOfResets = ResetCounter;
 			}
 		}
 
 		// check if the initialise thread should still be running
-		if (!this->rmStatus.InitThreatActive){
+		if (!this->rmStatus.InitThreatActive.Load()){
 			RehaMove3::AbortDeviceInitialisation();
 			return false;
 		}
 
 		/*
-		 * General commands
+		 * General commands -> probe the device
+		 * -> the queries are independent, so they are send back-to-back and the acknowledgements are collected with one deadline
 		 */
-		// get the device id
-		if (smpt_send_get_device_id(&(this->Device), RehaMove3::GetPackageNumber())) {
-			if (RehaMove3::GetResponse(Smpt_Cmd_Get_Device_Id_Ack, true, 200) != Smpt_Cmd_Get_Device_Id_Ack) {
-				// error
-				RehaMove3::printMessage(printMSG_error, "%s Error: The device ID could not be read!\n", this->DeviceIDClass);
-				DoDeviceReset = true;
-				continue;
-			} else {
-				// response received -> check the ID
-				memcpy(this->rmStatus.Device.DeviceID, this->Acks.G_device_id_ack.device_id, (size_t)Smpt_Length_Device_Id);
-				this->rmStatus.Device.DeviceID[Smpt_Length_Device_Id] = 0x00;
-				if (this->rmInitSettings.checkDeviceIDs){
-					// check if the device IDs match
-					if (strcmp(this->rmInitSettings.RequestedDeviceID, this->rmStatus.Device.DeviceID) != 0){
-						// IDs do not match
-						this->rmInitResult.successful = false;
-						this->rmInitResult.errorCode = actionError_checkDeviceIDs;
-						sprintf(this->rmInitResult.errorMessage, "The serial numbers do not match\n.     -> Requested SN: '%s';  Found SN: '%s'!\n", this->rmInitSettings.RequestedDeviceID, this->rmStatus.Device.DeviceID);
-						RehaMove3::printMessage(printMSG_error, "%s Error: The serial numbers do not match\n   -> Requested SN: '%s';  Found SN: '%s'!\n", this->DeviceIDClass, this->rmInitSettings.RequestedDeviceID, this->rmStatus.Device.DeviceID);
-						RehaMove3::AbortDeviceInitialisation();
-						return false;
-					}
+		RehaMove3::SetInitPhase(rmInitPhase_Probe);
+		// a known device -> the versions are taken from the device cache and checked after the initialisation
+		// -> the device ID is always read, so a different device on the same interface is never stimulated
+		this->rmStatus.DeviceCacheUsed = false;
+		if ((this->rmInitSettings.StimConfig.DeviceCacheFile[0] != 0) && (ResetCounter == 0)){
+			if (RehaMove3::ReadDeviceCache(this->rmInitSettings.StimConfig.DeviceCacheFile, this->DeviceFileName, &this->DeviceCacheEntry)){
+				if (!this->rmInitSettings.checkDeviceIDs || (strcmp(this->rmInitSettings.RequestedDeviceID, this->DeviceCacheEntry.DeviceID) == 0)){
+					this->rmStatus.DeviceCacheUsed = true;
+					memcpy(&(this->rmStatus.Device.MainVersion), &(this->DeviceCacheEntry.MainVersion), sizeof(Smpt_uc_version));
+					memcpy(&(this->rmStatus.Device.StimVersion), &(this->DeviceCacheEntry.StimVersion), sizeof(Smpt_uc_version));
+					RehaMove3::printMessage(printMSG_rmInitParam, "%s DEBUG: The device '%s' is known from the device cache (last high voltage level: %u)\n     -> The versions are checked after the initialisation.\n",
+							this->DeviceIDClass, this->DeviceCacheEntry.DeviceID, (unsigned int)this->DeviceCacheEntry.HighVoltageLevel);
 				}
 			}
-		} else {
-			RehaMove3::printMessage(printMSG_error, "%s Error: Sending the command %d failed!\n", this->DeviceIDClass, Smpt_Cmd_Get_Device_Id_Ack);
+		}
+		const Smpt_Cmd ProbeAcks[3] = {Smpt_Cmd_Get_Device_Id_Ack, Smpt_Cmd_Get_Version_Main_Ack, Smpt_Cmd_Get_Version_Stim_Ack};
+		int ProbeResults[3] = {-1, -1, -1};
+		uint8_t NumberOfProbeAcks = this->rmStatus.DeviceCacheUsed ? 1 : 3;
+		uint64_t ProbeSend_us = RehaMove3::GetTimeStamp_us();
+		// the expected acknowledgements are added before sending, so the receiver can not miss them
+		for (uint8_t i = 0; i < NumberOfProbeAcks; i++){
+			RehaMove3::AddResponseExpectation(ProbeAcks[i], true);
+		}
+		bool ProbeSend = true;
+		pthread_mutex_lock(&(this->SendPackage_mutex));
+		ProbeSend = ProbeSend && smpt_send_get_device_id(&(this->Device), RehaMove3::GetPackageNumber());
+		if (!this->rmStatus.DeviceCacheUsed){
+			ProbeSend = ProbeSend && smpt_send_get_version_main(&(this->Device), RehaMove3::GetPackageNumber());
+			ProbeSend = ProbeSend && smpt_send_get_version_stim(&(this->Device), RehaMove3::GetPackageNumber());
+		}
+		ProbeSend = ProbeSend && smpt_send_get_battery_status(&(this->Device), RehaMove3::GetPackageNumber());
+		ProbeSend = ProbeSend && smpt_send_get_stim_status(&(this->Device), RehaMove3::GetPackageNumber());
+		pthread_mutex_unlock(&(this->SendPackage_mutex));
+		if (!ProbeSend){
+			RehaMove3::printMessage(printMSG_error, "%s Error: Sending the commands to probe the device failed!\n", this->DeviceIDClass);
 			RehaMove3::AbortDeviceInitialisation();
 			return false;
 		}
+		// collect the acknowledgements -> the device answers in order, so the first one takes most of the time
+		uint64_t ProbeDeadline_ms = RehaMove3::GetTimeStamp_ns() /1000000 + REHAMOVE_INIT_QUERY_TIMEOUT_MS;
+		for (uint8_t i = 0; i < NumberOfProbeAcks; i++){
+			ProbeResults[i] = RehaMove3::GetResponse(ProbeAcks[i], false, RehaMove3::GetTimeUntil_ms(ProbeDeadline_ms));
+		}
+		// battery and stim status -> saving the data is done in the response handlers
+		bool ProbeStatusReceived = RehaMove3::NewStatusUpdatesReceived(ProbeSend_us, true, false, true, RehaMove3::GetTimeUntil_ms(ProbeDeadline_ms));
 
-		// get the current status -> saving the data is done in the response handlers
-		if (smpt_send_get_battery_status(&(this->Device), RehaMove3::GetPackageNumber())) {
-			if (!RehaMove3::NewStatusUpdateReceived(200)){
-				// error
-				RehaMove3::printMessage(printMSG_error, "%s Error: The current device status could net be read!\n", this->DeviceIDClass);
-				DoDeviceReset = true;
-				continue;
-			}
+		// check the device id
+		if (ProbeResults[0] != Smpt_Cmd_Get_Device_Id_Ack) {
+			// error
+			RehaMove3::printMessage(printMSG_error, "%s Error: The device ID could not be read!\n", this->DeviceIDClass);
+			DoDeviceReset = true;
+			continue;
 		} else {
-			RehaMove3::printMessage(printMSG_error, "%s Error: Sending the command %d failed!\n", this->DeviceIDClass, Smpt_Cmd_Get_Battery_Status);
-			RehaMove3::AbortDeviceInitialisation();
-			return false;
+			// response received -> check the ID
+			memcpy(this->rmStatus.Device.DeviceID, this->Acks.G_device_id_ack.device_id, (size_t)Smpt_Length_Device_Id);
+			this->rmStatus.Device.DeviceID[Smpt_Length_Device_Id] = 0x00;
+			if (this->rmInitSettings.checkDeviceIDs){
+				// check if the device IDs match
+				if (strcmp(this->rmInitSettings.RequestedDeviceID, this->rmStatus.Device.DeviceID) != 0){
+					// IDs do not match
+					this->rmInitResult.successful = false;
+					this->rmInitResult.errorCode = actionError_checkDeviceIDs;
+					sprintf(this->rmInitResult.errorMessage, "The serial numbers do not match\n.     -> Requested SN: '%s';  Found SN: '%s'!\n", this->rmInitSettings.RequestedDeviceID, this->rmStatus.Device.DeviceID);
+					RehaMove3::printMessage(printMSG_error, "%s Error: The serial numbers do not match\n   -> Requested SN: '%s';  Found SN: '%s'!\n", this->DeviceIDClass, this->rmInitSettings.RequestedDeviceID, this->rmStatus.Device.DeviceID);
+					RehaMove3::AbortDeviceInitialisation();
+					return false;
+				}
+			}
+			// an other device on the interface of a cached device -> the versions are read now
+			if (this->rmStatus.DeviceCacheUsed && (strcmp(this->DeviceCacheEntry.DeviceID, this->rmStatus.Device.DeviceID) != 0)){
+				RehaMove3::printMessage(printMSG_rmInitParam, "%s DEBUG: The device '%s' does not match the device cache ('%s') -> reading the versions\n",
+						this->DeviceIDClass, this->rmStatus.Device.DeviceID, this->DeviceCacheEntry.DeviceID);
+				this->rmStatus.DeviceCacheUsed = false;
+				RehaMove3::AddResponseExpectation(ProbeAcks[1], true);
+				RehaMove3::AddResponseExpectation(ProbeAcks[2], true);
+				pthread_mutex_lock(&(this->SendPackage_mutex));
+				ProbeSend = smpt_send_get_version_main(&(this->Device), RehaMove3::GetPackageNumber());
+				ProbeSend = ProbeSend && smpt_send_get_version_stim(&(this->Device), RehaMove3::GetPackageNumber());
+				pthread_mutex_unlock(&(this->SendPackage_mutex));
+				ProbeDeadline_ms = RehaMove3::GetTimeStamp_ns() /1000000 + REHAMOVE_INIT_QUERY_TIMEOUT_MS;
+				for (uint8_t i = 1; ProbeSend && (i < 3); i++){
+					ProbeResults[i] = RehaMove3::GetResponse(ProbeAcks[i], false, RehaMove3::GetTimeUntil_ms(ProbeDeadline_ms));
+				}
+			}
+		}
+
+		// check the current status
+		if (!ProbeStatusReceived){
+			// error
+			RehaMove3::printMessage(printMSG_error, "%s Error: The current device status could net be read!\n", this->DeviceIDClass);
+			DoDeviceReset = true;
+			continue;
 		}
 
 		bool printWarning = false, printError = false;
-		// get the main version
-		if (smpt_send_get_version_main(&(this->Device), RehaMove3::GetPackageNumber())) {
-			if (RehaMove3::GetResponse(Smpt_Cmd_Get_Version_Main_Ack, true, 500) != Smpt_Cmd_Get_Version_Main_Ack) {
-				// error
-				RehaMove3::printMessage(printMSG_error, "%s Error: The version of the 'Main MCU' could net be read!\n", this->DeviceIDClass);
-				DoDeviceReset = true;
-				continue;
-			} else {
-				// response received -> get the firmware version
-				memcpy(&(this->rmStatus.Device.MainVersion), &(this->Acks.G_version_ack.uc_version), sizeof(Smpt_uc_version));
-				// test if the device version is supported
-				// main firmware version
-				if (!RehaMove3::CheckSupportedVersion(RM3_SupportedVersionsMain, &this->rmStatus.Device.MainVersion.fw_version, this->rmInitSettings.DebugConfig.disableVersionCheck, &printWarning, &printError)){
-					char versionString[100] = {};
-					if (printWarning && !printError){
-						// show a warning about the unsupported firmware version
-						RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsMain);
-						RehaMove3::printMessage(printMSG_warning, "%s Warning: The firmware version of the 'Main MCU' is probably not fully supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n",
-								this->DeviceIDClass, versionString, this->rmStatus.Device.MainVersion.fw_version.major, this->rmStatus.Device.MainVersion.fw_version.minor, this->rmStatus.Device.MainVersion.fw_version.revision);
-					}
-					if (printError){
-						// show an error about the unsupported firmware version and stop the initialisation
-						RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsMain);
-						RehaMove3::printMessage(printMSG_error, "%s Error: The firmware version of the 'Main MCU' is not supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n\n   -> The initialisation will be aborted!",
-								this->DeviceIDClass, versionString, this->rmStatus.Device.MainVersion.fw_version.major, this->rmStatus.Device.MainVersion.fw_version.minor, this->rmStatus.Device.MainVersion.fw_version.revision);
-						RehaMove3::AbortDeviceInitialisation();
-						return false;
-					}
+		// check the main version
+		if (this->rmStatus.DeviceCacheUsed){
+			// known device -> checked after the initialisation
+		} else if (ProbeResults[1] != Smpt_Cmd_Get_Version_Main_Ack) {
+			// error
+			RehaMove3::printMessage(printMSG_error, "%s Error: The version of the 'Main MCU' could net be read!\n", this->DeviceIDClass);
+			DoDeviceReset = true;
+			continue;
+		} else {
+			// response received -> get the firmware version
+			memcpy(&(this->rmStatus.Device.MainVersion), &(this->Acks.G_version_main_ack.uc_version), sizeof(Smpt_uc_version));
+			// test if the device version is supported
+			// main firmware version
+			if (!RehaMove3::CheckSupportedVersion(RM3_SupportedVersionsMain, &this->rmStatus.Device.MainVersion.fw_version, this->rmInitSettings.DebugConfig.disableVersionCheck, &printWarning, &printError)){
+				char versionString[100] = {};
+				if (printWarning && !printError){
+					// show a warning about the unsupported firmware version
+					RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsMain);
+					RehaMove3::printMessage(printMSG_warning, "%s Warning: The firmware version of the 'Main MCU' is probably not fully supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n",
+							this->DeviceIDClass, versionString, this->rmStatus.Device.MainVersion.fw_version.major, this->rmStatus.Device.MainVersion.fw_version.minor, this->rmStatus.Device.MainVersion.fw_version.revision);
 				}
-				// main SMPT version
-				if (!RehaMove3::CheckSupportedVersion(RM3_SupportedVersionsSMPT, &this->rmStatus.Device.MainVersion.smpt_version, this->rmInitSettings.DebugConfig.disableVersionCheck, &printWarning, &printError)){
+				if (printError){
+					// show an error about the unsupported firmware version and stop the initialisation
+					RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsMain);
+					RehaMove3::printMessage(printMSG_error, "%s Error: The firmware version of the 'Main MCU' is not supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n\n   -> The initialisation will be aborted!",
+							this->DeviceIDClass, versionString, this->rmStatus.Device.MainVersion.fw_version.major, this->rmStatus.Device.MainVersion.fw_version.minor, this->rmStatus.Device.MainVersion.fw_version.revision);
+					RehaMove3::AbortDeviceInitialisation();
+					return false;
+				}
+			}
+			// main SMPT version
+			if (!RehaMove3::CheckSupportedVersion(RM3_SupportedVersionsSMPT, &this->rmStatus.Device.MainVersion.smpt_version, this->rmInitSettings.DebugConfig.disableVersionCheck, &printWarning, &printError)){
+				char versionString[100] = {};
+				if (printWarning && !printError){
+					// show a warning about the unsupported SMPT version
 					char versionString[100] = {};
-					if (printWarning && !printError){
-						// show a warning about the unsupported SMPT version
-						char versionString[100] = {};
-						RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsSMPT);
-						RehaMove3::printMessage(printMSG_warning, "%s Warning: The SMPT version of the 'Main MCU' is probably not fully supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n",
-								this->DeviceIDClass, versionString, this->rmStatus.Device.MainVersion.smpt_version.major, this->rmStatus.Device.MainVersion.smpt_version.minor, this->rmStatus.Device.MainVersion.smpt_version.revision);
-					}
-					if (printError){
-						// show an error about the unsupported SMPT version and stop the initialisation
-						RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsSMPT);
-						RehaMove3::printMessage(printMSG_error, "%s Error: The SMPT version of the 'Main MCU' is not supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n\n   -> The initialisation will be aborted!",
-								this->DeviceIDClass, versionString, this->rmStatus.Device.MainVersion.smpt_version.major, this->rmStatus.Device.MainVersion.smpt_version.minor, this->rmStatus.Device.MainVersion.smpt_version.revision);
-						RehaMove3::AbortDeviceInitialisation();
-						return false;
-					}
+					RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsSMPT);
+					RehaMove3::printMessage(printMSG_warning, "%s Warning: The SMPT version of the 'Main MCU' is probably not fully supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n",
+							this->DeviceIDClass, versionString, this->rmStatus.Device.MainVersion.smpt_version.major, this->rmStatus.Device.MainVersion.smpt_version.minor, this->rmStatus.Device.MainVersion.smpt_version.revision);
+				}
+				if (printError){
+					// show an error about the unsupported SMPT version and stop the initialisation
+					RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsSMPT);
+					RehaMove3::printMessage(printMSG_error, "%s Error: The SMPT version of the 'Main MCU' is not supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n\n   -> The initialisation will be aborted!",
+							this->DeviceIDClass, versionString, this->rmStatus.Device.MainVersion.smpt_version.major, this->rmStatus.Device.MainVersion.smpt_version.minor, this->rmStatus.Device.MainVersion.smpt_version.revision);
+					RehaMove3::AbortDeviceInitialisation();
+					return false;
 				}
 			}
-		} else {
-			RehaMove3::printMessage(printMSG_error, "%s Error: Sending the command %d failed!\n", this->DeviceIDClass, Smpt_Cmd_Get_Version_Main_Ack);
-			RehaMove3::AbortDeviceInitialisation();
-			return false;
 		}
 
-		// get the stim version
-		if (smpt_send_get_version_stim(&(this->Device), RehaMove3::GetPackageNumber())) {
-			if (RehaMove3::GetResponse(Smpt_Cmd_Get_Version_Stim_Ack, true, 500) != Smpt_Cmd_Get_Version_Stim_Ack) {
-				// error
-				RehaMove3::printMessage(printMSG_error, "%s Error: The version of the 'Stim MCU' could net be read!\n", this->DeviceIDClass);
-				DoDeviceReset = true;
-				continue;
-			} else {
-				// response received -> get the firmware version
-				memcpy(&(this->rmStatus.Device.StimVersion), &(this->Acks.G_version_ack.uc_version), sizeof(Smpt_uc_version));
-				// test if the device version is supported
-				// stim firmware version
-				if (!RehaMove3::CheckSupportedVersion(RM3_SupportedVersionsStim, &this->rmStatus.Device.StimVersion.fw_version, this->rmInitSettings.DebugConfig.disableVersionCheck, &printWarning, &printError)){
-					char versionString[100] = {};
-					if (printWarning && !printError){
-						RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsStim);
-						// show a warning about the unsupported firmware version
-						RehaMove3::printMessage(printMSG_warning, "%s Warning: The firmware version of the 'Stim MCU' is probably not fully supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n",
-								this->DeviceIDClass, versionString, this->rmStatus.Device.StimVersion.fw_version.major, this->rmStatus.Device.StimVersion.fw_version.minor, this->rmStatus.Device.StimVersion.fw_version.revision);
-					}
-					if (printError){
-						RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsStim);
-						// show an error about the unsupported firmware version and stop the initialisation
-						RehaMove3::printMessage(printMSG_error, "%s Error: The firmware version of the 'Stim MCU' is not supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n\n   -> The initialisation will be aborted!",
-								this->DeviceIDClass, versionString, this->rmStatus.Device.StimVersion.fw_version.major, this->rmStatus.Device.StimVersion.fw_version.minor, this->rmStatus.Device.StimVersion.fw_version.revision);
-						RehaMove3::AbortDeviceInitialisation();
-						return false;
-					}
+		// check the stim version
+		if (this->rmStatus.DeviceCacheUsed){
+			// known device -> checked after the initialisation
+		} else if (ProbeResults[2] != Smpt_Cmd_Get_Version_Stim_Ack) {
+			// error
+			RehaMove3::printMessage(printMSG_error, "%s Error: The version of the 'Stim MCU' could net be read!\n", this->DeviceIDClass);
+			DoDeviceReset = true;
+			continue;
+		} else {
+			// response received -> get the firmware version
+			memcpy(&(this->rmStatus.Device.StimVersion), &(this->Acks.G_version_stim_ack.uc_version), sizeof(Smpt_uc_version));
+			// test if the device version is supported
+			// stim firmware version
+			if (!RehaMove3::CheckSupportedVersion(RM3_SupportedVersionsStim, &this->rmStatus.Device.StimVersion.fw_version, this->rmInitSettings.DebugConfig.disableVersionCheck, &printWarning, &printError)){
+				char versionString[100] = {};
+				if (printWarning && !printError){
+					RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsStim);
+					// show a warning about the unsupported firmware version
+					RehaMove3::printMessage(printMSG_warning, "%s Warning: The firmware version of the 'Stim MCU' is probably not fully supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n",
+							this->DeviceIDClass, versionString, this->rmStatus.Device.StimVersion.fw_version.major, this->rmStatus.Device.StimVersion.fw_version.minor, this->rmStatus.Device.StimVersion.fw_version.revision);
 				}
-				// stim SMPT version
-				if (!RehaMove3::CheckSupportedVersion(RM3_SupportedVersionsSMPT, &this->rmStatus.Device.StimVersion.smpt_version, this->rmInitSettings.DebugConfig.disableVersionCheck, &printWarning, &printError)){
-					char versionString[100] = {};
-					if (printWarning && !printError){
-						RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsSMPT);
-						// show a warning about the unsupported SMPT version
-						RehaMove3::printMessage(printMSG_warning, "%s Warning: The SMPT version of the 'Stim MCU' is probably not fully supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n",
-								this->DeviceIDClass, versionString, this->rmStatus.Device.StimVersion.smpt_version.major, this->rmStatus.Device.StimVersion.smpt_version.minor, this->rmStatus.Device.StimVersion.smpt_version.revision);
-					}
-					if (printError){
-						RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsSMPT);
-						// show an error about the unsupported SMPT version and stop the initialisation
-						RehaMove3::printMessage(printMSG_error, "%s Error: The SMPT version of the 'Stim MCU' is not supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n\n   -> The initialisation will be aborted!",
-								this->DeviceIDClass, versionString, this->rmStatus.Device.StimVersion.smpt_version.major, this->rmStatus.Device.StimVersion.smpt_version.minor, this->rmStatus.Device.StimVersion.smpt_version.revision);
-						RehaMove3::AbortDeviceInitialisation();
-						return false;
-					}
+				if (printError){
+					RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsStim);
+					// show an error about the unsupported firmware version and stop the initialisation
+					RehaMove3::printMessage(printMSG_error, "%s Error: The firmware version of the 'Stim MCU' is not supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n\n   -> The initialisation will be aborted!",
+							this->DeviceIDClass, versionString, this->rmStatus.Device.StimVersion.fw_version.major, this->rmStatus.Device.StimVersion.fw_version.minor, this->rmStatus.Device.StimVersion.fw_version.revision);
+					RehaMove3::AbortDeviceInitialisation();
+					return false;
+				}
+			}
+			// stim SMPT version
+			if (!RehaMove3::CheckSupportedVersion(RM3_SupportedVersionsSMPT, &this->rmStatus.Device.StimVersion.smpt_version, this->rmInitSettings.DebugConfig.disableVersionCheck, &printWarning, &printError)){
+				char versionString[100] = {};
+				if (printWarning && !printError){
+					RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsSMPT);
+					// show a warning about the unsupported SMPT version
+					RehaMove3::printMessage(printMSG_warning, "%s Warning: The SMPT version of the 'Stim MCU' is probably not fully supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n",
+							this->DeviceIDClass, versionString, this->rmStatus.Device.StimVersion.smpt_version.major, this->rmStatus.Device.StimVersion.smpt_version.minor, this->rmStatus.Device.StimVersion.smpt_version.revision);
+				}
+				if (printError){
+					RehaMove3::printSupportedVersion(versionString, RM3_SupportedVersionsSMPT);
+					// show an error about the unsupported SMPT version and stop the initialisation
+					RehaMove3::printMessage(printMSG_error, "%s Error: The SMPT version of the 'Stim MCU' is not supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n\n   -> The initialisation will be aborted!",
+							this->DeviceIDClass, versionString, this->rmStatus.Device.StimVersion.smpt_version.major, this->rmStatus.Device.StimVersion.smpt_version.minor, this->rmStatus.Device.StimVersion.smpt_version.revision);
+					RehaMove3::AbortDeviceInitialisation();
+					return false;
 				}
 			}
-		} else {
-			RehaMove3::printMessage(printMSG_error, "%s Error: Sending the command %d failed!\n", this->DeviceIDClass, Smpt_Cmd_Get_Version_Stim_Ack);
-			RehaMove3::AbortDeviceInitialisation();
-			return false;
 		}
 		// print the current status, in case something goes wrong
 		RehaMove3::printMessage(printMSG_rmDeviceInfo, "%s: The stimulator '%s' was found on interface '%s'\n   -> Versions: M[%u.%u.%u|%u.%u.%u] / S[%u.%u.%u|%u.%u.%u]\n   -> Battery Voltage: %u%% (%0.2fV)\n",
@@ -436,8 +687,36 @@ bool RehaMove3::InitialiseDevice(void)
 				this->rmStatus.Device.StimVersion.fw_version.major, this->rmStatus.Device.StimVersion.fw_version.minor, this->rmStatus.Device.StimVersion.fw_version.revision,
 				this->rmStatus.Device.BatteryLevel, this->rmStatus.Device.BatteryVoltage);
 
-		this->rmStatus.DeviceLlIsInitialised = false;
-		this->rmStatus.DeviceMlIsInitialised = false;
+		/*
+		 * Stop the stimulation of a running device (e.g. from the last model run) -> not needed after a reset or if the probed device is stopped
+		 * -> the stim status was received with the probe above; it does not tell which protocol is running, so both protocols are stopped
+		 */
+		if ((ResetCounter == 0) && (this->rmStatus.Device.StimStatus == REHAMOVE_INIT_STIM_STATUS_STOPPED)){
+			RehaMove3::printMessage(printMSG_rmInitParam, "%s DEBUG: The device is stopped (stim status: %u) -> nothing to stop\n", this->DeviceIDClass, (unsigned int)this->rmStatus.Device.StimStatus);
+		} else if (ResetCounter == 0){
+			RehaMove3::SetInitPhase(rmInitPhase_Stop);
+			RehaMove3::printMessage(printMSG_rmInitParam, "%s DEBUG: The device is still running (stim status: %u) -> stopping the LowLevel and MidLevel protocol\n", this->DeviceIDClass, (unsigned int)this->rmStatus.Device.StimStatus);
+			// a missing acknowledgement is no error -> the ll_init / ml_init below decides if a reset is needed
+			RehaMove3::AddResponseExpectation(Smpt_Cmd_Ll_Stop_Ack, true);
+			RehaMove3::AddResponseExpectation(Smpt_Cmd_Ml_Stop_Ack, true);
+			pthread_mutex_lock(&(this->SendPackage_mutex));
+			bool LlStopSend = smpt_send_ll_stop(&(this->Device), RehaMove3::GetPackageNumber());
+			bool MlStopSend = smpt_send_ml_stop(&(this->Device), RehaMove3::GetPackageNumber());
+			pthread_mutex_unlock(&(this->SendPackage_mutex));
+			uint64_t StopDeadline_ms = RehaMove3::GetTimeStamp_ns() /1000000 + REHAMOVE_INIT_QUERY_TIMEOUT_MS;
+			if ((RehaMove3::GetResponse(Smpt_Cmd_Ll_Stop_Ack, false, RehaMove3::GetTimeUntil_ms(StopDeadline_ms)) != Smpt_Cmd_Ll_Stop_Ack) && LlStopSend) {
+				RehaMove3::printMessage(printMSG_rmInitParam, "     -> The LL_Stop acknowledgement is missing.\n");
+			}
+			if ((RehaMove3::GetResponse(Smpt_Cmd_Ml_Stop_Ack, false, RehaMove3::GetTimeUntil_ms(StopDeadline_ms)) != Smpt_Cmd_Ml_Stop_Ack) && MlStopSend) {
+				RehaMove3::printMessage(printMSG_rmInitParam, "     -> The ML_Stop acknowledgement is missing.\n");
+			}
+		}
+
+		RehaMove3::SetInitPhase(rmInitPhase_ProtocolInit);
+		this->rmStatus.DeviceLlIsInitialised.Store(false);
+		this->rmStatus.DeviceMlIsInitialised.Store(false);
+		this->rmStatus.HybridSequenceOffloaded.Store(false);
+		this->rmSettings.LowLevel.HybridStableSequences = 0;
 		this->rmSettings.CommProtocol = this->rmInitSettings.StimConfig.rmProtocol;
 		switch(this->rmSettings.CommProtocol){
 		case REHAMOVE_MODE_LOWLEVEL_PREDEDINED:
@@ -445,7 +724,7 @@ bool RehaMove3::InitialiseDevice(void)
 			/*
 			 * LowLevel communication mode
 			 */
-			Smpt_ll_init ll_init = {0};
+			Smpt_ll_init ll_init;
 			smpt_clear_ll_init(&ll_init);
 
 			if (this->rmInitSettings.LowLevelConfig.UseDenervation) {
@@ -461,9 +740,6 @@ bool RehaMove3::InitialiseDevice(void)
 			// set voltage level
 			ll_init.high_voltage_level = (Smpt_High_Voltage)this->rmInitSettings.LowLevelConfig.HighVoltageLevel;
 
-			// package number
-			ll_init.packet_number = RehaMove3::GetPackageNumber();
-
 			// check the configuration
 			if (smpt_is_valid_ll_init(&ll_init)) {
 				// init configuration is valid
@@ -472,7 +748,11 @@ bool RehaMove3::InitialiseDevice(void)
 				//RehaMove3::printMessage(printMSG_rmInitParam, "     -> Denervation used: %s\n", (this->rmInitSettings.LowLevelConfig.UseDenervation ? "yes":"no"));
 
 				// Send the ll_init command to the stimulator
-				if (smpt_send_ll_init(&(this->Device), &ll_init)) {
+				pthread_mutex_lock(&(this->SendPackage_mutex));
+				ll_init.packet_number = RehaMove3::GetPackageNumber();
+				bool LlInitSend = smpt_send_ll_init(&(this->Device), &ll_init);
+				pthread_mutex_unlock(&(this->SendPackage_mutex));
+				if (LlInitSend) {
 					if (RehaMove3::GetResponse(Smpt_Cmd_Ll_Init_Ack, true, 500) != Smpt_Cmd_Ll_Init_Ack) {
 						// error
 						RehaMove3::printMessage(printMSG_error, "%s Error: The device could not be initialised! The LL_Init acknowledgement is missing!\n", this->DeviceIDClass);
@@ -480,7 +760,7 @@ bool RehaMove3::InitialiseDevice(void)
 						continue;
 					} else {
 						// update the internal status
-						this->rmStatus.DeviceLlIsInitialised = true;
+						this->rmStatus.DeviceLlIsInitialised.Store(true);
 						// lock the sequence queue
 						pthread_mutex_lock(&(this->LlSequenceQueueLock_mutex));
 						// show the warning about a full queue only one -> reset the value to true
@@ -507,19 +787,20 @@ bool RehaMove3::InitialiseDevice(void)
 			/*
 			 * MidLevel communication mode
 			 */
-			Smpt_ml_init ml_init = {0};
+			Smpt_ml_init ml_init;
 			smpt_clear_ml_init(&ml_init);
 
-			// package number
-			ml_init.packet_number = RehaMove3::GetPackageNumber();
-
 			// check the configuration
 			if (smpt_is_valid_ml_init(&ml_init)) {
 				// init configuration is valid
 				RehaMove3::printMessage(printMSG_rmInitParam, "%s DEBUG: Initialising the MidLevel Protocol\n     -> no parameter\n", this->DeviceIDClass);
 
-				// Send the ll_init command to the stimulator
-				if (smpt_send_ml_init(&(this->Device), &ml_init)) {
+				// Send the ml_init command to the stimulator
+				pthread_mutex_lock(&(this->SendPackage_mutex));
+				ml_init.packet_number = RehaMove3::GetPackageNumber();
+				bool MlInitSend = smpt_send_ml_init(&(this->Device), &ml_init);
+				pthread_mutex_unlock(&(this->SendPackage_mutex));
+				if (MlInitSend) {
 					if (RehaMove3::GetResponse(Smpt_Cmd_Ml_Init_Ack, true, 500) != Smpt_Cmd_Ml_Init_Ack) {
 						// error
 						RehaMove3::printMessage(printMSG_error, "%s Error: The device could not be initialised! The ML_Init acknowledgement is missing!\n", this->DeviceIDClass);
@@ -527,7 +808,7 @@ bool RehaMove3::InitialiseDevice(void)
 						continue;
 					} else {
 						// update the internal status
-						this->rmStatus.DeviceMlIsInitialised = true;
+						this->rmStatus.DeviceMlIsInitialised.Store(true);
 						RehaMove3::printMessage(printMSG_rmInitParam, "     -> SUCCESSFUL initialised\n");
 					}
 				} else {
@@ -553,49 +834,77 @@ bool RehaMove3::InitialiseDevice(void)
 		/*
 		 * Checks
 		 */
-		// get the current stim status -> saving the data is done in the response handlers
-		if (smpt_send_get_stim_status(&(this->Device), RehaMove3::GetPackageNumber())) {
-			if (RehaMove3::NewStatusUpdateReceived(200)){
-				// TODO Init STIM check: low level initialised, high voltage Level
-			} else {
-				RehaMove3::printMessage(printMSG_error, "%s Error: The current 'STIM Status' could net be read!\n", this->DeviceIDClass);
-				DoDeviceReset = true;
-				continue;
-			}
-		} else {
-			RehaMove3::printMessage(printMSG_error, "%s Error: Sending the command %d failed!\n", this->DeviceIDClass, Smpt_Cmd_Get_Stim_Status);
+		RehaMove3::SetInitPhase(rmInitPhase_Checks);
+		// get the current stim and main status -> saving the data is done in the response handlers
+		uint64_t ChecksSend_us = RehaMove3::GetTimeStamp_us();
+		pthread_mutex_lock(&(this->SendPackage_mutex));
+		bool ChecksSend = smpt_send_get_stim_status(&(this->Device), RehaMove3::GetPackageNumber()) && smpt_send_get_main_status(&(this->Device), RehaMove3::GetPackageNumber());
+		pthread_mutex_unlock(&(this->SendPackage_mutex));
+		if (!ChecksSend) {
+			RehaMove3::printMessage(printMSG_error, "%s Error: Sending the commands %d and %d failed!\n", this->DeviceIDClass, Smpt_Cmd_Get_Stim_Status, Smpt_Cmd_Get_Main_Status);
 			RehaMove3::AbortDeviceInitialisation();
 			return false;
 		}
-
-		// get the current main status -> saving the data is done in the response handlers
-		if (smpt_send_get_main_status(&(this->Device), RehaMove3::GetPackageNumber())) {
-			if (RehaMove3::NewStatusUpdateReceived(200)){
-				// main status could be read -> done
-			} else {
-				RehaMove3::printMessage(printMSG_error, "%s Error: The current 'MAIN Status' could net be read!\n", this->DeviceIDClass);
-				DoDeviceReset = true;
-				continue;
-			}
+		if (RehaMove3::NewStatusUpdatesReceived(ChecksSend_us, false, true, true, REHAMOVE_INIT_QUERY_TIMEOUT_MS)){
+			// TODO Init STIM check: low level initialised, high voltage Level
 		} else {
-			RehaMove3::printMessage(printMSG_error, "%s Error: Sending the command %d failed!\n", this->DeviceIDClass, Smpt_Cmd_Get_Main_Status);
-			RehaMove3::AbortDeviceInitialisation();
-			return false;
+			RehaMove3::printMessage(printMSG_error, "%s Error: The current 'STIM Status' and 'MAIN Status' could net be read!\n", this->DeviceIDClass);
+			DoDeviceReset = true;
+			continue;
 		}
 
 		// end the initialise loop
 	} while (DoDeviceReset);
 
 	// print the status
+	RehaMove3::SetInitPhase(rmInitPhase_NumberOfPhases);
 	RehaMove3::printMessage(printMSG_rmInitInfo, "%s: Initialising %s was successful!\n", this->DeviceIDClass, this->DeviceFileName);
+	RehaMove3::PrintInitTiming();
 	if (this->rmInitSettings.DebugConfig.printInitInfos){
 		RehaMove3::GetCurrentStatus(this->rmInitSettings.DebugConfig.printInitInfos, false, 0);
 	}
 
 	// the initialisation was not aborted, so it was successful
-	this->rmStatus.DeviceInitialised = true;
-	this->rmStatus.InitThreatRunning = false;
-	this->rmStatus.InitThreatActive  = false;
+	this->rmStatus.DeviceInitialised.Store(true);
+	this->rmStatus.InitThreatRunning.Store(false);
+	this->rmStatus.InitThreatActive.Store(false);
+
+	// MidLevel: start the timer driven keep alive signal
+	if (this->rmStatus.DeviceMlIsInitialised.Load() && this->rmInitSettings.MidLevelConfig.UseTimerForKeepAliveSignal){
+		RehaMove3::StartMidLevelKeepAliveTimer();
+	}
+	// MidLevel: start the update thread
+	if (this->rmStatus.DeviceMlIsInitialised.Load() && this->rmInitSettings.MidLevelConfig.UseUpdateMailbox){
+		RehaMove3::StartMidLevelUpdateSender();
+	}
+	// start the status requests
+	if (this->rmInitSettings.StimConfig.StatusPollPeriod_ms > 0.0){
+		RehaMove3::StartStatusPoller();
+	}
+	// start the statistics export
+	if ((this->rmInitSettings.DebugConfig.StatsExportFile[0] != 0) && (this->rmInitSettings.DebugConfig.StatsExportPeriod_ms > 0.0)){
+		RehaMove3::StartStatisticsExporter();
+	}
+	// start the shared memory telemetry
+	if ((this->rmInitSettings.DebugConfig.TelemetrySegmentName[0] != 0) && (this->rmInitSettings.DebugConfig.TelemetryPeriod_ms > 0.0)){
+		RehaMove3::StartTelemetryPublisher();
+	}
+	// start the watchdog of the connection
+	if (this->rmInitSettings.StimConfig.AutoReconnect){
+		this->rmStatus.LastAckReceived_us.Store(RehaMove3::GetTimeStamp_us());
+		RehaMove3::StartReconnectWatchdog();
+	}
+	// device cache: check a known device while the stimulation is running, save the validated versions of a new device
+	if (this->rmStatus.DeviceCacheUsed){
+		RehaMove3::StartDeviceCheck();
+	} else if (this->rmInitSettings.StimConfig.DeviceCacheFile[0] != 0){
+		snprintf(this->DeviceCacheEntry.DevicePath, sizeof(this->DeviceCacheEntry.DevicePath), "%s", this->DeviceFileName);
+		memcpy(this->DeviceCacheEntry.DeviceID, this->rmStatus.Device.DeviceID, sizeof(this->DeviceCacheEntry.DeviceID));
+		memcpy(&(this->DeviceCacheEntry.MainVersion), &(this->rmStatus.Device.MainVersion), sizeof(Smpt_uc_version));
+		memcpy(&(this->DeviceCacheEntry.StimVersion), &(this->rmStatus.Device.StimVersion), sizeof(Smpt_uc_version));
+		this->DeviceCacheEntry.HighVoltageLevel = this->rmStatus.Device.HighVoltageLevel;
+		RehaMove3::UpdateDeviceCache(this->rmInitSettings.StimConfig.DeviceCacheFile, &this->DeviceCacheEntry, false);
+	}
 
 	this->rmInitResult.finished = true;
 	this->rmInitResult.successful = true;
@@ -603,52 +912,1300 @@ bool RehaMove3::InitialiseDevice(void)
 	return true;
 }
 
+bool RehaMove3::ReadDeviceCache(const char *FileName, const char *DevicePath, rmDeviceCacheEntry_t *Entry)
+{
+	/*
+	 * One line per interface: <interface>\t<device ID>\t<main FW>\t<main SMPT>\t<stim FW>\t<stim SMPT>\t<high voltage level>
+	 */
+	FILE *CacheFile = fopen(FileName, "r");
+	if (CacheFile == NULL){
+		return false;
+	}
+	char Line[512];
+	bool EntryFound = false;
+	while (!EntryFound && (fgets(Line, sizeof(Line), CacheFile) != NULL)){
+		rmDeviceCacheEntry_t LineEntry;
+		char DeviceID[64];
+		unsigned int V[13] = {0};
+		memset(&LineEntry, 0, sizeof(LineEntry));
+		if (sscanf(Line, "%254[^\t]\t%63[^\t]\t%u.%u.%u\t%u.%u.%u\t%u.%u.%u\t%u.%u.%u\t%u", LineEntry.DevicePath, DeviceID,
+				&V[0], &V[1], &V[2], &V[3], &V[4], &V[5], &V[6], &V[7], &V[8], &V[9], &V[10], &V[11], &V[12]) != 15){
+			continue;
+		}
+		if (strlen(DeviceID) >= sizeof(LineEntry.DeviceID)){
+			continue;
+		}
+		memcpy(LineEntry.DeviceID, DeviceID, strlen(DeviceID) +1);
+		if (strcmp(LineEntry.DevicePath, DevicePath) != 0){
+			continue;
+		}
+		Smpt_version *Versions[4] = {&LineEntry.MainVersion.fw_version, &LineEntry.MainVersion.smpt_version, &LineEntry.StimVersion.fw_version, &LineEntry.StimVersion.smpt_version};
+		for (uint8_t i = 0; i < 4; i++){
+			Versions[i]->major	  = (uint8_t)V[i*3];
+			Versions[i]->minor	  = (uint8_t)V[i*3 +1];
+			Versions[i]->revision = (uint8_t)V[i*3 +2];
+		}
+		LineEntry.HighVoltageLevel = (uint8_t)V[12];
+		memcpy(Entry, &LineEntry, sizeof(LineEntry));
+		EntryFound = true;
+	}
+	fclose(CacheFile);
+	return EntryFound;
+}
+
+bool RehaMove3::UpdateDeviceCache(const char *FileName, const rmDeviceCacheEntry_t *Entry, bool DoRemove)
+{
+	/*
+	 * The entries of the same interface or device are replaced (or removed); the file is written to a unique temporary file and renamed
+	 * -> the devices of other processes update the cache at the same time -> <file>.lock serialises the updates
+	 */
+	char LockFileName[300], TempFileName[300];
+	snprintf(LockFileName, sizeof(LockFileName), "%s.lock", FileName);
+	snprintf(TempFileName, sizeof(TempFileName), "%s.XXXXXX", FileName);
+	int LockFile = open(LockFileName, O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+	if ((LockFile < 0) || (flock(LockFile, LOCK_EX) != 0)){
+		RehaMove3::printMessage(printMSG_warning, "%s Warning: The device cache %s could not be locked:\n     -> %s (%d)\n", this->DeviceIDClass, LockFileName, strerror(errno), errno);
+		if (LockFile >= 0){
+			close(LockFile);
+		}
+		return false;
+	}
+	int TempFileDescriptor = mkstemp(TempFileName);
+	FILE *TempFile = (TempFileDescriptor >= 0) ? fdopen(TempFileDescriptor, "w") : NULL;
+	if (TempFile == NULL){
+		RehaMove3::printMessage(printMSG_warning, "%s Warning: The device cache %s could not be written:\n     -> %s (%d)\n", this->DeviceIDClass, TempFileName, strerror(errno), errno);
+		if (TempFileDescriptor >= 0){
+			close(TempFileDescriptor);
+			unlink(TempFileName);
+		}
+		close(LockFile);
+		return false;
+	}
+	// mkstemp creates the file only readable by the owner
+	fchmod(TempFileDescriptor, 0644);
+	FILE *CacheFile = fopen(FileName, "r");
+	if (CacheFile != NULL){
+		char Line[512], DevicePath[255], DeviceID[64];
+		while (fgets(Line, sizeof(Line), CacheFile) != NULL){
+			if (sscanf(Line, "%254[^\t]\t%63[^\t]", DevicePath, DeviceID) != 2){
+				continue;
+			}
+			if ((strcmp(DevicePath, Entry->DevicePath) == 0) || (strcmp(DeviceID, Entry->DeviceID) == 0)){
+				continue;
+			}
+			fputs(Line, TempFile);
+		}
+		fclose(CacheFile);
+	}
+	if (!DoRemove){
+		fprintf(TempFile, "%s\t%s\t%u.%u.%u\t%u.%u.%u\t%u.%u.%u\t%u.%u.%u\t%u\n", Entry->DevicePath, Entry->DeviceID,
+				Entry->MainVersion.fw_version.major, Entry->MainVersion.fw_version.minor, Entry->MainVersion.fw_version.revision,
+				Entry->MainVersion.smpt_version.major, Entry->MainVersion.smpt_version.minor, Entry->MainVersion.smpt_version.revision,
+				Entry->StimVersion.fw_version.major, Entry->StimVersion.fw_version.minor, Entry->StimVersion.fw_version.revision,
+				Entry->StimVersion.smpt_version.major, Entry->StimVersion.smpt_version.minor, Entry->StimVersion.smpt_version.revision,
+				(unsigned int)Entry->HighVoltageLevel);
+	}
+	bool ReturnValue = true;
+	if ((fclose(TempFile) != 0) || (rename(TempFileName, FileName) != 0)){
+		RehaMove3::printMessage(printMSG_warning, "%s Warning: The device cache %s could not be written:\n     -> %s (%d)\n", this->DeviceIDClass, FileName, strerror(errno), errno);
+		unlink(TempFileName);
+		ReturnValue = false;
+	}
+	flock(LockFile, LOCK_UN);
+	close(LockFile);
+	return ReturnValue;
+}
+
+bool RehaMove3::StartDeviceCheck(void)
+{
+	if (this->rmStatus.DeviceCheckThreatRunning.Load()){
+		return true;
+	}
+	this->rmStatus.DeviceCheckThreatActive.Store(true);
+	int ReturnValue = pthread_create(&(this->DeviceCheckThread), NULL, DeviceCheckThreadFunc, (void *)this);
+	if (ReturnValue != 0) {
+		this->rmStatus.DeviceCheckThreatActive.Store(false);
+		this->DeviceCheckThread = 0;
+		RehaMove3::printMessage(printMSG_error, "%s Error: The device check threat could not be started:\n     -> %s (%d)\n     -> The cached device versions are not checked.\n", this->DeviceIDClass, strerror(ReturnValue), ReturnValue);
+		return false;
+	}
+	RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: Starting the device check threat was successfully.\n");
+	return true;
+}
+
+void RehaMove3::StopDeviceCheck(void)
+{
+	this->rmStatus.DeviceCheckThreatActive.Store(false);
+	if (this->DeviceCheckThread != 0){
+		//wait for the device check threat to stop
+		pthread_join(this->DeviceCheckThread, NULL);
+		this->DeviceCheckThread = 0;
+	}
+}
+
+void RehaMove3::RunDeviceCheck(void)
+{
+	this->rmStatus.DeviceCheckThreatRunning.Store(true);
+
+	// wait for the first stimulation command, so the check does not delay the first pulse
+	uint64_t CheckTime_us = RehaMove3::GetTimeStamp_us() + REHAMOVE_DEVICECHECK_DELAY_MS *1000;
+	while (this->rmStatus.DeviceCheckThreatActive.Load() && (RehaMove3::GetTimeStamp_us() < CheckTime_us)){
+		if ((this->Stats.SequencesSend.Load() > 0) || (this->Stats.UpdatesSend.Load() > 0)){
+			break;
+		}
+		RehaMove3::SleepFor_us(REHAMOVE_DEVICECHECK_THREAD_DELAY_US);
+	}
+	if (!this->rmStatus.DeviceCheckThreatActive.Load()){
+		this->rmStatus.DeviceCheckThreatRunning.Store(false);
+		return;
+	}
+
+	// request the device ID and the versions
+	const Smpt_Cmd CheckAcks[3] = {Smpt_Cmd_Get_Device_Id_Ack, Smpt_Cmd_Get_Version_Main_Ack, Smpt_Cmd_Get_Version_Stim_Ack};
+	int CheckResults[3] = {-1, -1, -1};
+	pthread_mutex_lock(&(this->SendPackage_mutex));
+	for (uint8_t i = 0; i < 3; i++){
+		RehaMove3::AddResponseExpectation(CheckAcks[i], true);
+	}
+	smpt_send_get_device_id(&(this->Device), RehaMove3::GetPackageNumber());
+	smpt_send_get_version_main(&(this->Device), RehaMove3::GetPackageNumber());
+	smpt_send_get_version_stim(&(this->Device), RehaMove3::GetPackageNumber());
+	pthread_mutex_unlock(&(this->SendPackage_mutex));
+	uint64_t CheckDeadline_ms = RehaMove3::GetTimeStamp_ns() /1000000 + REHAMOVE_INIT_QUERY_TIMEOUT_MS;
+	for (uint8_t i = 0; i < 3; i++){
+		CheckResults[i] = RehaMove3::GetResponse(CheckAcks[i], false, RehaMove3::GetTimeUntil_ms(CheckDeadline_ms));
+	}
+	if ((CheckResults[0] != Smpt_Cmd_Get_Device_Id_Ack) || (CheckResults[1] != Smpt_Cmd_Get_Version_Main_Ack) || (CheckResults[2] != Smpt_Cmd_Get_Version_Stim_Ack)){
+		RehaMove3::printMessage(printMSG_warning, "%s Warning: The device ID and the versions of the cached device could not be read!\n", this->DeviceIDClass);
+		this->rmStatus.DeviceCheckThreatRunning.Store(false);
+		return;
+	}
+
+	rmDeviceCacheEntry_t DeviceEntry;
+	memcpy(&DeviceEntry, &this->DeviceCacheEntry, sizeof(DeviceEntry));
+	memcpy(DeviceEntry.DeviceID, this->Acks.G_device_id_ack.device_id, (size_t)Smpt_Length_Device_Id);
+	DeviceEntry.DeviceID[Smpt_Length_Device_Id] = 0x00;
+	memcpy(&(DeviceEntry.MainVersion), &(this->Acks.G_version_main_ack.uc_version), sizeof(Smpt_uc_version));
+	memcpy(&(DeviceEntry.StimVersion), &(this->Acks.G_version_stim_ack.uc_version), sizeof(Smpt_uc_version));
+	if ((strcmp(DeviceEntry.DeviceID, this->DeviceCacheEntry.DeviceID) == 0) &&
+		(memcmp(&DeviceEntry.MainVersion, &this->DeviceCacheEntry.MainVersion, sizeof(Smpt_uc_version)) == 0) &&
+		(memcmp(&DeviceEntry.StimVersion, &this->DeviceCacheEntry.StimVersion, sizeof(Smpt_uc_version)) == 0)){
+		RehaMove3::printMessage(printMSG_rmDeviceInfo, "%s DEBUG: The device ID and the versions of the cached device are confirmed.\n", this->DeviceIDClass);
+		this->rmStatus.DeviceCheckThreatRunning.Store(false);
+		return;
+	}
+
+	/*
+	 * The device changed -> the full check of the initialisation
+	 */
+	RehaMove3::printMessage(printMSG_warning, "%s Warning: The device on interface '%s' does not match the device cache (cached: '%s'; found: '%s')!\n     -> The device ID and the versions are checked now.\n",
+			this->DeviceIDClass, this->DeviceFileName, this->DeviceCacheEntry.DeviceID, DeviceEntry.DeviceID);
+	bool CheckFailed = false;
+	if (this->rmInitSettings.checkDeviceIDs && (strcmp(this->rmInitSettings.RequestedDeviceID, DeviceEntry.DeviceID) != 0)){
+		RehaMove3::printMessage(printMSG_error, "%s Error: The serial numbers do not match\n   -> Requested SN: '%s';  Found SN: '%s'!\n", this->DeviceIDClass, this->rmInitSettings.RequestedDeviceID, DeviceEntry.DeviceID);
+		CheckFailed = true;
+	}
+	const uint8_t (*SupportedVersions[4])[3] = {RM3_SupportedVersionsMain, RM3_SupportedVersionsSMPT, RM3_SupportedVersionsStim, RM3_SupportedVersionsSMPT};
+	Smpt_version *DeviceVersions[4] = {&DeviceEntry.MainVersion.fw_version, &DeviceEntry.MainVersion.smpt_version, &DeviceEntry.StimVersion.fw_version, &DeviceEntry.StimVersion.smpt_version};
+	const char *VersionNames[4] = {"firmware version of the 'Main MCU'", "SMPT version of the 'Main MCU'", "firmware version of the 'Stim MCU'", "SMPT version of the 'Stim MCU'"};
+	for (uint8_t i = 0; i < 4; i++){
+		bool printWarning = false, printError = false;
+		if (!RehaMove3::CheckSupportedVersion(SupportedVersions[i], DeviceVersions[i], this->rmInitSettings.DebugConfig.disableVersionCheck, &printWarning, &printError)){
+			char versionString[100] = {};
+			RehaMove3::printSupportedVersion(versionString, SupportedVersions[i]);
+			RehaMove3::printMessage(printError ? printMSG_error : printMSG_warning, "%s %s: The %s is %s supported!\n   -> Supported Versions: %s\n   -> Version of the device: %u.%u.%u\n",
+					this->DeviceIDClass, printError ? "Error" : "Warning", VersionNames[i], printError ? "not" : "probably not fully", versionString, DeviceVersions[i]->major, DeviceVersions[i]->minor, DeviceVersions[i]->revision);
+			CheckFailed = CheckFailed || printError;
+		}
+	}
+	memcpy(this->rmStatus.Device.DeviceID, DeviceEntry.DeviceID, sizeof(this->rmStatus.Device.DeviceID));
+	memcpy(&(this->rmStatus.Device.MainVersion), &(DeviceEntry.MainVersion), sizeof(Smpt_uc_version));
+	memcpy(&(this->rmStatus.Device.StimVersion), &(DeviceEntry.StimVersion), sizeof(Smpt_uc_version));
+	if (CheckFailed){
+		// like a stimulation error without re-test -> publish the retest settings before DoNotStimulate
+		this->rmStatus.DoReTestTheStimError = false;
+		this->rmStatus.NumberOfSequencesUntilErrorRetest = 0xFFFF;
+		this->rmStatus.DoNotStimulate.Store(true);
+		RehaMove3::printMessage(printMSG_error, "%s Error: The device check failed!\n   -> The stimulation will be DISABLED!\n", this->DeviceIDClass);
+		RehaMove3::UpdateDeviceCache(this->rmInitSettings.StimConfig.DeviceCacheFile, &this->DeviceCacheEntry, true);
+	} else {
+		RehaMove3::UpdateDeviceCache(this->rmInitSettings.StimConfig.DeviceCacheFile, &DeviceEntry, false);
+	}
+
+	// done
+	this->rmStatus.DeviceCheckThreatRunning.Store(false);
+}
+
+bool RehaMove3::StartReconnectWatchdog(void)
+{
+	if (this->rmStatus.ReconnectThreatActive.Load()){
+		return true;
+	}
+	// the watchdog waits for acknowledgements -> only possible if they are read by the receiver threat
+	if (!this->rmSettings.UseThreadForAcks){
+		RehaMove3::printMessage(printMSG_warning, "%s Warning: The automatic reconnect needs the receiver threat (UseThreadForAcks)!\n     -> A lost connection is not detected.\n", this->DeviceIDClass);
+		return false;
+	}
+	this->rmStatus.ReconnectThreatActive.Store(true);
+	int ReturnValue = pthread_create(&(this->ReconnectThread), NULL, ReconnectThreadFunc, (void *)this);
+	if (ReturnValue != 0) {
+		this->rmStatus.ReconnectThreatActive.Store(false);
+		RehaMove3::printMessage(printMSG_error, "%s Error: The reconnect watchdog threat could not be started:\n     -> %s (%d)\n     -> A lost connection is not detected.\n", this->DeviceIDClass, strerror(ReturnValue), ReturnValue);
+		return false;
+	}
+	RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: Starting the reconnect watchdog threat was successfully.\n");
+	return true;
+}
+
+void RehaMove3::StopReconnectWatchdog(void)
+{
+	this->rmStatus.ReconnectThreatActive.Store(false);
+	if (this->ReconnectThread != 0){
+		// abort a running initialisation of the watchdog; it is started again for every attempt
+		while (this->rmStatus.ReconnectThreatRunning.Load() && this->rmStatus.Reconnecting.Load()){
+			this->rmStatus.InitThreatActive.Store(false);
+			usleep(1000); // 1ms
+		}
+		//wait for the reconnect watchdog threat to stop
+		pthread_join(this->ReconnectThread, NULL);
+		this->ReconnectThread = 0;
+	}
+}
+
+void RehaMove3::RunReconnectWatchdog(void)
+{
+	this->rmStatus.ReconnectThreatRunning.Store(true);
+	uint64_t LastSendErrors = this->Stats.SendErrors.Load();
+
+	while (this->rmStatus.ReconnectThreatActive.Load()){
+		RehaMove3::SleepFor_us(REHAMOVE_RECONNECT_THREAD_DELAY_US);
+		if (!this->rmStatus.DeviceInitialised.Load() || !RehaMove3::IsConnectionLost(&LastSendErrors)){
+			continue;
+		}
+		if (RehaMove3::Reconnect()){
+			LastSendErrors = this->Stats.SendErrors.Load();
+		}
+	}
+
+	// done
+	this->rmStatus.Reconnecting.Store(false);
+	this->rmStatus.ReconnectThreatRunning.Store(false);
+}
+
+bool RehaMove3::IsConnectionLost(uint64_t *LastSendErrors)
+{
+	// the interface was removed, e.g. the USB adapter was unplugged
+	if (access(this->DeviceFileName, R_OK | W_OK) == -1){
+		RehaMove3::printMessage(printMSG_warning, "%s Warning: The interface %s was removed! (time: %0.3f)\n", this->DeviceIDClass, this->DeviceFileName, RehaMove3::GetCurrentTime(true));
+		return true;
+	}
+	// new send errors or no acknowledgement for some time -> probe the device with a status request
+	uint64_t SendErrors = this->Stats.SendErrors.Load();
+	uint64_t TimeNow_us = RehaMove3::GetTimeStamp_us();
+	if ((SendErrors == *LastSendErrors) && (TimeNow_us < this->rmStatus.LastAckReceived_us.Load() + REHAMOVE_RECONNECT_SILENCE_MS *1000)){
+		return false;
+	}
+	*LastSendErrors = SendErrors;
+	pthread_mutex_lock(&(this->SendPackage_mutex));
+	bool RequestSend = smpt_send_get_battery_status(&(this->Device), RehaMove3::GetPackageNumber());
+	pthread_mutex_unlock(&(this->SendPackage_mutex));
+	if (RequestSend && RehaMove3::NewStatusUpdatesReceived(TimeNow_us, true, false, false, REHAMOVE_RECONNECT_PROBE_TIMEOUT_MS)){
+		return false;
+	}
+	RehaMove3::printMessage(printMSG_warning, "%s Warning: The device %s does not respond! (time: %0.3f)\n", this->DeviceIDClass, this->DeviceFileName, RehaMove3::GetCurrentTime(true));
+	return true;
+}
+
+bool RehaMove3::Reconnect(void)
+{
+	/*
+	 * The connection was lost -> close the interface and initialise the device again
+	 * -> the Send* functions return false meanwhile; IsReconnecting() returns true
+	 */
+	RehaMove3::printMessage(printMSG_warning, "%s Warning: The connection to the device was lost!\n     -> The device is opened and initialised again; the stimulation is paused meanwhile.\n", this->DeviceIDClass);
+	this->rmStatus.Reconnecting.Store(true);
+	this->rmStatus.DeviceInitialised.Store(false);
+	// the helper threats take the send lock -> stop them before the lock is held
+	RehaMove3::StopDeviceCheck();
+	RehaMove3::StopStatusPoller();
+	RehaMove3::StopMidLevelUpdateSender();
+	RehaMove3::StopMidLevelKeepAliveTimer();
+	// a running Send* call finishes before the interface is closed; the later calls see DeviceInitialised == false under the lock
+	pthread_mutex_lock(&(this->SendPackage_mutex));
+	RehaMove3::CloseSerial();
+	// closing fails, if the device was removed -> the file descriptor is invalid anyway
+	this->rmStatus.DeviceIsOpen.Store(false);
+
+	// the pending acknowledgements will never arrive
+	pthread_mutex_lock(&(this->ResponseQueueLock_mutex));
+	this->ResponseQueue.QueueTail = this->ResponseQueue.QueueHead;
+	pthread_mutex_unlock(&(this->ResponseQueueLock_mutex));
+	pthread_mutex_lock(&(this->LlSequenceQueueLock_mutex));
+	memset(&(this->LlSequenceQueue.Queue), 0, sizeof(this->LlSequenceQueue.Queue));
+	this->LlSequenceQueue.QueueTail = this->LlSequenceQueue.QueueHead;
+	this->LlSequenceQueue.QueueSize = 0;
+	pthread_mutex_unlock(&(this->LlSequenceQueueLock_mutex));
+	// the device starts without a stimulation -> the next MidLevel update is send in any case
+	this->rmStatus.DeviceLlIsInitialised.Store(false);
+	this->rmStatus.DeviceMlIsInitialised.Store(false);
+	this->rmStatus.HybridSequenceOffloaded.Store(false);
+	this->rmSettings.LowLevel.HybridStableSequences = 0;
+	memset(&(this->rmSettings.MidLevel.CurrentMlStimConfig), 0, sizeof(this->rmSettings.MidLevel.CurrentMlStimConfig));
+	this->Acks.G_ml_current_data_valid.Store(false);
+	pthread_mutex_unlock(&(this->SendPackage_mutex));
+	// the result of the first initialisation is not changed by the reconnects
+	this->rmInitResultExtern = &this->rmInitResult;
+
+	char DevicePath[PATH_MAX], LinkPath[PATH_MAX];
+	while (this->rmStatus.ReconnectThreatActive.Load()){
+		// follow the link, if the tty was renamed (e.g. /dev/ttyUSB0 -> /dev/ttyUSB1)
+		if ((this->DeviceLinkName[0] != 0) && (realpath(this->DeviceLinkName, LinkPath) != NULL) &&
+			((realpath(this->DeviceFileName, DevicePath) == NULL) || (strcmp(LinkPath, DevicePath) != 0))){
+			if (snprintf(this->DeviceFileName, sizeof(this->DeviceFileName), "%s", LinkPath) < (int)sizeof(this->DeviceFileName)){
+				RehaMove3::printMessage(printMSG_warning, "%s Warning: The device %s is available as %s now!\n", this->DeviceIDClass, this->DeviceLinkName, LinkPath);
+			} else {
+				// the path does not fit -> the link is used directly
+				snprintf(this->DeviceFileName, sizeof(this->DeviceFileName), "%s", this->DeviceLinkName);
+			}
+		}
+		// no link -> search the device by its serial number
+		if ((access(this->DeviceFileName, R_OK | W_OK) == -1) && (this->DeviceLinkName[0] == 0) && this->rmInitSettings.checkDeviceIDs){
+			RehaMove3::DiscoverDevice(this->rmInitSettings.RequestedDeviceID, REHAMOVE_DISCOVERY_TIMEOUT_MS);
+		}
+		if (access(this->DeviceFileName, R_OK | W_OK) != -1){
+			this->rmStatus.InitThreatActive.Store(true);
+			if (RehaMove3::InitialiseDevice()){
+				this->Stats.Reconnects.Add(1);
+				this->rmStatus.LastAckReceived_us.Store(RehaMove3::GetTimeStamp_us());
+				this->rmStatus.Reconnecting.Store(false);
+				RehaMove3::printMessage(printMSG_warning, "%s: The device %s was initialised again; the stimulation is resumed. (time: %0.3f)\n", this->DeviceIDClass, this->DeviceFileName, RehaMove3::GetCurrentTime(true));
+				return true;
+			}
+		}
+		// wait before the next attempt
+		uint64_t NextAttempt_us = RehaMove3::GetTimeStamp_us() + REHAMOVE_RECONNECT_RETRY_MS *1000;
+		while (this->rmStatus.ReconnectThreatActive.Load() && (RehaMove3::GetTimeStamp_us() < NextAttempt_us)){
+			RehaMove3::SleepFor_us(REHAMOVE_RECONNECT_THREAD_DELAY_US);
+		}
+	}
+	return false;
+}
+
+bool RehaMove3::DiscoverDevice(const char *DeviceID, uint32_t MilliSecondsToWait)
+{
+	/*
+	 * Collect the candidates -> the interfaces of the vendor; all ttyUSB/ttyACM interfaces, if no interface of the vendor is listed
+	 * -> one discovery at a time, so the probes of two instances do not open the same interface
+	 */
+	rmDiscoveryProbe_t Probes[REHAMOVE_DISCOVERY_MAX_INTERFACES];
+	memset(Probes, 0, sizeof(Probes));
+	pthread_mutex_lock(&DiscoveryLock_mutex);
+	uint8_t NumberOfProbes = RehaMove3::CollectDiscoveryCandidates(Probes, REHAMOVE_SERIAL_LINK_DIR, REHAMOVE_DISCOVERY_VENDOR_NAME, MilliSecondsToWait);
+	if (NumberOfProbes == 0){
+		RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: No interface of the vendor '%s' is listed in %s -> all interfaces are probed.\n", REHAMOVE_DISCOVERY_VENDOR_NAME, REHAMOVE_SERIAL_LINK_DIR);
+		NumberOfProbes = RehaMove3::CollectDiscoveryCandidates(Probes, "/dev", NULL, MilliSecondsToWait);
+	}
+
+	/*
+	 * Probe all candidates at the same time -> the discovery takes one timeout at most
+	 */
+	for (uint8_t i = 0; i < NumberOfProbes; i++){
+		int ReturnValue = pthread_create(&(Probes[i].Thread), NULL, DiscoveryThreadFunc, (void *)&Probes[i]);
+		Probes[i].ThreadStarted = (ReturnValue == 0);
+		if (!Probes[i].ThreadStarted){
+			RehaMove3::printMessage(printMSG_warning, "%s Warning: The interface %s could not be probed:\n     -> %s (%d)\n", this->DeviceIDClass, Probes[i].DevicePath, strerror(ReturnValue), ReturnValue);
+		}
+	}
+	bool DeviceFound = false;
+	for (uint8_t i = 0; i < NumberOfProbes; i++){
+		if (!Probes[i].ThreadStarted){
+			continue;
+		}
+		pthread_join(Probes[i].Thread, NULL);
+		if (!Probes[i].DeviceIdReceived){
+			continue;
+		}
+		RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: The device '%s' was found on %s.\n", Probes[i].DeviceID, Probes[i].DevicePath);
+		if (!DeviceFound && (strcmp(Probes[i].DeviceID, DeviceID) == 0)){
+			snprintf(this->DeviceFileName, sizeof(this->DeviceFileName), "%s", Probes[i].DevicePath);
+			DeviceFound = true;
+		}
+	}
+	pthread_mutex_unlock(&DiscoveryLock_mutex);
+	if (DeviceFound){
+		RehaMove3::printMessage(printMSG_rmInitInfo, "%s: The device '%s' was found on %s (%u interfaces probed).\n", this->DeviceIDClass, DeviceID, this->DeviceFileName, (unsigned int)NumberOfProbes);
+	}
+	return DeviceFound;
+}
+
+uint8_t RehaMove3::CollectDiscoveryCandidates(rmDiscoveryProbe_t *Probes, const char *DirectoryName, const char *VendorName, uint32_t MilliSecondsToWait)
+{
+	// VendorName == NULL -> the ttyUSB/ttyACM interfaces of the directory; otherwise the links, which contain the vendor name
+	DIR *Directory = opendir(DirectoryName);
+	if (Directory == NULL){
+		return 0;
+	}
+	uint8_t NumberOfProbes = 0;
+	char EntryPath[PATH_MAX], DevicePath[PATH_MAX];
+	struct dirent *Entry;
+	while (((Entry = readdir(Directory)) != NULL) && (NumberOfProbes < REHAMOVE_DISCOVERY_MAX_INTERFACES)){
+		if (VendorName == NULL){
+			if ((strncmp(Entry->d_name, "ttyUSB", 6) != 0) && (strncmp(Entry->d_name, "ttyACM", 6) != 0)){
+				continue;
+			}
+		} else if ((Entry->d_name[0] == '.') || (strcasestr(Entry->d_name, VendorName) == NULL)){
+			continue;
+		}
+		snprintf(EntryPath, sizeof(EntryPath), "%s/%s", DirectoryName, Entry->d_name);
+		if (realpath(EntryPath, DevicePath) == NULL){
+			continue;
+		}
+		// the interfaces opened by other instances (e.g. a second stimulator) are locked -> skipped by the probe
+		if (access(DevicePath, R_OK | W_OK) == -1){
+			continue;
+		}
+		bool IsListed = false;
+		for (uint8_t i = 0; i < NumberOfProbes; i++){
+			if (strcmp(Probes[i].DevicePath, DevicePath) == 0){
+				IsListed = true;
+			}
+		}
+		if (IsListed){
+			continue;
+		}
+		rmDiscoveryProbe_t *Probe = &Probes[NumberOfProbes];
+		if (snprintf(Probe->DevicePath, sizeof(Probe->DevicePath), "%s", DevicePath) >= (int)sizeof(Probe->DevicePath)){
+			continue;
+		}
+		Probe->Device = this;
+		Probe->MilliSecondsToWait = MilliSecondsToWait;
+		NumberOfProbes++;
+	}
+	closedir(Directory);
+	return NumberOfProbes;
+}
+
+void RehaMove3::RunDiscoveryProbe(rmDiscoveryProbe_t *Probe)
+{
+	/*
+	 * Skip busy interfaces -> opened exclusively (TIOCEXCL -> EBUSY) or locked by another process (a device or a probe of this library)
+	 */
+	int LockFile = open(Probe->DevicePath, O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (LockFile < 0){
+		return;
+	}
+	if (flock(LockFile, LOCK_EX | LOCK_NB) != 0){
+		RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: The interface %s is busy and is not probed.\n", Probe->DevicePath);
+		close(LockFile);
+		return;
+	}
+	Smpt_device ProbeDevice;
+	memset(&ProbeDevice, 0, sizeof(ProbeDevice));
+	if (!smpt_open_serial_port(&ProbeDevice, Probe->DevicePath)){
+		flock(LockFile, LOCK_UN);
+		close(LockFile);
+		return;
+	}
+	if (smpt_send_get_device_id(&ProbeDevice, 0)){
+		uint64_t Deadline_ns = RehaMove3::GetTimeStamp_ns() + (uint64_t)Probe->MilliSecondsToWait *1000000;
+		Smpt_ack Ack;
+		Smpt_get_device_id_ack DeviceIdAck;
+		while (RehaMove3::GetTimeStamp_ns() < Deadline_ns){
+			if (!smpt_new_packet_received(&ProbeDevice)){
+				RehaMove3::SleepFor_us(REHAMOVE_ACK_THREAD_DELAY_US);
+				continue;
+			}
+			smpt_clear_ack(&Ack);
+			smpt_last_ack(&ProbeDevice, &Ack);
+			if (Ack.command_number == Smpt_Cmd_Get_Device_Id_Ack){
+				smpt_clear_get_device_id_ack(&DeviceIdAck);
+				smpt_get_get_device_id_ack(&ProbeDevice, &DeviceIdAck);
+				memcpy(Probe->DeviceID, DeviceIdAck.device_id, (size_t)Smpt_Length_Device_Id);
+				Probe->DeviceID[Smpt_Length_Device_Id] = 0x00;
+				Probe->DeviceIdReceived = true;
+				break;
+			}
+		}
+	}
+	smpt_close_serial_port(&ProbeDevice);
+	flock(LockFile, LOCK_UN);
+	close(LockFile);
+}
+
+void RehaMove3::FindSerialLink(void)
+{
+	/*
+	 * Search the link of the interface in /dev/serial/by-id -> the name of the link contains the serial number of the USB adapter,
+	 * so it stays the same if the tty gets a new name after a reconnect
+	 */
+	memset(this->DeviceLinkName, 0, sizeof(this->DeviceLinkName));
+	char DevicePath[PATH_MAX], LinkPath[PATH_MAX], LinkName[PATH_MAX];
+	if (realpath(this->DeviceFileName, DevicePath) == NULL){
+		return;
+	}
+	DIR *Directory = opendir(REHAMOVE_SERIAL_LINK_DIR);
+	if (Directory == NULL){
+		return;
+	}
+	struct dirent *Entry;
+	while ((Entry = readdir(Directory)) != NULL){
+		if (Entry->d_name[0] == '.'){
+			continue;
+		}
+		snprintf(LinkName, sizeof(LinkName), "%s/%s", REHAMOVE_SERIAL_LINK_DIR, Entry->d_name);
+		if ((realpath(LinkName, LinkPath) != NULL) && (strcmp(LinkPath, DevicePath) == 0)){
+			if (snprintf(this->DeviceLinkName, sizeof(this->DeviceLinkName), "%s", LinkName) >= (int)sizeof(this->DeviceLinkName)){
+				this->DeviceLinkName[0] = 0;
+				break;
+			}
+			RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: The interface %s is linked as %s.\n", this->DeviceFileName, this->DeviceLinkName);
+			break;
+		}
+	}
+	closedir(Directory);
+}
+
+bool RehaMove3::StartMidLevelKeepAliveTimer(void)
+{
+	if (this->rmStatus.KeepAliveThreatActive.Load()){
+		return true;
+	}
+	this->rmSettings.MidLevel.KeepAliveAckLatency_us.Store(0);
+	this->rmStatus.KeepAliveThreatActive.Store(true);
+	int ReturnValue = pthread_create(&(this->KeepAliveThread), NULL, KeepAliveThreadFunc, (void *)this);
+	if (ReturnValue != 0) {
+		this->rmStatus.KeepAliveThreatActive.Store(false);
+		RehaMove3::printMessage(printMSG_error, "%s Error: The keep alive threat could not be started:\n     -> %s (%d)\n     -> The keep alive signal is send during the periodic update calls.\n", this->DeviceIDClass, strerror(ReturnValue), ReturnValue);
+		return false;
+	}
+	RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: Starting the keep alive threat was successfully.\n");
+	return true;
+}
+
+void RehaMove3::StopMidLevelKeepAliveTimer(void)
+{
+	this->rmStatus.KeepAliveThreatActive.Store(false);
+	if (this->KeepAliveThread != 0){
+		//wait for the keep alive threat to stop
+		pthread_join(this->KeepAliveThread, NULL);
+		this->KeepAliveThread = 0;
+	}
+}
+
+bool RehaMove3::StartMidLevelUpdateSender(void)
+{
+	if (this->rmStatus.MlUpdateThreatActive.Load()){
+		return true;
+	}
+	this->rmSettings.MidLevel.MailboxFull.Store(false);
+	this->rmStatus.MlUpdateThreatActive.Store(true);
+	int ReturnValue = pthread_create(&(this->MlUpdateThread), NULL, MlUpdateThreadFunc, (void *)this);
+	if (ReturnValue != 0) {
+		this->rmStatus.MlUpdateThreatActive.Store(false);
+		RehaMove3::printMessage(printMSG_error, "%s Error: The update threat could not be started:\n     -> %s (%d)\n     -> The updates are send directly.\n", this->DeviceIDClass, strerror(ReturnValue), ReturnValue);
+		return false;
+	}
+	RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: Starting the update threat was successfully.\n");
+	return true;
+}
+
+void RehaMove3::StopMidLevelUpdateSender(void)
+{
+	this->rmStatus.MlUpdateThreatActive.Store(false);
+	if (this->MlUpdateThread != 0){
+		//wait for the update threat to stop
+		pthread_join(this->MlUpdateThread, NULL);
+		this->MlUpdateThread = 0;
+	}
+}
+
+bool RehaMove3::StartStatusPoller(void)
+{
+	if (this->rmStatus.StatusPollThreatActive.Load()){
+		return true;
+	}
+	this->rmStatus.StatusPollThreatActive.Store(true);
+	int ReturnValue = pthread_create(&(this->StatusPollThread), NULL, StatusPollThreadFunc, (void *)this);
+	if (ReturnValue != 0) {
+		this->rmStatus.StatusPollThreatActive.Store(false);
+		RehaMove3::printMessage(printMSG_error, "%s Error: The status threat could not be started:\n     -> %s (%d)\n", this->DeviceIDClass, strerror(ReturnValue), ReturnValue);
+		return false;
+	}
+	RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: Starting the status threat was successfully.\n");
+	return true;
+}
+
+void RehaMove3::StopStatusPoller(void)
+{
+	this->rmStatus.StatusPollThreatActive.Store(false);
+	if (this->StatusPollThread != 0){
+		//wait for the status threat to stop
+		pthread_join(this->StatusPollThread, NULL);
+		this->StatusPollThread = 0;
+	}
+}
+
+void RehaMove3::RunStatusPoller(void)
+{
+	this->rmStatus.StatusPollThreatRunning.Store(true);
+	uint64_t TimeNow_us = 0, NextPoll_us = 0;
+	uint64_t Period_us = (uint64_t)(this->rmInitSettings.StimConfig.StatusPollPeriod_ms *1000.0);
+
+	while (this->rmStatus.StatusPollThreatActive.Load()){
+		TimeNow_us = RehaMove3::GetTimeStamp_us();
+		if (TimeNow_us >= NextPoll_us){
+			// no requests while the device is not initialised, e.g. during a reconnect
+			if (this->rmStatus.DeviceInitialised.Load()){
+				// request the status -> the responses are handled by the receiver, which updates the status snapshot
+				uint64_t SendErrors = 0;
+				pthread_mutex_lock(&(this->SendPackage_mutex));
+				if (!smpt_send_get_stim_status(&(this->Device), RehaMove3::GetPackageNumber())){
+					SendErrors++;
+				}
+				if (!smpt_send_get_main_status(&(this->Device), RehaMove3::GetPackageNumber())){
+					SendErrors++;
+				}
+				if (!smpt_send_get_battery_status(&(this->Device), RehaMove3::GetPackageNumber())){
+					SendErrors++;
+				}
+				pthread_mutex_unlock(&(this->SendPackage_mutex));
+				if (SendErrors > 0){
+					this->Stats.SendErrors.Add(SendErrors);
+				}
+			}
+			NextPoll_us = TimeNow_us + Period_us;
+		}
+		RehaMove3::SleepFor_us(REHAMOVE_STATUSPOLL_THREAD_DELAY_US);
+	}
+
+	// done
+	this->rmStatus.StatusPollThreatRunning.Store(false);
+}
+
+bool RehaMove3::StartStatisticsExporter(void)
+{
+	if (this->rmStatus.StatsExportThreatActive.Load()){
+		return true;
+	}
+	this->rmStatus.StatsExportThreatActive.Store(true);
+	int ReturnValue = pthread_create(&(this->StatsExportThread), NULL, StatsExportThreadFunc, (void *)this);
+	if (ReturnValue != 0) {
+		this->rmStatus.StatsExportThreatActive.Store(false);
+		RehaMove3::printMessage(printMSG_error, "%s Error: The statistics export threat could not be started:\n     -> %s (%d)\n", this->DeviceIDClass, strerror(ReturnValue), ReturnValue);
+		return false;
+	}
+	RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: Starting the statistics export threat was successfully.\n");
+	return true;
+}
+
+void RehaMove3::StopStatisticsExporter(void)
+{
+	this->rmStatus.StatsExportThreatActive.Store(false);
+	if (this->StatsExportThread != 0){
+		//wait for the export threat to stop
+		pthread_join(this->StatsExportThread, NULL);
+		this->StatsExportThread = 0;
+	}
+}
+
+void RehaMove3::RunStatisticsExporter(void)
+{
+	this->rmStatus.StatsExportThreatRunning.Store(true);
+	uint64_t TimeNow_us = 0, NextExport_us = 0;
+	uint64_t Period_us = (uint64_t)(this->rmInitSettings.DebugConfig.StatsExportPeriod_ms *1000.0);
+
+	while (this->rmStatus.StatsExportThreatActive.Load()){
+		TimeNow_us = RehaMove3::GetTimeStamp_us();
+		if (TimeNow_us >= NextExport_us){
+			RehaMove3::WriteStatisticsFile(this->rmInitSettings.DebugConfig.StatsExportFile);
+			NextExport_us = TimeNow_us + Period_us;
+		}
+		RehaMove3::SleepFor_us(REHAMOVE_STATSEXPORT_THREAD_DELAY_US);
+	}
+	// write the final values
+	RehaMove3::WriteStatisticsFile(this->rmInitSettings.DebugConfig.StatsExportFile);
+
+	// done
+	this->rmStatus.StatsExportThreatRunning.Store(false);
+}
+
+bool RehaMove3::StartTelemetryPublisher(void)
+{
+	if (this->rmStatus.TelemetryThreatActive.Load()){
+		return true;
+	}
+	/*
+	 * Create the shared memory segment -> /dev/shm/<name>; the layout is defined in RehaMove3Telemetry.hpp
+	 */
+	char SegmentFileName[100];
+	if ((strchr(this->rmInitSettings.DebugConfig.TelemetrySegmentName, '/') != NULL) ||
+		(snprintf(SegmentFileName, sizeof(SegmentFileName), "/dev/shm/%s", this->rmInitSettings.DebugConfig.TelemetrySegmentName) >= (int)sizeof(SegmentFileName))){
+		RehaMove3::printMessage(printMSG_error, "%s Error: The telemetry segment name '%s' is invalid!\n", this->DeviceIDClass, this->rmInitSettings.DebugConfig.TelemetrySegmentName);
+		return false;
+	}
+	this->TelemetryFile = open(SegmentFileName, O_RDWR | O_CREAT, 0644);
+	if (this->TelemetryFile < 0){
+		RehaMove3::printMessage(printMSG_error, "%s Error: The telemetry segment %s could not be opened:\n     -> %s (%d)\n", this->DeviceIDClass, SegmentFileName, strerror(errno), errno);
+		return false;
+	}
+	if (ftruncate(this->TelemetryFile, sizeof(rmTelemetrySegment_t)) != 0){
+		RehaMove3::printMessage(printMSG_error, "%s Error: The size of the telemetry segment %s could not be set:\n     -> %s (%d)\n", this->DeviceIDClass, SegmentFileName, strerror(errno), errno);
+		close(this->TelemetryFile);
+		this->TelemetryFile = -1;
+		return false;
+	}
+	void *Segment = mmap(NULL, sizeof(rmTelemetrySegment_t), PROT_READ | PROT_WRITE, MAP_SHARED, this->TelemetryFile, 0);
+	if (Segment == MAP_FAILED){
+		RehaMove3::printMessage(printMSG_error, "%s Error: The telemetry segment %s could not be mapped:\n     -> %s (%d)\n", this->DeviceIDClass, SegmentFileName, strerror(errno), errno);
+		close(this->TelemetryFile);
+		this->TelemetryFile = -1;
+		return false;
+	}
+	this->TelemetrySegment = (rmTelemetrySegment_t *)Segment;
+
+	// header -> the magic number is written last, so the readers never see a half initialised segment
+	__atomic_store_n(&this->TelemetrySegment->Magic, 0, __ATOMIC_RELEASE);
+	memset(((uint8_t *)this->TelemetrySegment) +sizeof(uint32_t), 0, sizeof(rmTelemetrySegment_t) -sizeof(uint32_t));
+	this->TelemetrySegment->Version = REHAMOVE_TELEMETRY_VERSION;
+	this->TelemetrySegment->Size 	= sizeof(rmTelemetrySegment_t);
+	this->TelemetrySegment->WriterPid = (int32_t)getpid();
+	this->TelemetrySegment->UpdatePeriod_us = (uint32_t)(this->rmInitSettings.DebugConfig.TelemetryPeriod_ms *1000.0);
+	snprintf(this->TelemetrySegment->DeviceID, sizeof(this->TelemetrySegment->DeviceID), "%s", this->DeviceIDClass);
+	snprintf(this->TelemetrySegment->DeviceFile, sizeof(this->TelemetrySegment->DeviceFile), "%s", this->DeviceFileName);
+	RehaMove3::PublishTelemetry();
+	__atomic_store_n(&this->TelemetrySegment->Magic, (uint32_t)REHAMOVE_TELEMETRY_MAGIC, __ATOMIC_RELEASE);
+
+	this->rmStatus.TelemetryThreatActive.Store(true);
+	int ReturnValue = pthread_create(&(this->TelemetryThread), NULL, TelemetryThreadFunc, (void *)this);
+	if (ReturnValue != 0) {
+		this->rmStatus.TelemetryThreatActive.Store(false);
+		RehaMove3::printMessage(printMSG_error, "%s Error: The telemetry threat could not be started:\n     -> %s (%d)\n", this->DeviceIDClass, strerror(ReturnValue), ReturnValue);
+		munmap(this->TelemetrySegment, sizeof(rmTelemetrySegment_t));
+		this->TelemetrySegment = NULL;
+		close(this->TelemetryFile);
+		this->TelemetryFile = -1;
+		return false;
+	}
+	RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: Starting the telemetry threat was successfully (%s).\n", SegmentFileName);
+	return true;
+}
+
+void RehaMove3::StopTelemetryPublisher(void)
+{
+	this->rmStatus.TelemetryThreatActive.Store(false);
+	if (this->TelemetryThread != 0){
+		//wait for the telemetry threat to stop
+		pthread_join(this->TelemetryThread, NULL);
+		this->TelemetryThread = 0;
+	}
+	// the segment itself is kept, so the monitors can see the last state
+	if (this->TelemetrySegment != NULL){
+		munmap(this->TelemetrySegment, sizeof(rmTelemetrySegment_t));
+		this->TelemetrySegment = NULL;
+	}
+	if (this->TelemetryFile >= 0){
+		close(this->TelemetryFile);
+		this->TelemetryFile = -1;
+	}
+}
+
+void RehaMove3::RunTelemetryPublisher(void)
+{
+	this->rmStatus.TelemetryThreatRunning.Store(true);
+	uint64_t TimeNow_us = 0, NextUpdate_us = 0;
+	uint64_t Period_us = (uint64_t)(this->rmInitSettings.DebugConfig.TelemetryPeriod_ms *1000.0);
+
+	while (this->rmStatus.TelemetryThreatActive.Load()){
+		TimeNow_us = RehaMove3::GetTimeStamp_us();
+		if (TimeNow_us >= NextUpdate_us){
+			RehaMove3::PublishTelemetry();
+			NextUpdate_us = TimeNow_us + Period_us;
+		}
+		RehaMove3::SleepFor_us(REHAMOVE_TELEMETRY_THREAD_DELAY_US);
+	}
+	// write the final values
+	RehaMove3::PublishTelemetry();
+
+	// done
+	this->rmStatus.TelemetryThreatRunning.Store(false);
+}
+
+void RehaMove3::PublishTelemetry(void)
+{
+	/*
+	 * Copy the current state into the shared memory segment
+	 * -> called by the telemetry threat only (one writer); no lock is taken, the queue depths are read without the queue locks and are approximate
+	 */
+	rmTelemetrySegment_t *Segment = this->TelemetrySegment;
+	if (Segment == NULL){
+		return;
+	}
+	rmStatistics_t Stat = RehaMove3::GetStatistics();
+	uint8_t ResponseHead = __atomic_load_n(&this->ResponseQueue.QueueHead, __ATOMIC_RELAXED);
+	uint8_t ResponseTail = __atomic_load_n(&this->ResponseQueue.QueueTail, __ATOMIC_RELAXED);
+	// device status -> consistent copy of the values written by the receiver
+	rmStatus_t::rmStatusSnapshot_t Snapshot;
+	uint32_t SnapshotStart;
+	do {
+		SnapshotStart = this->rmStatus.SnapshotLock.ReadBegin();
+		memcpy(&Snapshot, &this->rmStatus.Snapshot, sizeof(Snapshot));
+	} while (this->rmStatus.SnapshotLock.ReadRetry(SnapshotStart));
+
+	// odd -> the readers retry
+	uint32_t Sequence = Segment->Sequence;
+	__atomic_store_n(&Segment->Sequence, Sequence +1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	Segment->UpdateCounter++;
+	Segment->UpdateTime_us 			 = RehaMove3::GetTimeStamp_us();
+	// status
+	Segment->Protocol 				 = this->rmSettings.CommProtocol;
+	Segment->DeviceIsOpen 			 = this->rmStatus.DeviceIsOpen.Load();
+	Segment->DeviceInitialised 		 = this->rmStatus.DeviceInitialised.Load();
+	Segment->DeviceLlIsInitialised 	 = this->rmStatus.DeviceLlIsInitialised.Load();
+	Segment->DeviceMlIsInitialised 	 = this->rmStatus.DeviceMlIsInitialised.Load();
+	Segment->DoNotStimulate 		 = this->rmStatus.DoNotStimulate.Load();
+	Segment->HybridSequenceOffloaded = this->rmStatus.HybridSequenceOffloaded.Load();
+	Segment->MlStimActive 			 = this->Acks.G_ml_StimActive.Load();
+	Segment->MlStimError 			 = this->Acks.G_ml_StimError.Load();
+	Segment->BatteryLevel 			 = Snapshot.BatteryLevel;
+	Segment->BatteryVoltage 		 = Snapshot.BatteryVoltage;
+	Segment->HighVoltageVoltage 	 = Snapshot.HighVoltageVoltage;
+	Segment->MainStatus 			 = Snapshot.MainStatus;
+	Segment->StimStatus 			 = Snapshot.StimStatus;
+	Segment->NumberOfStimErrors 	 = this->rmStatus.NumberOfStimErrors.Load();
+	// queue depths
+	Segment->ResponseQueueDepth 	 = (ResponseHead >= ResponseTail) ? (ResponseHead - ResponseTail) : (REHAMOVE_RESPONSE_QUEUE_SIZE - ResponseTail + ResponseHead);
+	Segment->LlSequenceQueueDepth 	 = __atomic_load_n(&this->LlSequenceQueue.QueueSize, __ATOMIC_RELAXED);
+	Segment->MlUpdateMailboxFull 	 = this->rmSettings.MidLevel.MailboxFull.Load();
+	// acknowledgement latencies
+	Segment->LlAckLatencyLast_us 	 = this->rmStatus.LlAckLatencyLast_us.Load();
+	Segment->LlAckLatencyMax_us 	 = this->rmStatus.LlAckLatencyMax_us.Load();
+	Segment->MlUpdateAckLatencyLast_us = this->rmStatus.MlUpdateAckLatencyLast_us.Load();
+	Segment->KeepAliveAckLatency_us  = this->rmSettings.MidLevel.KeepAliveAckLatency_us.Load();
+	// statistics
+	Segment->InvalidInput 					 = Stat.InvalidInput;
+	Segment->InputCorrections_PulswidthOver  = Stat.InputCorrections_PulswidthOver;
+	Segment->InputCorrections_PulswidthUnder = Stat.InputCorrections_PulswidthUnder;
+	Segment->InputCorrections_CurrentOver 	 = Stat.InputCorrections_CurrentOver;
+	Segment->InputCorrections_CurrentUnder 	 = Stat.InputCorrections_CurrentUnder;
+	Segment->SequencesSend 					 = Stat.SequencesSend;
+	Segment->SequencesSuccessful 			 = Stat.SequencesSuccessful;
+	Segment->SequencesFailed 				 = Stat.SequencesFailed;
+	Segment->SequencesFailed_StimError 		 = Stat.SequencesFailed_StimError;
+	Segment->StimultionPulsesSend 			 = Stat.StimultionPulsesSend;
+	Segment->StimultionPulsesNotSend 		 = Stat.StimultionPulsesNotSend;
+	Segment->StimultionPulsesSuccessful 	 = Stat.StimultionPulsesSuccessful;
+	Segment->StimultionPulsesFailed 		 = Stat.StimultionPulsesFailed;
+	Segment->StimultionPulsesFailed_StimError = Stat.StimultionPulsesFailed_StimError;
+	Segment->HybridSequencesOffloaded 		 = Stat.HybridSequencesOffloaded;
+	Segment->HybridOffloads 				 = Stat.HybridOffloads;
+	Segment->HybridFallbacks 				 = Stat.HybridFallbacks;
+	Segment->UpdatesSend 					 = Stat.UpdatesSend;
+	Segment->UpdatesFailed_StimError 		 = Stat.UpdatesFailed_StimError;
+	Segment->UpdatesPosted 					 = Stat.UpdatesPosted;
+	Segment->UpdatesTaken 					 = Stat.UpdatesTaken;
+	for (uint8_t iCh=0; iCh<REHAMOVE_TELEMETRY_NUMBER_OF_CHANNELS; iCh++){
+		Segment->Channel[iCh].PulsesSend 			 = Stat.Channel[iCh].PulsesSend;
+		Segment->Channel[iCh].PulsesNotSend 		 = Stat.Channel[iCh].PulsesNotSend;
+		Segment->Channel[iCh].PulsesSuccessful 		 = Stat.Channel[iCh].PulsesSuccessful;
+		Segment->Channel[iCh].PulsesFailed_StimError = Stat.Channel[iCh].PulsesFailed_StimError;
+		Segment->Channel[iCh].UpdatesActive 		 = Stat.Channel[iCh].UpdatesActive;
+	}
+
+	// even -> the update is done
+	__atomic_store_n(&Segment->Sequence, Sequence +2, __ATOMIC_RELEASE);
+}
+
+int RehaMove3::CreateRealTimeThread(pthread_t *Thread, void *(*ThreadFunction)(void *), const char *Name)
+{
+	/*
+	 * Create the receiver or init threat with the scheduling policy, priority and CPU affinity of the settings
+	 * -> if the attributes are not allowed (e.g. no root), the threat is created with the default attributes
+	 * -> returns the error code of pthread_create (0 = success)
+	 */
+	rmStimSettings_t *Config = &this->rmInitSettings.StimConfig;
+	int ReturnValue = RehaMove3::CreateThreadWithAttributes(Thread, ThreadFunction, (void *)this, Config->ThreadSchedPolicy, Config->ThreadSchedPriority, Config->ThreadCpuAffinity);
+	if (ReturnValue != 0){
+		RehaMove3::printMessage(printMSG_warning, "%s Warning: The %s threat could not be started with the scheduling policy %d (priority %d) and the CPU mask 0x%lx:\n     -> %s (%d)\n     -> Using the default attributes instead.\n",
+				this->DeviceIDClass, Name, Config->ThreadSchedPolicy, Config->ThreadSchedPriority, (unsigned long)Config->ThreadCpuAffinity, strerror(ReturnValue), ReturnValue);
+		ReturnValue = pthread_create(Thread, NULL, ThreadFunction, (void *)this);
+	}
+	return ReturnValue;
+}
+
+int RehaMove3::CreateThreadWithAttributes(pthread_t *Thread, void *(*ThreadFunction)(void *), void *Argument, int SchedPolicy, int SchedPriority, uint64_t CpuAffinity)
+{
+	if ((SchedPolicy == SCHED_OTHER) && (CpuAffinity == 0)){
+		return pthread_create(Thread, NULL, ThreadFunction, Argument);
+	}
+	pthread_attr_t Attributes;
+	pthread_attr_init(&Attributes);
+	if (SchedPolicy != SCHED_OTHER){
+		struct sched_param Parameter;
+		memset(&Parameter, 0, sizeof(Parameter));
+		Parameter.sched_priority = SchedPriority;
+		pthread_attr_setinheritsched(&Attributes, PTHREAD_EXPLICIT_SCHED);
+		pthread_attr_setschedpolicy(&Attributes, SchedPolicy);
+		pthread_attr_setschedparam(&Attributes, &Parameter);
+	}
+	if (CpuAffinity != 0){
+		cpu_set_t CpuSet;
+		CPU_ZERO(&CpuSet);
+		for (uint8_t iCpu=0; iCpu<64; iCpu++){
+			if (CpuAffinity & (((uint64_t)1) << iCpu)){
+				CPU_SET(iCpu, &CpuSet);
+			}
+		}
+		pthread_attr_setaffinity_np(&Attributes, sizeof(CpuSet), &CpuSet);
+	}
+	int ReturnValue = pthread_create(Thread, &Attributes, ThreadFunction, Argument);
+	pthread_attr_destroy(&Attributes);
+	return ReturnValue;
+}
+
+void RehaMove3::PrefaultStack(void)
+{
+	// touch the stack once, so the pages are mapped before the stimulation starts (and locked, if the host uses mlockall())
+	uint8_t Stack[REHAMOVE_STACK_PREFAULT_SIZE];
+	memset(Stack, 0, sizeof(Stack));
+	// the compiler must not remove the memset
+	__asm__ __volatile__("" : : "r"(Stack) : "memory");
+}
+
+bool RehaMove3::StartLogger(void)
+{
+	if (this->rmStatus.LoggerThreatActive.Load()){
+		return true;
+	}
+	this->rmStatus.LoggerThreatActive.Store(true);
+	int ReturnValue = pthread_create(&(this->LoggerThread), NULL, LoggerThreadFunc, (void *)this);
+	if (ReturnValue != 0) {
+		this->rmStatus.LoggerThreatActive.Store(false);
+		this->LoggerThread = 0;
+		RehaMove3::printMessage(printMSG_error, "%s Error: The logger threat could not be started; the messages are printed directly:\n     -> %s (%d)\n", this->DeviceIDClass, strerror(ReturnValue), ReturnValue);
+		return false;
+	}
+	return true;
+}
+
+void RehaMove3::StopLogger(void)
+{
+	this->rmStatus.LoggerThreatActive.Store(false);
+	sem_post(&this->LogQueue.NewMessages);
+	if (this->LoggerThread != 0){
+		//wait for the logger threat to stop
+		pthread_join(this->LoggerThread, NULL);
+		this->LoggerThread = 0;
+	}
+	// messages put into the queue while the threat stopped
+	RehaMove3::PrintLogMessages();
+}
+
+void RehaMove3::RunLogger(void)
+{
+	this->rmStatus.LoggerThreatRunning.Store(true);
+
+	while (this->rmStatus.LoggerThreatActive.Load()){
+		// sleep until a message or record is queued (or the threat is stopped)
+		if ((sem_wait(&this->LogQueue.NewMessages) != 0) && (errno != EINTR)){
+			usleep(REHAMOVE_LOGGER_THREAD_DELAY_US);
+		}
+		// the queues are emptied at once -> drop the wake ups of the messages printed now
+		while (sem_trywait(&this->LogQueue.NewMessages) == 0){}
+		RehaMove3::PrintLogMessages();
+		RehaMove3::WriteBinaryLogRecords();
+	}
+	RehaMove3::PrintLogMessages();
+	RehaMove3::WriteBinaryLogRecords();
+
+	// done
+	this->rmStatus.LoggerThreatRunning.Store(false);
+}
+
+bool RehaMove3::PutLogMessage(uint8_t Style, bool DoWait, const char *format, va_list args)
+{
+	/*
+	 * Put a message into the log queue (bounded, lock free; any number of writers, one reader)
+	 * -> the writer claims a free slot by increasing 'Head' and marks the message as ready via the sequence number of the slot
+	 * -> full queue: the message is dropped and counted, unless DoWait is set
+	 */
+	if (!this->rmStatus.LoggerThreatRunning.Load()){
+		char Text[REHAMOVE_LOG_MESSAGE_SIZE];
+		vsnprintf(Text, sizeof(Text), format, args);
+		RehaMove3::WriteLogMessage(Style, Text);
+		return true;
+	}
+	LogQueue_t::LogMessage_t *Message = NULL;
+	uint64_t Position = this->LogQueue.Head.Load();
+	while (true){
+		Message = &this->LogQueue.Queue[Position & (REHAMOVE_LOG_QUEUE_SIZE -1)];
+		uint64_t Sequence = Message->Sequence.Load();
+		if (Sequence == Position){
+			// the slot is free -> claim it; otherwise Position is updated and we try again
+			if (this->LogQueue.Head.CompareExchange(Position, Position +1)){
+				break;
+			}
+		} else if (Sequence < Position){
+			// the queue is full
+			if ((!DoWait) || (!this->rmStatus.LoggerThreatRunning.Load())){
+				this->LogQueue.Dropped.Add(1);
+				return false;
+			}
+			usleep(REHAMOVE_LOGGER_THREAD_DELAY_US);
+			Position = this->LogQueue.Head.Load();
+		} else {
+			// the slot was claimed by another thread
+			Position = this->LogQueue.Head.Load();
+		}
+	}
+	if (vsnprintf(Message->Text, sizeof(Message->Text), format, args) >= (int)sizeof(Message->Text)){
+		snprintf(&Message->Text[sizeof(Message->Text) -5], 5, "...\n");
+	}
+	Message->Style = Style;
+	Message->Sequence.Store(Position +1);
+	sem_post(&this->LogQueue.NewMessages);
+	return true;
+}
+
+bool RehaMove3::PrintLogMessages(void)
+{
+	// called by the logger threat, or after it was stopped -> one reader
+	bool MessagesPrinted = false;
+	uint64_t Position = this->LogQueue.Tail.Load();
+	while (true){
+		LogQueue_t::LogMessage_t *Message = &this->LogQueue.Queue[Position & (REHAMOVE_LOG_QUEUE_SIZE -1)];
+		if (Message->Sequence.Load() != (Position +1)){
+			break;
+		}
+		RehaMove3::WriteLogMessage(Message->Style, Message->Text);
+		// free the slot for the next round
+		Message->Sequence.Store(Position + REHAMOVE_LOG_QUEUE_SIZE);
+		Position++;
+		this->LogQueue.Tail.Store(Position);
+		MessagesPrinted = true;
+	}
+	if (MessagesPrinted){
+		fflush(stdout);
+	}
+	return MessagesPrinted;
+}
+
+void RehaMove3::FlushLogMessages(void)
+{
+	// wait (max. 1s) until the logger threat printed the queued messages -> used before printing directly to the terminal
+	for (uint16_t i=0; (i < 1000) && this->rmStatus.LoggerThreatRunning.Load(); i++){
+		if (this->LogQueue.Tail.Load() == this->LogQueue.Head.Load()){
+			break;
+		}
+		usleep(REHAMOVE_LOGGER_THREAD_DELAY_US);
+	}
+}
+
+void RehaMove3::WriteLogMessage(uint8_t Style, const char *Text)
+{
+	// color codes: http://misc.flogisoft.com/bash/tip_colors_and_formatting
+	switch (Style){
+	case logStyle_warning:
+		printf("\033[1m\033[93m%s\033[0m", Text); // bold and light yellow
+		break;
+	case logStyle_error:
+		printf("\n\033[1m\033[91m%s\033[0m\n", Text); // bold and light red
+		break;
+	default:
+		printf("%s", Text);
+	}
+}
+
+bool RehaMove3::OpenBinaryLog(const char *FileName)
+{
+	RehaMove3::CloseBinaryLog();
+	pthread_mutex_lock(&this->BinaryLog.File_mutex);
+	FILE *File = fopen(FileName, "wb");
+	if (File == NULL){
+		pthread_mutex_unlock(&this->BinaryLog.File_mutex);
+		RehaMove3::printMessage(printMSG_error, "%s Error: The binary log file %s could not be opened:\n     -> %s (%d)\n", this->DeviceIDClass, FileName, strerror(errno), errno);
+		return false;
+	}
+	rmBinLogFileHeader_t FileHeader;
+	memset(&FileHeader, 0, sizeof(FileHeader));
+	FileHeader.Magic 			= REHAMOVE_BINLOG_MAGIC;
+	FileHeader.Version 			= REHAMOVE_BINLOG_VERSION;
+	FileHeader.RecordSize 		= sizeof(rmBinLogRecord_t);
+	FileHeader.NumberOfMessages = rmLog_NumberOfMessages;
+	FileHeader.StartTime_ns 	= RehaMove3::GetTimeStamp_ns();
+	snprintf(FileHeader.DeviceID, sizeof(FileHeader.DeviceID), "%s", this->DeviceIDClass);
+	if (fwrite(&FileHeader, sizeof(FileHeader), 1, File) != 1){
+		fclose(File);
+		pthread_mutex_unlock(&this->BinaryLog.File_mutex);
+		RehaMove3::printMessage(printMSG_error, "%s Error: The binary log file %s could not be written!\n", this->DeviceIDClass, FileName);
+		return false;
+	}
+	this->BinaryLog.File = File;
+	this->BinaryLog.Active.Store(true);
+	pthread_mutex_unlock(&this->BinaryLog.File_mutex);
+	RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: The binary log is written to %s.\n", FileName);
+	return true;
+}
+
+void RehaMove3::CloseBinaryLog(void)
+{
+	if (!this->BinaryLog.Active.Exchange(false)){
+		return;
+	}
+	// write the remaining records and close the file
+	RehaMove3::WriteBinaryLogRecords();
+	pthread_mutex_lock(&this->BinaryLog.File_mutex);
+	if (this->BinaryLog.File != NULL){
+		fclose(this->BinaryLog.File);
+		this->BinaryLog.File = NULL;
+	}
+	pthread_mutex_unlock(&this->BinaryLog.File_mutex);
+}
+
+bool RehaMove3::PutBinaryLogRecord(uint16_t MessageID, const double *Args, uint8_t NumberOfArgs)
+{
+	// same queue as for the text messages (see PutLogMessage), but the caller never waits
+	BinaryLog_t::BinaryLogRecord_t *Slot = NULL;
+	uint64_t Position = this->BinaryLog.Head.Load();
+	while (true){
+		Slot = &this->BinaryLog.Queue[Position & (REHAMOVE_BINLOG_QUEUE_SIZE -1)];
+		uint64_t Sequence = Slot->Sequence.Load();
+		if (Sequence == Position){
+			if (this->BinaryLog.Head.CompareExchange(Position, Position +1)){
+				break;
+			}
+		} else if (Sequence < Position){
+			// the queue is full
+			this->BinaryLog.Dropped.Add(1);
+			return false;
+		} else {
+			Position = this->BinaryLog.Head.Load();
+		}
+	}
+	Slot->Record.Time_ns 	  = RehaMove3::GetTimeStamp_ns();
+	Slot->Record.MessageID 	  = MessageID;
+	Slot->Record.NumberOfArgs = NumberOfArgs;
+	memcpy(Slot->Record.Args, Args, NumberOfArgs *sizeof(double));
+	Slot->Sequence.Store(Position +1);
+	sem_post(&this->LogQueue.NewMessages);
+	return true;
+}
+
+bool RehaMove3::WriteBinaryLogRecords(void)
+{
+	// called by the logger threat and by CloseBinaryLog -> the mutex makes sure there is only one reader
+	bool RecordsWritten = false;
+	pthread_mutex_lock(&this->BinaryLog.File_mutex);
+	uint64_t Position = this->BinaryLog.Tail.Load();
+	while (true){
+		BinaryLog_t::BinaryLogRecord_t *Slot = &this->BinaryLog.Queue[Position & (REHAMOVE_BINLOG_QUEUE_SIZE -1)];
+		if (Slot->Sequence.Load() != (Position +1)){
+			break;
+		}
+		if (this->BinaryLog.File != NULL){
+			if (fwrite(&Slot->Record, sizeof(rmBinLogRecord_t), 1, this->BinaryLog.File) != 1){
+				this->BinaryLog.Dropped.Add(1);
+			}
+		}
+		Slot->Sequence.Store(Position + REHAMOVE_BINLOG_QUEUE_SIZE);
+		Position++;
+		this->BinaryLog.Tail.Store(Position);
+		RecordsWritten = true;
+	}
+	if (RecordsWritten && (this->BinaryLog.File != NULL)){
+		fflush(this->BinaryLog.File);
+	}
+	pthread_mutex_unlock(&this->BinaryLog.File_mutex);
+	return RecordsWritten;
+}
+
 void RehaMove3::AbortDeviceInitialisation()
 {
-	this->rmStatus.InitThreatRunning = false;
+	if (this->rmStatus.InitPhase < rmInitPhase_NumberOfPhases){
+		RehaMove3::SetInitPhase(rmInitPhase_NumberOfPhases);
+		RehaMove3::PrintInitTiming();
+	}
+	this->rmStatus.InitThreatRunning.Store(false);
 	RehaMove3::CloseSerial();
 	this->rmInitResult.finished = true;
 	this->rmInitResult.successful = false;
 	memcpy(this->rmInitResultExtern, &this->rmInitResult, sizeof(this->rmInitResult));
 }
 
+void RehaMove3::SetInitPhase(uint8_t NextPhase)
+{
+	// the time since the last call is counted for the current phase
+	uint64_t TimeNow_ns = RehaMove3::GetTimeStamp_ns();
+	if (this->rmStatus.InitPhase < rmInitPhase_NumberOfPhases){
+		this->rmStatus.InitTiming.Phase_ms[this->rmStatus.InitPhase] += ((double)(TimeNow_ns - this->rmStatus.InitPhaseStart_ns))/1000000.0;
+	}
+	this->rmStatus.InitTiming.Total_ms = ((double)(TimeNow_ns - this->rmStatus.InitStart_ns))/1000000.0;
+	this->rmStatus.InitPhase = NextPhase;
+	this->rmStatus.InitPhaseStart_ns = TimeNow_ns;
+}
+
+void RehaMove3::PrintInitTiming(void)
+{
+	rmInitTiming_t *T = &this->rmStatus.InitTiming;
+	RehaMove3::printMessage(printMSG_rmInitInfo, "%s: The initialisation took %0.1fms (%u resets)\n   -> Open: %0.1fms; Probe: %0.1fms; Stop: %0.1fms; Protocol Init: %0.1fms; Checks: %0.1fms; Resets: %0.1fms\n",
+			this->DeviceIDClass, T->Total_ms, (unsigned int)T->NumberOfResets, T->Phase_ms[rmInitPhase_Open], T->Phase_ms[rmInitPhase_Probe], T->Phase_ms[rmInitPhase_Stop],
+			T->Phase_ms[rmInitPhase_ProtocolInit], T->Phase_ms[rmInitPhase_Checks], T->Phase_ms[rmInitPhase_Reset]);
+}
+
 bool RehaMove3::SendNewPreDefinedLowLevelSequence(LlSequenceConfig_t *SequenceConfig, uint64_t *SequenceID)
 {
+	RM3_TRACE_SCOPE(rmTrace_LlSequence, SequenceConfig->NumberOfPulses);
+	// time stamp of this step for the messages below
+	RehaMove3::GetCurrentTime(true);
 	// make sure the device is initialised
 	*SequenceID = 0;
-	if (!this->rmStatus.DeviceInitialised || !this->rmStatus.DeviceLlIsInitialised){
+	if (!this->rmStatus.DeviceInitialised.Load()){
+		return false;
+	}
+
+	/*
+	 * Hybrid mode -> stable sequences are executed by the device
+	 */
+	if (this->rmInitSettings.LowLevelConfig.UseHybridMode){
+		if (RehaMove3::HandleHybridLowLevelSequence(SequenceConfig)){
+			// the sequence is executed by the device -> nothing to send
+			return true;
+		}
+	}
+	if (!this->rmStatus.DeviceLlIsInitialised.Load()){
 		return false;
 	}
 
 	/*
 	 * Handling StimulationErrors e.g. electrode errors
 	 */
-	if (this->rmStatus.DoNotStimulate){
+	if (this->rmStatus.DoNotStimulate.Load()){
 		if ( this->rmStatus.DoReTestTheStimError){
 			this->rmStatus.NumberOfSequencesUntilErrorRetest--;
 			if (this->rmStatus.NumberOfSequencesUntilErrorRetest != 0){
 				// do not re-test for the errors yet
-				this->Stats.SequencesSend++;
-				this->Stats.SequencesFailed++;
+				this->Stats.SequencesSend.Add(1);
+				this->Stats.SequencesFailed.Add(1);
 				return false;
 			} else {
 				// do re-test for the errors ....
 				this->rmStatus.DoReTestTheStimError = false;
-				this->rmStatus.DoNotStimulate = false;
+				this->rmStatus.DoNotStimulate.Store(false);
 			}
 		} else {
 			// do not re-test for the errors ever
-			this->Stats.SequencesSend++;
-			this->Stats.SequencesFailed++;
+			this->Stats.SequencesSend.Add(1);
+			this->Stats.SequencesFailed.Add(1);
 			return false;
 		}
 	}
 
 	bool	 OneOrMorePulsesSend = false, WasCorrected = false;
 	uint8_t  NumberOfPoints = 0, iPoint = 0, iCh = 0;
-	uint16_t PulseWidth[REHAMOVE_SHAPES__NUMBER_OF_POINTS_MAX] = {}, PWStepSize = 0, tempPW = 0;
-	float 	 Current[REHAMOVE_SHAPES__NUMBER_OF_POINTS_MAX] = {}, CurrentSign = 0, tempI = 0, CurrentStepSize = 0.0;
-	double 	 Charge = 0.0, ChargeOverAll[REHAMOVE_NUMBER_OF_CHANNELS] = {0.0};
+	uint16_t PulseWidth[REHAMOVE_SHAPES__NUMBER_OF_POINTS_MAX] = {}, tempPW = 0;
+	float 	 Current[REHAMOVE_SHAPES__NUMBER_OF_POINTS_MAX] = {}, tempI = 0;
+	double 	 ChargeOverAll[REHAMOVE_NUMBER_OF_CHANNELS] = {0.0};
 
 	// Struct for Ll_channel_config command
 	Smpt_ll_channel_config 	ll_channel_config;
@@ -693,212 +2250,10 @@ bool RehaMove3::SendNewPreDefinedLowLevelSequence(LlSequenceConfig_t *SequenceCo
 		}
 
 		// build point list
-		switch (SequenceConfig->PulseConfig[i_Pulse].Shape) {
-		case Shape_Balanced_Symetric_Biphasic:
-		case Shape_Balanced_Symetric_Biphasic_NEGATIVE:
-			// 0/1 symmetric biphasic pulse; charge balanced
-			if (SequenceConfig->PulseConfig[i_Pulse].Shape == Shape_Balanced_Symetric_Biphasic_NEGATIVE){
-				// handle the negative case
-				SequenceConfig->PulseConfig[i_Pulse].Current = -1.0 *fabsf(SequenceConfig->PulseConfig[i_Pulse].Current);
-			}
-			iPoint = 0;
-			PulseWidth[iPoint] = SequenceConfig->PulseConfig[i_Pulse].PulseWidth;    	// positive pulse
-			Current[iPoint++] = SequenceConfig->PulseConfig[i_Pulse].Current;
-			PulseWidth[iPoint] = 100;                                				// 100us break
-			Current[iPoint++] = 0.0;
-			PulseWidth[iPoint] = SequenceConfig->PulseConfig[i_Pulse].PulseWidth;    	// negative pulse
-			Current[iPoint++] = -1.0 * SequenceConfig->PulseConfig[i_Pulse].Current;
-			ChargeOverAll[iCh] += 0;
-			NumberOfPoints = iPoint;
-			break;
-
-		case Shape_Balanced_UNsymetric_Biphasic:
-		case Shape_Balanced_UNsymetric_Biphasic_NEGATIVE:
-			// 2/3 unsymmetric biphasic pulse; charge balanced
-			if (SequenceConfig->PulseConfig[i_Pulse].Shape == Shape_Balanced_UNsymetric_Biphasic_NEGATIVE){
-				// handle the negative case
-				SequenceConfig->PulseConfig[i_Pulse].Current = -1.0 *fabsf(SequenceConfig->PulseConfig[i_Pulse].Current);
-			}
-			iPoint = 0;
-			PulseWidth[iPoint]  = SequenceConfig->PulseConfig[i_Pulse].PulseWidth;    	// positive pulse
-			Current[iPoint]     = SequenceConfig->PulseConfig[i_Pulse].Current;
-			Charge         		= (double)PulseWidth[iPoint] *Current[iPoint];
-			CurrentSign         = (Current[iPoint] < 0) ? -1.0 : 1.0;
-			iPoint++;
-			PulseWidth[iPoint]  = 100;                                					// 100us break
-			Current[iPoint++]   = 0.0;
-			iPoint += RehaMove3::GetMinimalCurrentPulse(&PulseWidth[iPoint], &Current[iPoint], &Charge, 1); // negative pulse
-			ChargeOverAll[iCh] += Charge;
-			NumberOfPoints = iPoint;
-			break;
-
-		case Shape_UNbalanced_UNsymetric_Monophasic:
-		case Shape_UNbalanced_UNsymetric_Monophasic_NEGATIVE:
-			// 4/5 -> monophasic pulse; charge balanced
-			if (SequenceConfig->PulseConfig[i_Pulse].Shape == Shape_UNbalanced_UNsymetric_Monophasic_NEGATIVE){
-				// handle the negative case
-				SequenceConfig->PulseConfig[i_Pulse].Current = -1.0 *fabsf(SequenceConfig->PulseConfig[i_Pulse].Current);
-			}
-			iPoint = 0;
-			PulseWidth[iPoint] = SequenceConfig->PulseConfig[i_Pulse].PulseWidth;     // first pulse
-			Current[iPoint]    = SequenceConfig->PulseConfig[i_Pulse].Current;
-			ChargeOverAll[iCh] += PulseWidth[iPoint] * Current[iPoint];
-			iPoint++;
-			NumberOfPoints = iPoint;
-			break;
-
-		case Shape_UNbalanced_UNsymetric_Biphasic_FIRST:
-		case Shape_Balanced_UNsymetric_Biphasic_FIRST:
-		case Shape_Balanced_UNsymetric_LONG_Biphasic_FIRST:
-			// 6/8/10 -> first part of a unsymmetric biphasic pulse; polarity depends on the current sign
-			// does the secound pulse exist?
-			if ( SequenceConfig->PulseConfig[i_Pulse +1].Shape == Shape_UNbalanced_UNsymetric_Biphasic_SECOUND ||
-				 SequenceConfig->PulseConfig[i_Pulse +1].Shape == Shape_Balanced_UNsymetric_Biphasic_SECOUND   ||
-				 SequenceConfig->PulseConfig[i_Pulse +1].Shape == Shape_Balanced_UNsymetric_LONG_Biphasic_SECOUND) {
-				iPoint = 0;
-				PulseWidth[iPoint] = SequenceConfig->PulseConfig[i_Pulse].PulseWidth;   	// first pulse
-				Current[iPoint]    = SequenceConfig->PulseConfig[i_Pulse].Current;
-				CurrentSign        = (Current[iPoint] < 0) ? -1.0 : 1.0;
-				Charge = PulseWidth[iPoint] *Current[iPoint];
-				iPoint++;
-				PulseWidth[iPoint] = 100;                              					// 100us break
-				Current[iPoint++]  = 0.0;
-				PulseWidth[iPoint] = SequenceConfig->PulseConfig[i_Pulse +1].PulseWidth; // second pulse
-				Current[iPoint]    = -1.0 *CurrentSign	*fabsf(SequenceConfig->PulseConfig[i_Pulse +1].Current);
-				Charge = PulseWidth[iPoint] *Current[iPoint];
-				iPoint++;
-				// charge compensation
-				if (SequenceConfig->PulseConfig[i_Pulse].Shape == Shape_Balanced_UNsymetric_Biphasic_FIRST) {
-					iPoint += RehaMove3::GetMinimalCurrentPulse(&PulseWidth[iPoint], &Current[iPoint], &Charge, 1);
-				} else if (SequenceConfig->PulseConfig[i_Pulse].Shape == Shape_Balanced_UNsymetric_LONG_Biphasic_FIRST) {
-					iPoint += RehaMove3::GetMinimalCurrentPulse(&PulseWidth[iPoint], &Current[iPoint], &Charge, 7);
-				}
-				ChargeOverAll[iCh] += Charge;
-				NumberOfPoints = iPoint;
-			} else {
-				RehaMove3::printMessage(printMSG_rmSequenceError, "%s Error: The second half of an (UN)Balanced, UNsymmetric, biphasic pulse was not defined!\n     -> Pulse %u is discarded!\n!\n", this->DeviceIDClass, i_Pulse);
-				NumberOfPoints = 0;
-				continue;
-
-			}
-			break;
-
-		case Shape_UNbalanced_UNsymetric_Biphasic_SECOUND:
-		case Shape_Balanced_UNsymetric_Biphasic_SECOUND:
-		case Shape_Balanced_UNsymetric_LONG_Biphasic_SECOUND:
-			// 7/9/11 -> second part of the unsymmetric biphasic pulse; the configuration was already used -> skip this SequenceConfig->PulseConfiguration
-			NumberOfPoints = 0;
-			continue;
-			break;
-
-		case Shape_Balanced_UNsymetric_RisingTriangle:
-		case Shape_Balanced_UNsymetric_FallingTriangle:
-		case Shape_UNbalanced_UNsymetric_RisingTriangle:
-		case Shape_UNbalanced_UNsymetric_FallingTriangle:
-			{
-			// 12-15 -> Triangle pulse, balanced/UNbanced; polarity is defined by the current sign
-			// Pulse Breite
-			uint8_t tempNumberOfPoints = 0;
-			if (SequenceConfig->PulseConfig[i_Pulse].Shape == Shape_Balanced_UNsymetric_RisingTriangle ||
-				SequenceConfig->PulseConfig[i_Pulse].Shape == Shape_Balanced_UNsymetric_FallingTriangle){
-				tempNumberOfPoints = REHAMOVE_SHAPES__TRIAGLE_MAX_POINTS_BI;
-			} else {
-				tempNumberOfPoints = REHAMOVE_SHAPES__TRIAGLE_MAX_POINTS_MONO;
-			}
-			bool WasCorrected;
-			iPoint = 0;
-			Charge = 0.0;
-
-			// NumberOfPoints für den Rechtwinkligen Teil wenn wir dir minimale Breite deines Punktes annehmen
-			NumberOfPoints = (uint8_t) floor(SequenceConfig->PulseConfig[i_Pulse].PulseWidth / REHAMOVE_SHAPES__PW_MIN);
-			if (NumberOfPoints == 0){
-				// no steps -> this pulse is no executed
-				continue;
-			}
-			// Falls bei minimaler Breite mehr Punkte als REHAMOVE__TRIAGLE_MAX_POINTS (14?) berechnet wurden, werden nur REHAMOVE__TRIAGLE_MAX_POINTS verwendet und dafür die Pulsbreite vergrößert
-			NumberOfPoints = (NumberOfPoints > tempNumberOfPoints) ? tempNumberOfPoints : NumberOfPoints;
-			// Höhe der Stromstufen
-			CurrentStepSize = RehaMove3::CheckAndCorrectCurrent( fabsf(SequenceConfig->PulseConfig[i_Pulse].Current / NumberOfPoints), &WasCorrected);
-			if (CurrentStepSize == 0.0){
-				// current step is two small -> this pulse is no executed
-				continue;
-			}
-			NumberOfPoints = (uint8_t)roundf(SequenceConfig->PulseConfig[i_Pulse].Current/CurrentStepSize);
-			NumberOfPoints = (NumberOfPoints > tempNumberOfPoints) ? tempNumberOfPoints : NumberOfPoints;
-			// Berechne die Pulsbreite einer Stufe des Dreiecks (Abrunden und dann den ersten Punkt länger machen um genau auf PW_Soll zu kommen)
-			PWStepSize = floor(SequenceConfig->PulseConfig[i_Pulse].PulseWidth / NumberOfPoints);
-			if (REHAMOVE_SHAPES__TRIAGLE_USE_FIXED_PW_STEP) {
-				// ggf. feste Breite verwenden
-				PWStepSize = (PWStepSize > REHAMOVE_SHAPES__TRIAGLE_PW_STEP) ? REHAMOVE_SHAPES__TRIAGLE_PW_STEP : PWStepSize;
-			}
-			PWStepSize = (PWStepSize < REHAMOVE_SHAPES__PW_MIN) ? REHAMOVE_SHAPES__PW_MIN : PWStepSize;
-
-			CurrentSign    = (SequenceConfig->PulseConfig[i_Pulse].Current < 0) ? -1.0 : 1.0;
-			tempPW = 0;
-			// calculate the steps of the triangle
-			// point 0
-			PulseWidth[0] = PWStepSize;
-			tempPW += PWStepSize;
-			Current[0] = (float)CurrentStepSize *CurrentSign;
-			Charge += (double)PulseWidth[0] *Current[0];
-			// point 1 - N
-			for (iPoint = 1; iPoint < NumberOfPoints; iPoint++) {
-				PulseWidth[iPoint] = PWStepSize;
-				tempPW += PWStepSize;
-				Current[iPoint] = Current[iPoint -1] +((float)CurrentStepSize *CurrentSign);
-				Charge += (double)PulseWidth[iPoint] *Current[iPoint];
-			}
-			// last step of the triangle
-			int tempPW2 = PulseWidth[iPoint -1] + SequenceConfig->PulseConfig[i_Pulse].PulseWidth -tempPW;
-			PulseWidth[iPoint -1] = (tempPW2 > 0) ? (uint16_t)tempPW2 : 0;
-			Current[iPoint -1] = SequenceConfig->PulseConfig[i_Pulse].Current;
-
-			// triangle in first or second flank ?
-			if (SequenceConfig->PulseConfig[i_Pulse].Shape == Shape_Balanced_UNsymetric_FallingTriangle ||
-				SequenceConfig->PulseConfig[i_Pulse].Shape == Shape_UNbalanced_UNsymetric_FallingTriangle){
-				// second flank -> reverse the order
-				uint16_t PWtemp[REHAMOVE_SHAPES__NUMBER_OF_POINTS_MAX] = {};
-				float 	 Itemp[REHAMOVE_SHAPES__NUMBER_OF_POINTS_MAX] = {};
-				for (uint8_t iTemp = 0; iTemp < NumberOfPoints; iTemp++) {
-					PWtemp[iTemp] = PulseWidth[NumberOfPoints -1 -iTemp];
-					Itemp[iTemp]  = Current[NumberOfPoints -1 -iTemp];
-				}
-				for (uint8_t iTemp = 0; iTemp < NumberOfPoints; iTemp++) {
-					PulseWidth[iTemp] = PWtemp[iTemp];
-					Current[iTemp]    = Itemp[iTemp];
-				}
-			}
-
-			// charge balance
-			if (SequenceConfig->PulseConfig[i_Pulse].Shape == Shape_Balanced_UNsymetric_RisingTriangle ||
-				SequenceConfig->PulseConfig[i_Pulse].Shape == Shape_Balanced_UNsymetric_FallingTriangle){
-				// 100us break
-				PulseWidth[iPoint] = 100;                             // 100us break
-				Current[iPoint++]  = 0.0;
-				// charge balance pulse
-				iPoint += RehaMove3::GetMinimalCurrentPulse(&PulseWidth[iPoint], &Current[iPoint], &Charge, 1);
-			}
-			// done
-			ChargeOverAll[iCh] += Charge;
-			NumberOfPoints = iPoint;
-			break;}
-
-		case Shape_UNbalanced_Charge_Compensation:
-			// 16 -> charge compensation for one channel
-			if (fabs(ChargeOverAll[iCh]) >= REHAMOVE_SHAPES__PW_MIN * REHAMOVE_SHAPES__I_MIN) {
-				NumberOfPoints = RehaMove3::GetMinimalCurrentPulse(&PulseWidth[0], &Current[0], &ChargeOverAll[iCh], 2);
-			} else {
-				NumberOfPoints = 0;
-				continue;
-			}
-			break;
-
-		/*
-		 * Done with the pulse form generation
-		 */
-		default:
-			// error: unknown shape
-			RehaMove3::printMessage(printMSG_error, "%s Error: The requested shape %u is invalid! (time: %0.3f; pulse: %u)\n", this->DeviceIDClass, SequenceConfig->PulseConfig[i_Pulse].Shape, RehaMove3::GetCurrentTime(), i_Pulse);
+		NumberOfPoints = RehaMove3::BuildPulseForm(&SequenceConfig->PulseConfig[i_Pulse], (i_Pulse+1 < SequenceConfig->NumberOfPulses) ? &SequenceConfig->PulseConfig[i_Pulse +1] : NULL,
+				PulseWidth, Current, &ChargeOverAll[iCh], i_Pulse);
+		if (NumberOfPoints == 0){
+			// no points -> this pulse is not executed
 			continue;
 		}
 
@@ -924,42 +2279,52 @@ bool RehaMove3::SendNewPreDefinedLowLevelSequence(LlSequenceConfig_t *SequenceCo
 		/*
 		 * Debug output of this pulse
 		 */
-		if (this->rmInitSettings.DebugConfig.printStimInfos){
+		if (this->rmInitSettings.DebugConfig.printStimInfos || this->BinaryLog.Active.Load()){
 			// Stimulation configuration
-			RehaMove3::printMessage(printMSG_rmPulseConfig, "  Pulse %u -> Channel=%u; Shape=%u; PW=%u; I=%0.1f\n",i_Pulse+1, (uint8_t)ll_channel_config.channel+1, SequenceConfig->PulseConfig[i_Pulse].Shape, SequenceConfig->PulseConfig[i_Pulse].PulseWidth, SequenceConfig->PulseConfig[i_Pulse].Current);
+			RehaMove3::logMessage(printMSG_rmPulseConfig, rmLog_LlPulse, 5, (double)(i_Pulse+1), (double)((uint8_t)ll_channel_config.channel+1), (double)SequenceConfig->PulseConfig[i_Pulse].Shape, (double)SequenceConfig->PulseConfig[i_Pulse].PulseWidth, (double)SequenceConfig->PulseConfig[i_Pulse].Current);
 			if ( SequenceConfig->PulseConfig[i_Pulse+1].Shape == Shape_UNbalanced_UNsymetric_Biphasic_SECOUND || SequenceConfig->PulseConfig[i_Pulse+1].Shape == Shape_Balanced_UNsymetric_Biphasic_SECOUND ) {
-				RehaMove3::printMessage(printMSG_rmPulseConfig, "  Pulse %u -> Channel=%u; Shape=%u; PW=%u; I=%0.1f\n", i_Pulse+2, SequenceConfig->PulseConfig[i_Pulse+1].Channel, SequenceConfig->PulseConfig[i_Pulse+1].Shape, SequenceConfig->PulseConfig[i_Pulse+1].PulseWidth, SequenceConfig->PulseConfig[i_Pulse+1].Current);
+				RehaMove3::logMessage(printMSG_rmPulseConfig, rmLog_LlPulse, 5, (double)(i_Pulse+2), (double)SequenceConfig->PulseConfig[i_Pulse+1].Channel, (double)SequenceConfig->PulseConfig[i_Pulse+1].Shape, (double)SequenceConfig->PulseConfig[i_Pulse+1].PulseWidth, (double)SequenceConfig->PulseConfig[i_Pulse+1].Current);
 			}
 			for (iPoint=0; iPoint<ll_channel_config.number_of_points; iPoint++) {
-				RehaMove3::printMessage(printMSG_rmPulseConfig, "     PointConfig% 3d: Duration=% 4iµs; Current=% +7.2fmA; (Mode=%i; IM=%i)\n",
-						iPoint+1, ll_channel_config.points[iPoint].time, ll_channel_config.points[iPoint].current, ll_channel_config.points[iPoint].control_mode, ll_channel_config.points[iPoint].interpolation_mode );
+				RehaMove3::logMessage(printMSG_rmPulseConfig, rmLog_PointConfig, 5,
+						(double)(iPoint+1), (double)ll_channel_config.points[iPoint].time, (double)ll_channel_config.points[iPoint].current, (double)ll_channel_config.points[iPoint].control_mode, (double)ll_channel_config.points[iPoint].interpolation_mode );
 			}
 		}
 
-		/*
-		 * Prepare for acks and sequence statistics
-		 */
-		ll_channel_config.packet_number = GetPackageNumber();
-
 		/*
 		 * Check the configuration and send it
+		 * -> the package number is taken under the send lock, so the numbers of concurrent senders do not interleave
 		 */
 		if (smpt_is_valid_ll_channel_config(&ll_channel_config)) {
 			// Send the Ll_channel_list command to RehaMove
-			if (smpt_send_ll_channel_config(&(this->Device), &ll_channel_config)){
+			RM3_TRACE_MUTEX_LOCK(rmTrace_LockSendPackage, &(this->SendPackage_mutex));
+			// the reconnect closes the interface with the send lock held -> check the device again under the lock
+			if (!this->rmStatus.DeviceInitialised.Load()){
+				pthread_mutex_unlock(&(this->SendPackage_mutex));
+				break;
+			}
+			ll_channel_config.packet_number = GetPackageNumber();
+			bool ChannelConfigSend = smpt_send_ll_channel_config(&(this->Device), &ll_channel_config);
+			pthread_mutex_unlock(&(this->SendPackage_mutex));
+			if (ChannelConfigSend){
+				RM3_TRACE_INSTANT(rmTrace_LlPulseSend, ll_channel_config.packet_number);
 				OneOrMorePulsesSend = true;
-				this->Stats.StimultionPulsesSend++;
+				this->Stats.StimultionPulsesSend.Add(1);
+				this->Stats.Channel[ll_channel_config.channel].PulsesSend.Add(1);
 				// add the expected response to the ChannelResponse queue
-				*SequenceID = PutLLChannelResponseExpectation(this->Stats.SequencesSend+1, ll_channel_config.channel, ll_channel_config.packet_number);
+				*SequenceID = PutLLChannelResponseExpectation(this->Stats.SequencesSend.Load()+1, ll_channel_config.channel, ll_channel_config.packet_number);
 			} else {
 				// error: failed to send the configuration
 				RehaMove3::printMessage(printMSG_error, "%s Error: The channel configuration could not be send! (time: %0.3f; pulse: %u)\n", this->DeviceIDClass, RehaMove3::GetCurrentTime(), i_Pulse);
-				this->Stats.StimultionPulsesNotSend++;
+				this->Stats.SendErrors.Add(1);
+				this->Stats.StimultionPulsesNotSend.Add(1);
+				this->Stats.Channel[ll_channel_config.channel].PulsesNotSend.Add(1);
 			}
 		} else {
 			// error: channel configuration is INvalid
 			RehaMove3::printMessage(printMSG_rmSequenceError, "%s Error: The channel configuration is NOT valid! The pulse was not send! (time: %0.3f; pulse: %u)\n", this->DeviceIDClass, RehaMove3::GetCurrentTime(), i_Pulse);
-			this->Stats.StimultionPulsesNotSend++;
+			this->Stats.StimultionPulsesNotSend.Add(1);
+			this->Stats.Channel[ll_channel_config.channel].PulsesNotSend.Add(1);
 		}
 	} // for loop
 
@@ -976,39 +2341,236 @@ bool RehaMove3::SendNewPreDefinedLowLevelSequence(LlSequenceConfig_t *SequenceCo
 
 	// done sending the sequence configuration
 	if (OneOrMorePulsesSend){
-		this->Stats.SequencesSend++;
+		this->Stats.SequencesSend.Add(1);
 	}
 	return OneOrMorePulsesSend;
 }
 
 
+bool RehaMove3::HandleHybridLowLevelSequence(LlSequenceConfig_t *SequenceConfig)
+{
+	// returns true, if the sequence is executed by the device and no LowLevel pulses must be send
+
+	// is the sequence identical to the last one?
+	bool SequenceIsStable = (SequenceConfig->NumberOfPulses == this->rmSettings.LowLevel.HybridLastSequence.NumberOfPulses);
+	for (uint8_t i_Pulse = 0; SequenceIsStable && (i_Pulse < SequenceConfig->NumberOfPulses); i_Pulse++){
+		if ( (SequenceConfig->PulseConfig[i_Pulse].Channel    != this->rmSettings.LowLevel.HybridLastSequence.PulseConfig[i_Pulse].Channel)    ||
+			 (SequenceConfig->PulseConfig[i_Pulse].Shape      != this->rmSettings.LowLevel.HybridLastSequence.PulseConfig[i_Pulse].Shape)      ||
+			 (SequenceConfig->PulseConfig[i_Pulse].PulseWidth != this->rmSettings.LowLevel.HybridLastSequence.PulseConfig[i_Pulse].PulseWidth) ||
+			 (SequenceConfig->PulseConfig[i_Pulse].Current    != this->rmSettings.LowLevel.HybridLastSequence.PulseConfig[i_Pulse].Current) ){
+			SequenceIsStable = false;
+		}
+	}
+	if (SequenceIsStable){
+		this->rmSettings.LowLevel.HybridStableSequences++;
+	} else {
+		// the sequence did change -> save the unmodified sequence, the send function corrects the input
+		memcpy(&this->rmSettings.LowLevel.HybridLastSequence, SequenceConfig, sizeof(LlSequenceConfig_t));
+		this->rmSettings.LowLevel.HybridStableSequences = 0;
+	}
+
+	if (this->rmStatus.HybridSequenceOffloaded.Load()){
+		// electrode errors are reported via the keep alive signal
+		if (SequenceIsStable && RehaMove3::GetLastMidLevelStimulationResult(NULL)){
+			// the device still stimulates with this sequence
+			this->Stats.HybridSequencesOffloaded.Add(1);
+			return true;
+		}
+		// the sequence did change or failed -> back to the LowLevel protocol; this sequence is send as LowLevel sequence
+		RehaMove3::StopHybridOffload();
+		this->rmSettings.LowLevel.HybridStableSequences = 0;
+		return false;
+	}
+
+	// hand the sequence over to the device?
+	if (!this->rmStatus.DoNotStimulate.Load() && (this->rmSettings.LowLevel.HybridStableSequences >= this->rmInitSettings.LowLevelConfig.HybridStableSequences)){
+		if (RehaMove3::StartHybridOffload(SequenceConfig)){
+			this->Stats.HybridSequencesOffloaded.Add(1);
+			return true;
+		}
+		// the sequence can not be executed by the MidLevel protocol -> try again after the next N stable sequences
+		this->rmSettings.LowLevel.HybridStableSequences = 0;
+	}
+	return false;
+}
+
+bool RehaMove3::StartHybridOffload(LlSequenceConfig_t *SequenceConfig)
+{
+	/*
+	 * Check if the sequence can be executed by the MidLevel protocol -> one pulse per channel; no pulse forms that need a second pulse
+	 */
+	if (this->rmSettings.StimFrequency == 0){
+		return false;
+	}
+	MlUpdateConfig_t MlConfig;
+	memset(&MlConfig, 0, sizeof(MlUpdateConfig_t));
+	uint8_t iCh = 0;
+	for (uint8_t i_Pulse = 0; i_Pulse < SequenceConfig->NumberOfPulses; i_Pulse++){
+		if (SequenceConfig->PulseConfig[i_Pulse].PulseWidth == 0){
+			continue;
+		}
+		if (!RehaMove3::CheckChannel(SequenceConfig->PulseConfig[i_Pulse].Channel)){
+			return false;
+		}
+		iCh = SequenceConfig->PulseConfig[i_Pulse].Channel -1;
+		if (MlConfig.ActiveChannels[iCh]){
+			// more than one pulse per channel
+			return false;
+		}
+		switch (SequenceConfig->PulseConfig[i_Pulse].Shape) {
+		case Shape_UNbalanced_UNsymetric_Biphasic_FIRST:
+		case Shape_UNbalanced_UNsymetric_Biphasic_SECOUND:
+		case Shape_Balanced_UNsymetric_Biphasic_FIRST:
+		case Shape_Balanced_UNsymetric_Biphasic_SECOUND:
+		case Shape_Balanced_UNsymetric_LONG_Biphasic_FIRST:
+		case Shape_Balanced_UNsymetric_LONG_Biphasic_SECOUND:
+		case Shape_UNbalanced_Charge_Compensation:
+			return false;
+		default:
+			break;
+		}
+		MlConfig.ActiveChannels[iCh] = true;
+		MlConfig.PulseConfig[iCh].Channel    = SequenceConfig->PulseConfig[i_Pulse].Channel;
+		MlConfig.PulseConfig[iCh].Shape      = SequenceConfig->PulseConfig[i_Pulse].Shape;
+		MlConfig.PulseConfig[iCh].Frequency  = (float)this->rmSettings.StimFrequency;
+		MlConfig.PulseConfig[iCh].PulseWidth = SequenceConfig->PulseConfig[i_Pulse].PulseWidth;
+		MlConfig.PulseConfig[iCh].Current    = SequenceConfig->PulseConfig[i_Pulse].Current;
+	}
+	MlConfig.ForceUpdate = true;
+
+	/*
+	 * Switch the device to the MidLevel protocol -> both commands are send back-to-back, then both acknowledgements are waited for
+	 * -> the state is changed only if the device accepted both commands; otherwise back to the LowLevel protocol
+	 */
+	pthread_mutex_lock(&(this->SendPackage_mutex));
+	// the reconnect closes the interface with the send lock held -> check the device again under the lock
+	if (!this->rmStatus.DeviceInitialised.Load()){
+		pthread_mutex_unlock(&(this->SendPackage_mutex));
+		return false;
+	}
+	RehaMove3::AddResponseExpectation(Smpt_Cmd_Ll_Stop_Ack, true);
+	bool LlStopSend = smpt_send_ll_stop(&(this->Device), RehaMove3::GetPackageNumber());
+	bool MlInitSend = false;
+	if (LlStopSend){
+		Smpt_ml_init ml_init;
+		smpt_clear_ml_init(&ml_init);
+		ml_init.packet_number = RehaMove3::GetPackageNumber();
+		RehaMove3::AddResponseExpectation(Smpt_Cmd_Ml_Init_Ack, true);
+		MlInitSend = smpt_send_ml_init(&(this->Device), &ml_init);
+	}
+	pthread_mutex_unlock(&(this->SendPackage_mutex));
+	uint64_t SwitchDeadline_ms = RehaMove3::GetTimeStamp_ns() /1000000 + REHAMOVE_HYBRID_ACK_TIMEOUT_MS;
+	bool LlStopped = LlStopSend && (RehaMove3::GetResponse(Smpt_Cmd_Ll_Stop_Ack, false, RehaMove3::GetTimeUntil_ms(SwitchDeadline_ms)) == Smpt_Cmd_Ll_Stop_Ack);
+	bool MlInitialised = MlInitSend && (RehaMove3::GetResponse(Smpt_Cmd_Ml_Init_Ack, false, RehaMove3::GetTimeUntil_ms(SwitchDeadline_ms)) == Smpt_Cmd_Ml_Init_Ack);
+	if (!LlStopped || !MlInitialised){
+		RehaMove3::printMessage(printMSG_error, "%s Error: The sequence could not be handed over to the device! (LL_Stop: %s; ML_Init: %s; time: %0.3f)\n", this->DeviceIDClass,
+				LlStopped ? "ok" : (LlStopSend ? "rejected or missing" : "not send"), MlInitialised ? "ok" : (MlInitSend ? "rejected or missing" : "not send"), RehaMove3::GetCurrentTime());
+		// unknown state of the device -> stop what may be running and initialise the LowLevel protocol again
+		this->rmStatus.DeviceMlIsInitialised.Store(MlInitSend);
+		this->rmStatus.DeviceLlIsInitialised.Store(!LlStopSend);
+		RehaMove3::StopHybridOffload();
+		return false;
+	}
+	this->rmStatus.DeviceLlIsInitialised.Store(false);
+	this->rmStatus.DeviceMlIsInitialised.Store(true);
+	this->rmStatus.HybridSequenceOffloaded.Store(true);
+
+	// forget old MidLevel states -> the receiver marks the state valid again with the next keep alive response
+	this->Acks.G_ml_current_data_valid.Store(false);
+	memset(&this->rmSettings.MidLevel.CurrentMlStimConfig, 0, sizeof(MlUpdateConfig_t));
+
+	// start the stimulation
+	if (!RehaMove3::SendMidLevelUpdateNow(&MlConfig, 1)){
+		RehaMove3::StopHybridOffload();
+		return false;
+	}
+	// the keep alive signal is send by the timer, the update function is not called anymore
+	if (this->rmSettings.MidLevel.KeepAlivePeriod_ms <= 0.0){
+		this->rmSettings.MidLevel.KeepAlivePeriod_ms = REHAMOVE_HYBRID_KEEPALIVE_PERIOD_MS;
+	}
+	RehaMove3::StartMidLevelKeepAliveTimer();
+
+	this->Stats.HybridOffloads.Add(1);
+	RehaMove3::logMessage(printMSG_rmSendCMD, rmLog_HybridOffload, 1, RehaMove3::GetCurrentTime());
+	return true;
+}
+
+void RehaMove3::StopHybridOffload(void)
+{
+	// the keep alive signal is not needed anymore
+	RehaMove3::StopMidLevelKeepAliveTimer();
+
+	/*
+	 * Switch the device back to the LowLevel protocol -> only the acknowledgement of the ll_init is waited for
+	 * -> nothing to send, if the reconnect closed the interface; the device is initialised again with the LowLevel protocol
+	 */
+	bool LlInitSend = false;
+	pthread_mutex_lock(&(this->SendPackage_mutex));
+	if (this->rmStatus.DeviceMlIsInitialised.Load() && this->rmStatus.DeviceInitialised.Load()){
+		RehaMove3::GetResponse(Smpt_Cmd_Ml_Stop_Ack, true, 0);
+		if (!smpt_send_ml_stop(&(this->Device), RehaMove3::GetPackageNumber())) {
+			RehaMove3::printMessage(printMSG_error, "%s Error: Sending the command %d failed!\n", this->DeviceIDClass, Smpt_Cmd_Ml_Stop);
+		}
+		this->rmStatus.DeviceMlIsInitialised.Store(false);
+	}
+	if (!this->rmStatus.DeviceLlIsInitialised.Load() && this->rmStatus.DeviceInitialised.Load()){
+		Smpt_ll_init ll_init;
+		smpt_clear_ll_init(&ll_init);
+		ll_init.enable_denervation = 0;
+		ll_init.high_voltage_level = (Smpt_High_Voltage)this->rmInitSettings.LowLevelConfig.HighVoltageLevel;
+		ll_init.packet_number = RehaMove3::GetPackageNumber();
+		RehaMove3::AddResponseExpectation(Smpt_Cmd_Ll_Init_Ack, true);
+		LlInitSend = smpt_send_ll_init(&(this->Device), &ll_init);
+		if (!LlInitSend) {
+			RehaMove3::printMessage(printMSG_error, "%s Error: Sending the command %d failed!\n", this->DeviceIDClass, Smpt_Cmd_Ll_Init);
+		}
+	}
+	pthread_mutex_unlock(&(this->SendPackage_mutex));
+	if (LlInitSend){
+		if (RehaMove3::GetResponse(Smpt_Cmd_Ll_Init_Ack, false, REHAMOVE_HYBRID_ACK_TIMEOUT_MS) == Smpt_Cmd_Ll_Init_Ack){
+			this->rmStatus.DeviceLlIsInitialised.Store(true);
+		} else {
+			RehaMove3::printMessage(printMSG_error, "%s Error: The LowLevel protocol could not be initialised again! The LL_Init acknowledgement is missing or an error! (time: %0.3f)\n",
+					this->DeviceIDClass, RehaMove3::GetCurrentTime());
+		}
+	}
+
+	if (this->rmStatus.HybridSequenceOffloaded.Load()){
+		this->rmStatus.HybridSequenceOffloaded.Store(false);
+		this->Stats.HybridFallbacks.Add(1);
+		RehaMove3::logMessage(printMSG_rmSendCMD, rmLog_HybridFallback, 1, RehaMove3::GetCurrentTime());
+	}
+}
+
 bool RehaMove3::SendNewCustomLowLevelSequence(CustomLlSequenceConfig_t *CustomSequenceConfig, uint64_t *SequenceID)
 {
+	// time stamp of this step for the messages below
+	RehaMove3::GetCurrentTime(true);
 	// make sure the device is initialised
 	*SequenceID = 0;
-	if (!this->rmStatus.DeviceInitialised || !this->rmStatus.DeviceLlIsInitialised){
+	if (!this->rmStatus.DeviceInitialised.Load() || !this->rmStatus.DeviceLlIsInitialised.Load()){
 		return false;
 	}
 	/*
 	 * Handling StimulationErrors e.g. electrode errors
 	 */
-	if (this->rmStatus.DoNotStimulate){
+	if (this->rmStatus.DoNotStimulate.Load()){
 		if ( this->rmStatus.DoReTestTheStimError){
 			this->rmStatus.NumberOfSequencesUntilErrorRetest--;
 			if (this->rmStatus.NumberOfSequencesUntilErrorRetest != 0){
 				// do not re-test for the errors yet
-				this->Stats.SequencesSend++;
-				this->Stats.SequencesFailed++;
+				this->Stats.SequencesSend.Add(1);
+				this->Stats.SequencesFailed.Add(1);
 				return false;
 			} else {
 				// do re-test for the errors ....
 				this->rmStatus.DoReTestTheStimError = false;
-				this->rmStatus.DoNotStimulate = false;
+				this->rmStatus.DoNotStimulate.Store(false);
 			}
 		} else {
 			// do not re-test for the errors ever
-			this->Stats.SequencesSend++;
-			this->Stats.SequencesFailed++;
+			this->Stats.SequencesSend.Add(1);
+			this->Stats.SequencesFailed.Add(1);
 			return false;
 		}
 	}
@@ -1093,39 +2655,49 @@ bool RehaMove3::SendNewCustomLowLevelSequence(CustomLlSequenceConfig_t *CustomSe
 		/*
 		 * Debug output of this pulse
 		 */
-		if (this->rmInitSettings.DebugConfig.printStimInfos){
+		if (this->rmInitSettings.DebugConfig.printStimInfos || this->BinaryLog.Active.Load()){
 			// Stimulation configuration
-			RehaMove3::printMessage(printMSG_rmPulseConfig, "  Pulse %u -> Channel=%u\n",i_Pulse+1, (uint8_t)ll_channel_config.channel+1);
+			RehaMove3::logMessage(printMSG_rmPulseConfig, rmLog_LlPulseChannel, 2, (double)(i_Pulse+1), (double)((uint8_t)ll_channel_config.channel+1));
 			for (iPoint=0; iPoint<ll_channel_config.number_of_points; iPoint++) {
-				RehaMove3::printMessage(printMSG_rmPulseConfig, "     PointConfig% 3d: Duration=% 4iµs; Current=% +7.2fmA; (Mode=%i; IM=%i)\n",
-						iPoint+1, ll_channel_config.points[iPoint].time, ll_channel_config.points[iPoint].current, ll_channel_config.points[iPoint].control_mode, ll_channel_config.points[iPoint].interpolation_mode );
+				RehaMove3::logMessage(printMSG_rmPulseConfig, rmLog_PointConfig, 5,
+						(double)(iPoint+1), (double)ll_channel_config.points[iPoint].time, (double)ll_channel_config.points[iPoint].current, (double)ll_channel_config.points[iPoint].control_mode, (double)ll_channel_config.points[iPoint].interpolation_mode );
 			}
 		}
 
-		/*
-		 * Prepare for acks and sequence statistics
-		 */
-		ll_channel_config.packet_number = GetPackageNumber();
-
 		/*
 		 * Check the configuration and send it
+		 * -> the package number is taken under the send lock, so the numbers of concurrent senders do not interleave
 		 */
 		if (smpt_is_valid_ll_channel_config(&ll_channel_config)) {
 			// Send the Ll_channel_list command to RehaMove
-			if (smpt_send_ll_channel_config(&(this->Device), &ll_channel_config)){
+			RM3_TRACE_MUTEX_LOCK(rmTrace_LockSendPackage, &(this->SendPackage_mutex));
+			// the reconnect closes the interface with the send lock held -> check the device again under the lock
+			if (!this->rmStatus.DeviceInitialised.Load()){
+				pthread_mutex_unlock(&(this->SendPackage_mutex));
+				break;
+			}
+			ll_channel_config.packet_number = GetPackageNumber();
+			bool ChannelConfigSend = smpt_send_ll_channel_config(&(this->Device), &ll_channel_config);
+			pthread_mutex_unlock(&(this->SendPackage_mutex));
+			if (ChannelConfigSend){
+				RM3_TRACE_INSTANT(rmTrace_LlPulseSend, ll_channel_config.packet_number);
 				OneOrMorePulsesSend = true;
-				this->Stats.StimultionPulsesSend++;
+				this->Stats.StimultionPulsesSend.Add(1);
+				this->Stats.Channel[ll_channel_config.channel].PulsesSend.Add(1);
 				// add the expected response to the ChannelResponse queue
-				*SequenceID = PutLLChannelResponseExpectation(this->Stats.SequencesSend+1, ll_channel_config.channel, ll_channel_config.packet_number);
+				*SequenceID = PutLLChannelResponseExpectation(this->Stats.SequencesSend.Load()+1, ll_channel_config.channel, ll_channel_config.packet_number);
 			} else {
 				// error: failed to send the configuration
 				RehaMove3::printMessage(printMSG_error, "%s Error: The channel configuration could not be send! (time: %0.3f; pulse: %u)\n", this->DeviceIDClass, RehaMove3::GetCurrentTime(), i_Pulse);
-				this->Stats.StimultionPulsesNotSend++;
+				this->Stats.SendErrors.Add(1);
+				this->Stats.StimultionPulsesNotSend.Add(1);
+				this->Stats.Channel[ll_channel_config.channel].PulsesNotSend.Add(1);
 			}
 		} else {
 			// error: channel configuration is INvalid
 			RehaMove3::printMessage(printMSG_rmSequenceError, "%s Error: The channel configuration is NOT valid! The pulse was not send! (time: %0.3f; pulse: %u)\n", this->DeviceIDClass, RehaMove3::GetCurrentTime(), i_Pulse);
-			this->Stats.StimultionPulsesNotSend++;
+			this->Stats.StimultionPulsesNotSend.Add(1);
+			this->Stats.Channel[ll_channel_config.channel].PulsesNotSend.Add(1);
 		}
 	} // for loop
 
@@ -1136,15 +2708,78 @@ bool RehaMove3::SendNewCustomLowLevelSequence(CustomLlSequenceConfig_t *CustomSe
 
 	// done sending the sequence configuration
 	if (OneOrMorePulsesSend){
-		this->Stats.SequencesSend++;
+		this->Stats.SequencesSend.Add(1);
 	}
 	return true;
 }
 
 bool RehaMove3::SendMidLevelUpdate(MlUpdateConfig_t *UpdateConfig)
 {
+	RM3_TRACE_SCOPE(rmTrace_MlUpdate, 0);
+	// make sure the device is initialised
+	if (!this->rmStatus.DeviceInitialised.Load() || !this->rmStatus.DeviceMlIsInitialised.Load()){
+		return false;
+	}
+	if (!this->rmStatus.MlUpdateThreatRunning.Load()){
+		return RehaMove3::SendMidLevelUpdateNow(UpdateConfig, 1);
+	}
+
+	// post the update -> an older update, which was not send yet, is overwritten; its ForceUpdate/RedoRamp requests are kept
+	bool NotSendYet = this->rmSettings.MidLevel.MailboxFull.Load();
+	bool ForceUpdate = NotSendYet && this->rmSettings.MidLevel.MailboxConfig.ForceUpdate;
+	bool RedoRamp    = NotSendYet && this->rmSettings.MidLevel.MailboxConfig.RedoRamp;
+	this->rmSettings.MidLevel.MailboxLock.WriteBegin();
+	memcpy(&this->rmSettings.MidLevel.MailboxConfig, UpdateConfig, sizeof(MlUpdateConfig_t));
+	this->rmSettings.MidLevel.MailboxConfig.ForceUpdate |= ForceUpdate;
+	this->rmSettings.MidLevel.MailboxConfig.RedoRamp    |= RedoRamp;
+	this->rmSettings.MidLevel.MailboxLock.WriteEnd();
+	this->rmSettings.MidLevel.MailboxFull.Store(true);
+	this->rmSettings.MidLevel.MailboxPosted.FetchAdd(1);
+	return true;
+}
+
+void RehaMove3::RunMidLevelUpdateSender(void)
+{
+	this->rmStatus.MlUpdateThreatRunning.Store(true);
+	MlUpdateConfig_t UpdateConfig;
+	uint32_t Sequence = 0;
+	uint64_t TimeNow_us = 0, NextSend_us = 0;
+	// the keep alive and ramp counters count the update calls of the step, not the coalesced sends of this threat
+	uint64_t Posted = 0, LastPosted = this->rmSettings.MidLevel.MailboxPosted.Load();
+	uint64_t MinPeriod_us = (this->rmInitSettings.MidLevelConfig.UpdateMinPeriod_ms > 0.0) ? (uint64_t)(this->rmInitSettings.MidLevelConfig.UpdateMinPeriod_ms *1000.0) : 0;
+
+	while (this->rmStatus.MlUpdateThreatActive.Load()){
+		TimeNow_us = RehaMove3::GetTimeStamp_us();
+		if ((TimeNow_us >= NextSend_us) && this->rmSettings.MidLevel.MailboxFull.Exchange(false)){
+			// take the latest update; retry if it was overwritten while copying it
+			do {
+				Sequence = this->rmSettings.MidLevel.MailboxLock.ReadBegin();
+				memcpy(&UpdateConfig, &this->rmSettings.MidLevel.MailboxConfig, sizeof(MlUpdateConfig_t));
+			} while (this->rmSettings.MidLevel.MailboxLock.ReadRetry(Sequence));
+			Posted = this->rmSettings.MidLevel.MailboxPosted.Load();
+			RehaMove3::SendMidLevelUpdateNow(&UpdateConfig, (Posted > LastPosted) ? (uint32_t)(Posted - LastPosted) : 1);
+			LastPosted = Posted;
+			this->rmSettings.MidLevel.MailboxSend.FetchAdd(1);
+			NextSend_us = TimeNow_us + MinPeriod_us;
+		} else {
+			RehaMove3::SleepFor_us(REHAMOVE_MLUPDATE_THREAD_DELAY_US);
+		}
+	}
+
+	// done
+	this->rmStatus.MlUpdateThreatRunning.Store(false);
+}
+
+bool RehaMove3::SendMidLevelUpdateNow(MlUpdateConfig_t *UpdateConfig, uint32_t NumberOfCalls)
+{
+	/*
+	 * NumberOfCalls: update calls of the step since the last call of this function -> 1 without the update threat; the coalesced
+	 * updates of the update threat count all calls, so the keep alive and ramp intervals stay in update calls of the step
+	 */
+	// time stamp of this step for the messages below
+	RehaMove3::GetCurrentTime(true);
 	// make sure the device is initialised
-	if (!this->rmStatus.DeviceInitialised || !this->rmStatus.DeviceMlIsInitialised){
+	if (!this->rmStatus.DeviceInitialised.Load() || !this->rmStatus.DeviceMlIsInitialised.Load()){
 		return false;
 	}
 
@@ -1152,17 +2787,17 @@ bool RehaMove3::SendMidLevelUpdate(MlUpdateConfig_t *UpdateConfig)
 	if (!UpdateConfig->ForceUpdate){
 		if (memcmp(&this->rmSettings.MidLevel.CurrentMlStimConfig, UpdateConfig, sizeof(MlUpdateConfig_t)) == 0){
 			// the sequence config is identical to the old config -> do not send an update
-			this->rmSettings.MidLevel.UpdateCallsSinceLastUpdate++;
+			this->rmSettings.MidLevel.UpdateCallsSinceLastUpdate += NumberOfCalls;
 
 			// send keep alive signal if needed -> only necessary if the UpdateConfig has not changed
-			if (this->rmInitSettings.MidLevelConfig.SendKeepAliveSignalDuringPeriodicMlUpdateCall){
+			// (the timer driven keep alive signal is independent of the update calls)
+			if (this->rmInitSettings.MidLevelConfig.SendKeepAliveSignalDuringPeriodicMlUpdateCall && !this->rmStatus.KeepAliveThreatRunning.Load()){
 				// the update function is called periodical and is used to trigger the keep alive signal
-				if (this->rmSettings.MidLevel.UpdateCallsUntilKeepAliveSignal <= 0.0){
+				this->rmSettings.MidLevel.UpdateCallsUntilKeepAliveSignal -= (int32_t)NumberOfCalls;
+				if (this->rmSettings.MidLevel.UpdateCallsUntilKeepAliveSignal < 0){
 					// the keep alive signal must be send
 					RehaMove3::SendMidLevelKeepAliveSignal();
 					this->rmSettings.MidLevel.UpdateCallsUntilKeepAliveSignal = (int32_t)this->rmInitSettings.MidLevelConfig.KeepAliveNumberOfUpdateCalls;
-				} else {
-					this->rmSettings.MidLevel.UpdateCallsUntilKeepAliveSignal--;
 				}
 			}
 
@@ -1170,7 +2805,7 @@ bool RehaMove3::SendMidLevelUpdate(MlUpdateConfig_t *UpdateConfig)
 			if (this->rmInitSettings.MidLevelConfig.SetRampsDuringPeriodicMlUpdateCall){
 				for (uint8_t iCh=0; iCh<REHAMOVE_NUMBER_OF_CHANNELS; iCh++){
 					if (this->rmSettings.MidLevel.ChannelDisabled[iCh]){
-						this->rmSettings.MidLevel.UpdateCallsUntilRedoRamp[iCh]--;
+						this->rmSettings.MidLevel.UpdateCallsUntilRedoRamp[iCh] -= (int32_t)NumberOfCalls;
 					}
 				}
 			}
@@ -1181,16 +2816,16 @@ bool RehaMove3::SendMidLevelUpdate(MlUpdateConfig_t *UpdateConfig)
 	/*
 	 * Handling StimulationErrors e.g. electrode errors
 	 */
-	if (this->rmStatus.DoNotStimulate){
+	if (this->rmStatus.DoNotStimulate.Load()){
 		if (this->rmStatus.DoReTestTheStimError){
-			this->rmStatus.NumberOfSequencesUntilErrorRetest--;
+			this->rmStatus.NumberOfSequencesUntilErrorRetest = (this->rmStatus.NumberOfSequencesUntilErrorRetest > NumberOfCalls) ? (uint16_t)(this->rmStatus.NumberOfSequencesUntilErrorRetest - NumberOfCalls) : 0;
 			if (this->rmStatus.NumberOfSequencesUntilErrorRetest != 0){
 				// do not re-test for the errors yet
 				return false;
 			} else {
 				// do re-test for the errors ....
 				this->rmStatus.DoReTestTheStimError = false;
-				this->rmStatus.DoNotStimulate = false;
+				this->rmStatus.DoNotStimulate.Store(false);
 			}
 		} else {
 			// do not re-test for the errors ever
@@ -1205,6 +2840,8 @@ bool RehaMove3::SendMidLevelUpdate(MlUpdateConfig_t *UpdateConfig)
 	uint16_t PulseWidth[REHAMOVE_SHAPES__NUMBER_OF_POINTS_MAX] = {}, tempPW = 0;
 	float 	 Current[REHAMOVE_SHAPES__NUMBER_OF_POINTS_MAX] = {}, tempI = 0;
 	double 	 ChargeOverAll = 0.0;
+	uint32_t PulseDuration = 0;
+	LlPulseConfig_t MlPulse;
 
 	// Struct for UpdateConfig command
 	Smpt_ml_update mlConfig;
@@ -1225,7 +2862,7 @@ bool RehaMove3::SendMidLevelUpdate(MlUpdateConfig_t *UpdateConfig)
 				// update the variables for the ramp-feature
 				if (this->rmInitSettings.MidLevelConfig.SetRampsDuringPeriodicMlUpdateCall){
 					this->rmSettings.MidLevel.ChannelDisabled[iCh] = true;
-					this->rmSettings.MidLevel.UpdateCallsUntilRedoRamp[iCh]--;
+					this->rmSettings.MidLevel.UpdateCallsUntilRedoRamp[iCh] -= (int32_t)NumberOfCalls;
 				}
 				continue;
 			}
@@ -1253,29 +2890,46 @@ bool RehaMove3::SendMidLevelUpdate(MlUpdateConfig_t *UpdateConfig)
 						this->DeviceIDClass, RehaMove3::GetCurrentTime(), iCh+1, tempI, UpdateConfig->PulseConfig[iCh].Current);
 			}
 
-			// build point list
+			// build point list -> same pulse forms as in the LowLevel mode
 			switch (UpdateConfig->PulseConfig[iCh].Shape) {
-			case Shape_Balanced_Symetric_Biphasic:
-				iPoint = 0;
-				PulseWidth[iPoint] = UpdateConfig->PulseConfig[iCh].PulseWidth;    	// positive pulse
-				Current[iPoint++] = UpdateConfig->PulseConfig[iCh].Current;
-				PulseWidth[iPoint] = 100;                                				// 100us break
-				Current[iPoint++] = 0.0;
-				PulseWidth[iPoint] = UpdateConfig->PulseConfig[iCh].PulseWidth;    	// negative pulse
-				Current[iPoint++] = -1.0 * UpdateConfig->PulseConfig[iCh].Current;
-				ChargeOverAll += 0;
-				NumberOfPoints = iPoint;
-				break;
-			/*
-			 * Done with the pulse form generation
-			 */
+			case Shape_UNbalanced_UNsymetric_Biphasic_FIRST:
+			case Shape_UNbalanced_UNsymetric_Biphasic_SECOUND:
+			case Shape_Balanced_UNsymetric_Biphasic_FIRST:
+			case Shape_Balanced_UNsymetric_Biphasic_SECOUND:
+			case Shape_Balanced_UNsymetric_LONG_Biphasic_FIRST:
+			case Shape_Balanced_UNsymetric_LONG_Biphasic_SECOUND:
+			case Shape_UNbalanced_Charge_Compensation:
+				// 6-11 need a second pulse configuration and 16 the charge of a whole sequence -> only one pulse per channel in the MidLevel mode
+				RehaMove3::printMessage(printMSG_error, "%s Error: The requested shape %u is not supported in the MidLevel mode! (time: %0.3f; channel: %u)\n", this->DeviceIDClass, UpdateConfig->PulseConfig[iCh].Shape, RehaMove3::GetCurrentTime(), iCh);
+				continue;
 			default:
-				// error: unknown shape
-				RehaMove3::printMessage(printMSG_error, "%s Error: The requested shape %u is invalid! (time: %0.3f; channel: %u)\n", this->DeviceIDClass, UpdateConfig->PulseConfig[iCh].Shape, RehaMove3::GetCurrentTime(), iCh);
+				break;
+			}
+			MlPulse.Channel    = UpdateConfig->PulseConfig[iCh].Channel;
+			MlPulse.Shape      = UpdateConfig->PulseConfig[iCh].Shape;
+			MlPulse.PulseWidth = UpdateConfig->PulseConfig[iCh].PulseWidth;
+			MlPulse.Current    = UpdateConfig->PulseConfig[iCh].Current;
+			ChargeOverAll = 0.0;
+			NumberOfPoints = RehaMove3::BuildPulseForm(&MlPulse, NULL, PulseWidth, Current, &ChargeOverAll, iCh);
+			if (NumberOfPoints == 0){
+				// no points -> do not enable this channel
+				continue;
+			}
+			if (NumberOfPoints > Smpt_Length_Points){
+				RehaMove3::printMessage(printMSG_error, "%s Error: The pulse form of channel %u needs %u points, but only %u are supported! (time: %0.3f)\n", this->DeviceIDClass, iCh+1, NumberOfPoints, Smpt_Length_Points, RehaMove3::GetCurrentTime());
+				continue;
+			}
+			// the whole pulse has to fit into one stimulation period
+			PulseDuration = 0;
+			for (iPoint = 0; iPoint < NumberOfPoints; iPoint++) {
+				PulseDuration += PulseWidth[iPoint];
+			}
+			if ((UpdateConfig->PulseConfig[iCh].Frequency <= 0.0) || (PulseDuration >= (1.0/UpdateConfig->PulseConfig[iCh].Frequency)*1000000)){
+				RehaMove3::printMessage(printMSG_error, "%s Error: The pulse form of channel %u (%u µs) does not fit into the stimulation period (frequency: %4.2fHz)! (time: %0.3f)\n", this->DeviceIDClass, iCh+1, PulseDuration, UpdateConfig->PulseConfig[iCh].Frequency, RehaMove3::GetCurrentTime());
 				continue;
 			}
 
-			if (ChargeOverAll > 1.0) {
+			if (fabs(ChargeOverAll) > 1.0) {
 				RehaMove3::printMessage(printMSG_rmWarningCorrectionChargeInbalace, "%s Charge Unbalanced:\n   -> The remaining charge over all points is still != 0 but is %0.2f mAuS! (time: %0.3f; pulse: %u)\n", this->DeviceIDClass, ChargeOverAll, RehaMove3::GetCurrentTime(), iCh);
 			}
 
@@ -1288,7 +2942,7 @@ bool RehaMove3::SendMidLevelUpdate(MlUpdateConfig_t *UpdateConfig)
 					// update the variables for the ramp-feature
 					if (UpdateConfig->PulseConfig[iCh].Current == 0.0){
 						this->rmSettings.MidLevel.ChannelDisabled[iCh] = true;
-						this->rmSettings.MidLevel.UpdateCallsUntilRedoRamp[iCh]--;
+						this->rmSettings.MidLevel.UpdateCallsUntilRedoRamp[iCh] -= (int32_t)NumberOfCalls;
 						mlConfig.channel_config[iCh].ramp = 0;
 					} else {
 						this->rmSettings.MidLevel.ChannelDisabled[iCh] = false;
@@ -1319,12 +2973,12 @@ bool RehaMove3::SendMidLevelUpdate(MlUpdateConfig_t *UpdateConfig)
 			/*
 			 * Debug output of this pulse
 			 */
-			if (this->rmInitSettings.DebugConfig.printStimInfos){
+			if (this->rmInitSettings.DebugConfig.printStimInfos || this->BinaryLog.Active.Load()){
 				// Stimulation configuration
-				RehaMove3::printMessage(printMSG_rmPulseConfig, "  Channel=%u; -> Frequency=%4.2fHz; Shape=%u; PW=%u; I=%0.1f; Ramp=%u\n",iCh+1, UpdateConfig->PulseConfig[iCh].Frequency, UpdateConfig->PulseConfig[iCh].Shape, UpdateConfig->PulseConfig[iCh].PulseWidth, UpdateConfig->PulseConfig[iCh].Current, mlConfig.channel_config[iCh].ramp);
+				RehaMove3::logMessage(printMSG_rmPulseConfig, rmLog_MlChannel, 6, (double)(iCh+1), (double)UpdateConfig->PulseConfig[iCh].Frequency, (double)UpdateConfig->PulseConfig[iCh].Shape, (double)UpdateConfig->PulseConfig[iCh].PulseWidth, (double)UpdateConfig->PulseConfig[iCh].Current, (double)mlConfig.channel_config[iCh].ramp);
 				for (iPoint=0; iPoint<mlConfig.channel_config[iCh].number_of_points; iPoint++) {
-					RehaMove3::printMessage(printMSG_rmPulseConfig, "     PointConfig% 3d: Duration=% 4iµs; Current=% +7.2fmA; (Mode=%i; IM=%i)\n",
-						iPoint+1, mlConfig.channel_config[iCh].points[iPoint].time, mlConfig.channel_config[iCh].points[iPoint].current, mlConfig.channel_config[iCh].points[iPoint].control_mode, mlConfig.channel_config[iCh].points[iPoint].interpolation_mode );
+					RehaMove3::logMessage(printMSG_rmPulseConfig, rmLog_PointConfig, 5,
+						(double)(iPoint+1), (double)mlConfig.channel_config[iCh].points[iPoint].time, (double)mlConfig.channel_config[iCh].points[iPoint].current, (double)mlConfig.channel_config[iCh].points[iPoint].control_mode, (double)mlConfig.channel_config[iCh].points[iPoint].interpolation_mode );
 				}
 			}
 
@@ -1335,7 +2989,7 @@ bool RehaMove3::SendMidLevelUpdate(MlUpdateConfig_t *UpdateConfig)
 			// update the variables for the ramp-feature
 			if (this->rmInitSettings.MidLevelConfig.SetRampsDuringPeriodicMlUpdateCall){
 				this->rmSettings.MidLevel.ChannelDisabled[iCh] = true;
-				this->rmSettings.MidLevel.UpdateCallsUntilRedoRamp[iCh]--;
+				this->rmSettings.MidLevel.UpdateCallsUntilRedoRamp[iCh] -= (int32_t)NumberOfCalls;
 			}
 		}
 	} // for loop
@@ -1348,42 +3002,55 @@ bool RehaMove3::SendMidLevelUpdate(MlUpdateConfig_t *UpdateConfig)
 	// SoftStart Feature
 	mlConfig.softstart = this->rmInitSettings.MidLevelConfig.UseSoftStart;
 
-	/*
-	 * Prepare for acks and sequence statistics
-	 */
-	mlConfig.packet_number = GetPackageNumber();
-
 	/*
 	 * Check the configuration and send it
 	 */
+	// lock the serial interface -> the keep alive thread sends as well
+	RM3_TRACE_MUTEX_LOCK(rmTrace_LockSendPackage, &(this->SendPackage_mutex));
+	// the reconnect closes the interface with the send lock held -> check the device again under the lock
+	if (!this->rmStatus.DeviceInitialised.Load()){
+		pthread_mutex_unlock(&(this->SendPackage_mutex));
+		return false;
+	}
+	mlConfig.packet_number = GetPackageNumber();
 	if (smpt_is_valid_ml_update(&mlConfig)) {
 		// Send the Ll_channel_list command to RehaMove
 		if (smpt_send_ml_update(&(this->Device), &mlConfig)){
-			this->Stats.UpdatesSend++;
+			RM3_TRACE_INSTANT(rmTrace_MlUpdateSend, mlConfig.packet_number);
+			// the time is used to measure the latency of the acknowledgement
+			this->rmSettings.MidLevel.UpdateLastSend_us.Store(RehaMove3::GetTimeStamp_us());
+			pthread_mutex_unlock(&(this->SendPackage_mutex));
+			this->Stats.UpdatesSend.Add(1);
 			// copy the stimulation config to make sure we do not send it again
 			memcpy(&this->rmSettings.MidLevel.CurrentMlStimConfig, &this->rmSettings.MidLevel.CurrentMlStimConfigTemp, sizeof(MlUpdateConfig_t));
 			// response is handled in the first response handler
 			// keep alive signal -> set this value to 2 UpdateFunction calls calls, so that we get the information about an electrode error rather sooner than later
 			this->rmSettings.MidLevel.UpdateCallsUntilKeepAliveSignal = 2; //(int32_t)this->rmInitSettings.MidLevelConfig.KeepAliveNumberOfInOutCalls;
-			// lock the acks struct
-			pthread_mutex_lock(&(this->AcksLock_mutex));
-			this->Acks.G_ml_StimActive = false;
-			this->Acks.G_ml_StimError = false;
+			// same for the timer driven keep alive signal
+			uint64_t KeepAliveSoon_us = RehaMove3::GetTimeStamp_us() + (uint64_t)REHAMOVE_KEEPALIVE_AFTER_UPDATE_MS*1000;
+			if (KeepAliveSoon_us < this->rmSettings.MidLevel.KeepAliveNextSend_us.Load()){
+				this->rmSettings.MidLevel.KeepAliveNextSend_us.Store(KeepAliveSoon_us);
+			}
+			// the stimulation is active, if one channel is enabled
+			bool StimActive = false;
 			for (uint8_t iCh=0; iCh<REHAMOVE_NUMBER_OF_CHANNELS; iCh++){
 				if (mlConfig.enable_channel[iCh]){
-					this->Acks.G_ml_StimActive = true;
-					break;
+					StimActive = true;
+					this->Stats.Channel[iCh].UpdatesActive.Add(1);
 				}
 			}
-			// unlock the acks struct
-			pthread_mutex_unlock(&(this->AcksLock_mutex));
+			this->Acks.G_ml_StimError.Store(false);
+			this->Acks.G_ml_StimActive.Store(StimActive);
 			return true;
 		} else {
+			pthread_mutex_unlock(&(this->SendPackage_mutex));
 			// error: failed to send the configuration
 			RehaMove3::printMessage(printMSG_error, "%s Error: The stimulation update could not be send! (time: %0.3f)\n", this->DeviceIDClass, RehaMove3::GetCurrentTime());
+			this->Stats.SendErrors.Add(1);
 			return false;
 		}
 	} else {
+		pthread_mutex_unlock(&(this->SendPackage_mutex));
 		// error: channel configuration is INvalid
 		RehaMove3::printMessage(printMSG_rmSequenceError, "%s Error: The stimulation update configuration is not valid! (time: %0.3f)\n", this->DeviceIDClass, RehaMove3::GetCurrentTime());
 		return false;
@@ -1392,22 +3059,94 @@ bool RehaMove3::SendMidLevelUpdate(MlUpdateConfig_t *UpdateConfig)
 	return false;
 }
 
-bool RehaMove3::SendMidLevelKeepAliveSignal(void)
+bool RehaMove3::SendMidLevelKeepAliveSignal(void)
+{
+	// make sure the device is initialised
+	if (!this->rmStatus.DeviceInitialised.Load() || !this->rmStatus.DeviceMlIsInitialised.Load()){
+		return false;
+	}
+
+	Smpt_ml_get_current_data ml_get_current_data;
+	smpt_clear_ml_get_current_data(&ml_get_current_data);
+
+	ml_get_current_data.data_selection[0] = true;
+	ml_get_current_data.data_selection[1] = true;
+
+	// lock the serial interface -> this function is called by the step function and by the keep alive thread
+	pthread_mutex_lock(&(this->SendPackage_mutex));
+	if (!this->rmStatus.DeviceInitialised.Load()){
+		pthread_mutex_unlock(&(this->SendPackage_mutex));
+		return false;
+	}
+	ml_get_current_data.packet_number = GetPackageNumber();
+	// the response is handled in the response handler
+	bool ReturnValue = smpt_send_ml_get_current_data(&this->Device, &ml_get_current_data);
+	if (ReturnValue){
+		// the time is used to measure the latency of the acknowledgement
+		this->rmSettings.MidLevel.KeepAliveLastSend_us.Store(RehaMove3::GetTimeStamp_us());
+	} else {
+		this->Stats.SendErrors.Add(1);
+	}
+	pthread_mutex_unlock(&(this->SendPackage_mutex));
+	return ReturnValue;
+}
+
+void RehaMove3::RunMidLevelKeepAliveTimer(void)
+{
+	this->rmStatus.KeepAliveThreatRunning.Store(true);
+	uint64_t TimeNow_us = 0;
+
+	this->rmSettings.MidLevel.KeepAliveNextSend_us.Store(RehaMove3::GetTimeStamp_us() + RehaMove3::GetMidLevelKeepAlivePeriod_us());
+	while (this->rmStatus.KeepAliveThreatActive.Load()){
+		TimeNow_us = RehaMove3::GetTimeStamp_us();
+		if (TimeNow_us >= this->rmSettings.MidLevel.KeepAliveNextSend_us.Load()){
+			// the keep alive signal is due -> the response is handled by the receiver and feeds the electrode error handling
+			if (!RehaMove3::SendMidLevelKeepAliveSignal()){
+				RehaMove3::printMessage(printMSG_error, "%s Error: The keep alive signal could not be send! (time: %0.3f)\n", this->DeviceIDClass, RehaMove3::GetCurrentTime(true));
+			}
+			this->rmSettings.MidLevel.KeepAliveNextSend_us.Store(TimeNow_us + RehaMove3::GetMidLevelKeepAlivePeriod_us());
+		}
+		RehaMove3::SleepFor_us(REHAMOVE_KEEPALIVE_THREAD_DELAY_US);
+	}
+
+	// done
+	this->rmStatus.KeepAliveThreatRunning.Store(false);
+}
+
+uint64_t RehaMove3::GetMidLevelKeepAlivePeriod_us(void)
+{
+	// the acknowledgement must arrive within the configured period -> subtract the observed latency (with margin)
+	uint64_t Period_us  = (uint64_t)(this->rmSettings.MidLevel.KeepAlivePeriod_ms *1000.0);
+	uint64_t Latency_us = 2 *this->rmSettings.MidLevel.KeepAliveAckLatency_us.Load();
+	Period_us = (Period_us > Latency_us) ? (Period_us - Latency_us) : 0;
+	if (Period_us < (uint64_t)REHAMOVE_KEEPALIVE_PERIOD_MIN_MS*1000){
+		Period_us = (uint64_t)REHAMOVE_KEEPALIVE_PERIOD_MIN_MS*1000;
+	}
+	return Period_us;
+}
+
+bool RehaMove3::GetLowLevelSequenceTiming(uint64_t SequenceID, uint64_t *SendTime_us, uint64_t *AckTime_us)
+{
+	// the timing of the first pulse is kept after the sequence was taken from the queue -> only for the last acknowledged sequence
+	bool ReturnValue = false;
+	pthread_mutex_lock(&(this->LlSequenceQueueLock_mutex));
+	if ((SequenceID != 0) && (this->rmStatus.LlFirstPulseSequenceNumber == SequenceID)){
+		if (SendTime_us != NULL){
+			*SendTime_us = this->rmStatus.LlFirstPulseSendTime_us;
+		}
+		if (AckTime_us != NULL){
+			*AckTime_us = this->rmStatus.LlFirstPulseAckTime_us;
+		}
+		ReturnValue = true;
+	}
+	pthread_mutex_unlock(&(this->LlSequenceQueueLock_mutex));
+	return ReturnValue;
+}
+
+uint64_t RehaMove3::GetLowLevelAckLatency_us(void)
 {
-	// make sure the device is initialised
-	if (!this->rmStatus.DeviceInitialised || !this->rmStatus.DeviceMlIsInitialised){
-		return false;
-	}
-
-	Smpt_ml_get_current_data ml_get_current_data;
-	smpt_clear_ml_get_current_data(&ml_get_current_data);
-
-	ml_get_current_data.data_selection[0] = true;
-	ml_get_current_data.data_selection[1] = true;
-	ml_get_current_data.packet_number = GetPackageNumber();
-
-	// the response is handled in the response handler
-	return smpt_send_ml_get_current_data(&this->Device, &ml_get_current_data);
+	// 0 -> no LowLevel acknowledgement was received yet
+	return this->rmStatus.LlAckLatencyMean_us.Load();
 }
 
 bool RehaMove3::GetLastLowLevelStimulationResult(double *PulseErrors, uint64_t SequenceID)
@@ -1416,6 +3155,11 @@ bool RehaMove3::GetLastLowLevelStimulationResult(double *PulseErrors, uint64_t S
 	if (PulseErrors != NULL){
 		*PulseErrors = 0.0;
 	}
+	// hybrid mode: the sequence was executed by the device -> there are no LowLevel acknowledgements
+	// -> otherwise no sequence was send (ID 0); the queue below reports why
+	if ((SequenceID == 0) && this->rmStatus.HybridSequenceOffloaded.Load()){
+		return RehaMove3::GetLastMidLevelStimulationResult(PulseErrors);
+	}
 	// check for ACKs and process them
 	RehaMove3::ReadAcksBlocking();
 	// lock the  sequence queue
@@ -1441,7 +3185,8 @@ bool RehaMove3::GetLastLowLevelStimulationResult(double *PulseErrors, uint64_t S
 		}
 		if (this->LlSequenceQueue.Queue[iQueue].SequenceNumber != SequenceID){
 			// the sequence ID was not found
-			RehaMove3::printMessage(printMSG_rmErrorUnclaimedSequence, "%s Error: The sequence ID %lu was not found in the acknowledgement queue!\n", this->DeviceIDClass, SequenceID);
+			pthread_mutex_unlock(&(this->LlSequenceQueueLock_mutex));
+			RehaMove3::printMessage(printMSG_rmErrorUnclaimedSequence, "%s Error: The sequence ID %" PRIu64 " was not found in the acknowledgement queue!\n", this->DeviceIDClass, SequenceID);
 			if (PulseErrors != NULL){
 				*PulseErrors = 0.0;
 			}
@@ -1485,7 +3230,7 @@ bool RehaMove3::GetLastLowLevelStimulationResult(double *PulseErrors, uint64_t S
 		} else {
 			// no, the sequence did NOT receive acks for all pulses -> wait, maybe the function was called before the stimulator could answer
 
-			RehaMove3::printMessage(printMSG_rmErrorUnclaimedSequence, "%s Error: The sequence %lu contains %d unacknowledged pulses! (time=%fs)\n",
+			RehaMove3::printMessage(printMSG_rmErrorUnclaimedSequence, "%s Error: The sequence %" PRIu64 " contains %d unacknowledged pulses! (time=%fs)\n",
 					this->DeviceIDClass, this->LlSequenceQueue.Queue[iQueue].SequenceNumber, (this->LlSequenceQueue.Queue[iQueue].NumberOfPulses -this->LlSequenceQueue.Queue[iQueue].NumberOfAcks), RehaMove3::GetCurrentTime(true));
 			// is there another sequence?
 /*			if (this->LlSequenceQueue.QueueSize > 1) {
@@ -1514,7 +3259,7 @@ bool RehaMove3::GetLastLowLevelStimulationResult(double *PulseErrors, uint64_t S
 	} else {
 		// no there is no sequence
 		// is stimulation disabled?
-		if (this->rmStatus.DoNotStimulate){
+		if (this->rmStatus.DoNotStimulate.Load()){
 			// yes, no stimulation -> return false and errors
 			// optional output
 			if (PulseErrors != NULL){
@@ -1541,11 +3286,20 @@ bool RehaMove3::GetLastMidLevelStimulationResult(double *PulseErrors)
 	}
 	// check for ACKs and process them
 	RehaMove3::ReadAcksBlocking();
-	// lock the global ACKs
-	pthread_mutex_lock(&(this->AcksLock_mutex));
+	if (!this->Acks.G_ml_current_data_valid.Load()){
+		// no state received yet
+		return ReturnValue;
+	}
+	// consistent copy of the last state
+	Smpt_ml_get_current_data_ack MlCurrentDataAck;
+	uint32_t Sequence = 0;
+	do {
+		Sequence = this->Acks.G_ml_current_data_lock.ReadBegin();
+		memcpy(&MlCurrentDataAck, &this->Acks.G_ml_current_data_ack, sizeof(Smpt_ml_get_current_data_ack));
+	} while (this->Acks.G_ml_current_data_lock.ReadRetry(Sequence));
 
 	for (uint8_t iCh=0; iCh<REHAMOVE_NUMBER_OF_CHANNELS; iCh++){
-		if (this->Acks.G_ml_current_data_ack.stimulation_data.electrode_error[iCh]){
+		if (MlCurrentDataAck.stimulation_data.electrode_error[iCh]){
 			if (PulseErrors != NULL){
 				*PulseErrors = iCh +1;
 			}
@@ -1553,29 +3307,36 @@ bool RehaMove3::GetLastMidLevelStimulationResult(double *PulseErrors)
 		}
 	}
 
-	// unlock the ACKs
-	pthread_mutex_unlock(&(this->AcksLock_mutex));
-
 	return ReturnValue;
 }
 
 bool RehaMove3::DeInitialiseDevice(bool doPrintInfos, bool doPrintStats)
 {
-	if (this->rmStatus.InitThreatRunning){
-		this->rmStatus.InitThreatActive  = false;
+	// the watchdog would initialise the device again
+	RehaMove3::StopReconnectWatchdog();
+	if (this->rmStatus.InitThreatRunning.Load()){
+		this->rmStatus.InitThreatActive.Store(false);
 	}
-	if (this->rmStatus.DeviceInitialised) {
-		if (this->rmStatus.DeviceLlIsInitialised){
+	if (this->rmStatus.DeviceInitialised.Load()) {
+		// stop all threads that send commands first -> the stop commands are the last commands send to the device
+		RehaMove3::StopDeviceCheck();
+		RehaMove3::StopStatusPoller();
+		RehaMove3::StopMidLevelUpdateSender();
+		RehaMove3::StopMidLevelKeepAliveTimer();
+		if (this->rmStatus.DeviceLlIsInitialised.Load()){
 			/*
 			 * LowLevel
 			 */
 			// send the ll_stop command
-			if (smpt_send_ll_stop(&(this->Device), RehaMove3::GetPackageNumber())) {
+			pthread_mutex_lock(&(this->SendPackage_mutex));
+			bool LlStopSend = smpt_send_ll_stop(&(this->Device), RehaMove3::GetPackageNumber());
+			pthread_mutex_unlock(&(this->SendPackage_mutex));
+			if (LlStopSend) {
 				if (RehaMove3::GetResponse(Smpt_Cmd_Ll_Stop_Ack, true, 500) != Smpt_Cmd_Ll_Stop_Ack) {
 					RehaMove3::printMessage(printMSG_error, "%s Error: The device could not be DEinitialised! The LL_Stop acknowledgement is missing!\n", this->DeviceIDClass);
 				} else {
 					// response received -> deinitialise the device
-					this->rmStatus.DeviceLlIsInitialised = false;
+					this->rmStatus.DeviceLlIsInitialised.Store(false);
 				}
 			} else {
 				RehaMove3::printMessage(printMSG_error, "%s Error: Sending the command %d failed!\n", this->DeviceIDClass, Smpt_Cmd_Ll_Stop_Ack);
@@ -1583,17 +3344,20 @@ bool RehaMove3::DeInitialiseDevice(bool doPrintInfos, bool doPrintStats)
 			}
 			// done
 		}
-		if (this->rmStatus.DeviceMlIsInitialised){
+		if (this->rmStatus.DeviceMlIsInitialised.Load()){
 			/*
 			 * MidLevel
 			 */
 			// send the ml_stop command
-			if (smpt_send_ml_stop(&(this->Device), RehaMove3::GetPackageNumber())) {
+			pthread_mutex_lock(&(this->SendPackage_mutex));
+			bool MlStopSend = smpt_send_ml_stop(&(this->Device), RehaMove3::GetPackageNumber());
+			pthread_mutex_unlock(&(this->SendPackage_mutex));
+			if (MlStopSend) {
 				if (RehaMove3::GetResponse(Smpt_Cmd_Ml_Stop_Ack, true, 500) != Smpt_Cmd_Ml_Stop_Ack) {
 					RehaMove3::printMessage(printMSG_error, "%s Error: The device could not be DEinitialised! The ML_Stop acknowledgement is missing!\n", this->DeviceIDClass);
 				} else {
 					// response received -> deinitialise the device
-					this->rmStatus.DeviceMlIsInitialised = false;
+					this->rmStatus.DeviceMlIsInitialised.Store(false);
 				}
 			} else {
 				RehaMove3::printMessage(printMSG_error, "%s Error: Sending the command %d failed!\n", this->DeviceIDClass, Smpt_Cmd_Ml_Stop_Ack);
@@ -1605,7 +3369,10 @@ bool RehaMove3::DeInitialiseDevice(bool doPrintInfos, bool doPrintStats)
 		 * General
 		 */
 		// get the current status
-		if (smpt_send_get_battery_status(&(this->Device), RehaMove3::GetPackageNumber())) {
+		pthread_mutex_lock(&(this->SendPackage_mutex));
+		bool BatterySend = smpt_send_get_battery_status(&(this->Device), RehaMove3::GetPackageNumber());
+		pthread_mutex_unlock(&(this->SendPackage_mutex));
+		if (BatterySend) {
 			if (!RehaMove3::NewStatusUpdateReceived(500)) {
 				RehaMove3::printMessage(printMSG_error, "%s Error: The current device status could net be read!\n", this->DeviceIDClass);
 			}
@@ -1620,8 +3387,13 @@ bool RehaMove3::DeInitialiseDevice(bool doPrintInfos, bool doPrintStats)
 
 	//Close device
 	RehaMove3::CloseSerial();
+	// write the trace
+	if (this->rmInitSettings.DebugConfig.TraceFile[0] != 0){
+		RM3_TRACE_DUMP(this->rmInitSettings.DebugConfig.TraceFile);
+	}
+	RehaMove3::CloseBinaryLog();
 	// done -> resets
-	this->rmStatus.DeviceInitialised = false;
+	this->rmStatus.DeviceInitialised.Store(false);
 	return true;
 }
 
@@ -1636,13 +3408,16 @@ RehaMove3::rmGetStatus_t RehaMove3::GetCurrentStatus(bool DoPrintStatus, bool Do
 		return tempStatus;
 	}
 
-	// update the status first?
-	if (WaitTimeout > 0){
+	// update the status first? -> not needed if the status thread requests the status
+	if ((WaitTimeout > 0) && !this->rmStatus.StatusPollThreatRunning.Load()){
 		/*
 		 * Checks
 		 */
 		// get the current stim status -> saving the data is done in the response handlers
-		if (smpt_send_get_stim_status(&(this->Device), RehaMove3::GetPackageNumber())) {
+		pthread_mutex_lock(&(this->SendPackage_mutex));
+		bool RequestStimSend = smpt_send_get_stim_status(&(this->Device), RehaMove3::GetPackageNumber());
+		pthread_mutex_unlock(&(this->SendPackage_mutex));
+		if (RequestStimSend) {
 			if (!RehaMove3::NewStatusUpdateReceived(200)){
 				RehaMove3::printMessage(printMSG_error, "%s Error: The current status for 'stim' could net be read!\n", this->DeviceIDClass);
 			}
@@ -1651,7 +3426,10 @@ RehaMove3::rmGetStatus_t RehaMove3::GetCurrentStatus(bool DoPrintStatus, bool Do
 		}
 
 		// get the current main status -> saving the data is done in the response handlers
-		if (smpt_send_get_main_status(&(this->Device), RehaMove3::GetPackageNumber())) {
+		pthread_mutex_lock(&(this->SendPackage_mutex));
+		bool RequestMainSend = smpt_send_get_main_status(&(this->Device), RehaMove3::GetPackageNumber());
+		pthread_mutex_unlock(&(this->SendPackage_mutex));
+		if (RequestMainSend) {
 			if (!RehaMove3::NewStatusUpdateReceived(200)){
 				RehaMove3::printMessage(printMSG_error, "%s Error: The current status for 'main' could net be read!\n", this->DeviceIDClass);
 			}
@@ -1660,7 +3438,10 @@ RehaMove3::rmGetStatus_t RehaMove3::GetCurrentStatus(bool DoPrintStatus, bool Do
 		}
 
 		// get the current battery status -> saving the data is done in the response handlers
-		if (smpt_send_get_battery_status(&(this->Device), RehaMove3::GetPackageNumber())) {
+		pthread_mutex_lock(&(this->SendPackage_mutex));
+		bool RequestBatterySend = smpt_send_get_battery_status(&(this->Device), RehaMove3::GetPackageNumber());
+		pthread_mutex_unlock(&(this->SendPackage_mutex));
+		if (RequestBatterySend) {
 			if (!RehaMove3::NewStatusUpdateReceived(500)){
 				RehaMove3::printMessage(printMSG_error, "%s Error: The current device status could net be read!\n", this->DeviceIDClass);
 			}
@@ -1668,23 +3449,33 @@ RehaMove3::rmGetStatus_t RehaMove3::GetCurrentStatus(bool DoPrintStatus, bool Do
 			RehaMove3::printMessage(printMSG_error, "%s Error: Sending the command %d failed!\n", this->DeviceIDClass, Smpt_Cmd_Get_Battery_Status);
 		}
 	}
+	// the status is printed directly -> print the queued messages first
+	if (DoPrintStatus || DoPrintStatistic){
+		RehaMove3::FlushLogMessages();
+	}
 	// print the status to the terminal?
 	if (DoPrintStatus){
-		struct timeval time;gettimeofday(&time,NULL);
-		uint64_t CurrentTime = (uint64_t)(time.tv_sec*1000.0) + (uint64_t)(time.tv_usec/1000.0) + 1;
+		uint64_t CurrentTime = (RehaMove3::GetTimeStamp_ns() - this->rmStatus.StartTime_ns) /1000000 + 1;
+		time_t StartWallTime = (time_t)(this->rmStatus.StartWallTime_us /1000000);
+		struct tm StartWallTime_tm;
+		char StartWallTimeString[30] = "unknown";
+		if (localtime_r(&StartWallTime, &StartWallTime_tm) != NULL){
+			strftime(StartWallTimeString, sizeof(StartWallTimeString), "%Y-%m-%d %H:%M:%S", &StartWallTime_tm);
+		}
 		// status
-		printf("%s: Status Report\n     -> Interface: %s\n     -> Device ID: %s\n     -> Battery Voltage: %d%% (%0.2fV)\n     -> Last updated: %0.3f seconds ago\n     -> Init Threat running: %s\n     -> Receiver Threat running: %s\n",
-				this->DeviceIDClass, this->DeviceFileName, this->rmStatus.Device.DeviceID, this->rmStatus.Device.BatteryLevel, this->rmStatus.Device.BatteryVoltage, ((double)(CurrentTime - this->rmStatus.StartTime_ms - this->rmStatus.LastUpdated))/1000, this->rmStatus.InitThreatRunning ? "yes":"no", this->rmStatus.ReceiverThreatRunning ? "yes":"no");
+		printf("%s: Status Report\n     -> Session started: %s\n     -> Interface: %s\n     -> Device ID: %s\n     -> Battery Voltage: %d%% (%0.2fV)\n     -> Last updated: %0.3f seconds ago\n     -> Init Threat running: %s\n     -> Receiver Threat running: %s\n     -> Status Threat running: %s\n",
+				this->DeviceIDClass, StartWallTimeString, this->DeviceFileName, this->rmStatus.Device.DeviceID, this->rmStatus.Device.BatteryLevel, this->rmStatus.Device.BatteryVoltage, ((double)(CurrentTime - this->rmStatus.LastUpdated.Load()))/1000, this->rmStatus.InitThreatRunning.Load() ? "yes":"no", this->rmStatus.ReceiverThreatRunning.Load() ? "yes":"no", this->rmStatus.StatusPollThreatRunning.Load() ? "yes":"no");
 		switch (this->rmSettings.CommProtocol){
 		case REHAMOVE_MODE_LOWLEVEL_PREDEDINED:
 		case REHAMOVE_MODE_LOWLEVEL_CUSTOM:
 			printf("     -> LowLevel:\n        -> Initialised: %s\n        -> Current/Last High Voltage: %dV\n        -> Abort after %u stimulation errors\n        -> Resume the stimulation after %d sequences\n\n",
-					this->rmStatus.DeviceLlIsInitialised ? "yes":"no", this->rmStatus.Device.HighVoltageVoltage, this->rmSettings.NumberOfErrorsAfterWhichToAbort, this->rmSettings.NumberOfSequencesAfterWhichToRetestForError);
+					this->rmStatus.DeviceLlIsInitialised.Load() ? "yes":"no", this->rmStatus.Device.HighVoltageVoltage, this->rmSettings.NumberOfErrorsAfterWhichToAbort, this->rmSettings.NumberOfSequencesAfterWhichToRetestForError);
 			break;
 		case REHAMOVE_MODE_MIDLEVEL:
-			printf("     -> MidLevel:\n        -> Initialised: %s\n        -> Current/Last High Voltage: %dV\n        -> Stimulation Frequency: %2.2fHz; (Change the frequency dynamically: %s)\n        -> Send KeepAlive Signal via periodic MidLevelUpdate call: %s; (Number of calls between updates: %2.0f)\n        -> Do a SoftStart: %s\n        -> Ramp up the Stimulation intensity: %s (For %1.0f pulses; Redo after %1.0f zero updates; Set via periodic Update call: %s)\n        -> Abort after %u stimulation errors\n        -> Resume the stimulation after %d stimulation updates\n\n",
-								this->rmStatus.DeviceMlIsInitialised ? "yes":"no", this->rmStatus.Device.HighVoltageVoltage, this->rmInitSettings.MidLevelConfig.GeneralStimFrequency,  this->rmInitSettings.MidLevelConfig.UseDynamicStimulationFrequncy ? "yes":"no",
+			printf("     -> MidLevel:\n        -> Initialised: %s\n        -> Current/Last High Voltage: %dV\n        -> Stimulation Frequency: %2.2fHz; (Change the frequency dynamically: %s)\n        -> Send KeepAlive Signal via periodic MidLevelUpdate call: %s; (Number of calls between updates: %2.0f)\n        -> Send KeepAlive Signal via timer: %s; (Period: %1.0fms; Ack latency: %0.2fms)\n        -> Do a SoftStart: %s\n        -> Ramp up the Stimulation intensity: %s (For %1.0f pulses; Redo after %1.0f zero updates; Set via periodic Update call: %s)\n        -> Abort after %u stimulation errors\n        -> Resume the stimulation after %d stimulation updates\n\n",
+								this->rmStatus.DeviceMlIsInitialised.Load() ? "yes":"no", this->rmStatus.Device.HighVoltageVoltage, this->rmInitSettings.MidLevelConfig.GeneralStimFrequency,  this->rmInitSettings.MidLevelConfig.UseDynamicStimulationFrequncy ? "yes":"no",
 										this->rmInitSettings.MidLevelConfig.SendKeepAliveSignalDuringPeriodicMlUpdateCall ? "yes":"no", this->rmInitSettings.MidLevelConfig.KeepAliveNumberOfUpdateCalls,
+										this->rmStatus.KeepAliveThreatRunning.Load() ? "yes":"no", this->rmSettings.MidLevel.KeepAlivePeriod_ms, ((double)this->rmSettings.MidLevel.KeepAliveAckLatency_us.Load())/1000.0,
 										this->rmInitSettings.MidLevelConfig.UseSoftStart ? "yes":"no", this->rmInitSettings.MidLevelConfig.UseRamps ? "yes":"no", this->rmInitSettings.MidLevelConfig.RampsUpdates, this->rmInitSettings.MidLevelConfig.RampsZeroUpdates, this->rmInitSettings.MidLevelConfig.SetRampsDuringPeriodicMlUpdateCall ? "yes":"no",
 										this->rmSettings.NumberOfErrorsAfterWhichToAbort, this->rmSettings.NumberOfSequencesAfterWhichToRetestForError);
 			break;
@@ -1693,42 +3484,222 @@ RehaMove3::rmGetStatus_t RehaMove3::GetCurrentStatus(bool DoPrintStatus, bool Do
 	// print the statistics to the terminal?
 	if (DoPrintStatistic){
 		// statistic
+		rmStatistics_t Stat = RehaMove3::GetStatistics();
 		switch (this->rmSettings.CommProtocol){
 		case REHAMOVE_MODE_LOWLEVEL_PREDEDINED:
 		case REHAMOVE_MODE_LOWLEVEL_CUSTOM:
-			printf("%s: Statistic Report LowLevel:\n     -> Pulse SEQUENCES send: %lu (%lu pulses send; %lu pulses NOT send)\n        -> Successful: %lu (%lu pulses)\n        -> Unsuccessful: %lu (%lu pulses)\n           -> Stimulation Error: %lu\n        -> Missing: %lu\n",
-					this->DeviceIDClass, this->Stats.SequencesSend, this->Stats.StimultionPulsesSend, this->Stats.StimultionPulsesNotSend, this->Stats.SequencesSuccessful,
-					this->Stats.StimultionPulsesSuccessful, this->Stats.SequencesFailed, this->Stats.StimultionPulsesFailed, this->Stats.SequencesFailed_StimError,	(this->Stats.SequencesSend - (this->Stats.SequencesSuccessful + this->Stats.SequencesFailed)) );
+			printf("%s: Statistic Report LowLevel:\n     -> Pulse SEQUENCES send: %" PRIu64 " (%" PRIu64 " pulses send; %" PRIu64 " pulses NOT send)\n        -> Successful: %" PRIu64 " (%" PRIu64 " pulses)\n        -> Unsuccessful: %" PRIu64 " (%" PRIu64 " pulses)\n           -> Stimulation Error: %" PRIu64 "\n        -> Missing: %" PRIu64 "\n",
+					this->DeviceIDClass, Stat.SequencesSend, Stat.StimultionPulsesSend, Stat.StimultionPulsesNotSend, Stat.SequencesSuccessful,
+					Stat.StimultionPulsesSuccessful, Stat.SequencesFailed, Stat.StimultionPulsesFailed, Stat.SequencesFailed_StimError,	(Stat.SequencesSend - (Stat.SequencesSuccessful + Stat.SequencesFailed)) );
+			for (uint8_t iCh=0; iCh<REHAMOVE_NUMBER_OF_CHANNELS; iCh++){
+				printf("        -> Channel %u: %" PRIu64 " pulses send; %" PRIu64 " pulses NOT send; %" PRIu64 " successful; %" PRIu64 " stimulation errors\n",
+						iCh+1, Stat.Channel[iCh].PulsesSend, Stat.Channel[iCh].PulsesNotSend, Stat.Channel[iCh].PulsesSuccessful, Stat.Channel[iCh].PulsesFailed_StimError);
+			}
+			if (this->rmInitSettings.LowLevelConfig.UseHybridMode){
+				printf("     -> Sequences executed by the device (hybrid mode): %" PRIu64 "\n        -> Hand overs: %" PRIu64 "; Fall backs: %" PRIu64 "\n",
+						Stat.HybridSequencesOffloaded, Stat.HybridOffloads, Stat.HybridFallbacks);
+			}
 			break;
 		case REHAMOVE_MODE_MIDLEVEL:
-			printf("%s: Statistic Report MidLevel:\n     -> Updates send: %lu\n        -> Stimulation Errors: %lu\n",
-								this->DeviceIDClass, this->Stats.UpdatesSend, this->Stats.UpdatesFailed_StimError );
+			printf("%s: Statistic Report MidLevel:\n     -> Updates send: %" PRIu64 "\n        -> Stimulation Errors: %" PRIu64 "\n",
+								this->DeviceIDClass, Stat.UpdatesSend, Stat.UpdatesFailed_StimError );
+			for (uint8_t iCh=0; iCh<REHAMOVE_NUMBER_OF_CHANNELS; iCh++){
+				printf("        -> Channel %u: active in %" PRIu64 " updates\n", iCh+1, Stat.Channel[iCh].UpdatesActive);
+			}
+			if (this->rmInitSettings.MidLevelConfig.UseUpdateMailbox){
+				printf("     -> Updates posted: %" PRIu64 "\n        -> Taken by the update thread: %" PRIu64 "\n        -> Superseded by a newer update: %" PRIu64 "\n",
+						Stat.UpdatesPosted, Stat.UpdatesTaken, (Stat.UpdatesPosted > Stat.UpdatesTaken) ? (Stat.UpdatesPosted - Stat.UpdatesTaken) : 0);
+			}
 			break;
 		}
 
-		printf("     -> Input Corrections:\n        -> Invalid Input: %lu pulses\n        -> Current correction (to high): %u pulses\n        -> Current correction (to low):  %u pulses\n        -> Pulsewidth correction (to high): %u pulses\n        -> Pulsewidth correction (to low):  %u pulses\n",
-				this->Stats.InvalidInput, this->Stats.InputCorrections_CurrentOver, this->Stats.InputCorrections_CurrentUnder, this->Stats.InputCorrections_PulswidthOver, this->Stats.InputCorrections_PulswidthUnder);
+		printf("     -> Input Corrections:\n        -> Invalid Input: %" PRIu64 " pulses\n        -> Current correction (to high): %" PRIu64 " pulses\n        -> Current correction (to low):  %" PRIu64 " pulses\n        -> Pulsewidth correction (to high): %" PRIu64 " pulses\n        -> Pulsewidth correction (to low):  %" PRIu64 " pulses\n",
+				Stat.InvalidInput, Stat.InputCorrections_CurrentOver, Stat.InputCorrections_CurrentUnder, Stat.InputCorrections_PulswidthOver, Stat.InputCorrections_PulswidthUnder);
+		if ((Stat.SendErrors > 0) || (Stat.Reconnects > 0)){
+			printf("     -> Connection:\n        -> Send errors: %" PRIu64 "\n        -> Reconnects: %" PRIu64 "\n", Stat.SendErrors, Stat.Reconnects);
+		}
+		if (Stat.LogMessagesDropped > 0){
+			printf("     -> Log messages dropped (log queue full): %" PRIu64 "\n", Stat.LogMessagesDropped);
+		}
+		if (Stat.BinaryLogRecordsDropped > 0){
+			printf("     -> Binary log records dropped (queue full or write error): %" PRIu64 "\n", Stat.BinaryLogRecordsDropped);
+		}
 	}
 
 	rmGetStatus_t CurrentState = {};
-	CurrentState.DeviceIsOpen = this->rmStatus.DeviceIsOpen;
-	CurrentState.DeviceLlIsInitialised = this->rmStatus.DeviceLlIsInitialised;
-	CurrentState.DeviceMlIsInitialised = this->rmStatus.DeviceMlIsInitialised;
-	CurrentState.DeviceInitialised     = this->rmStatus.DeviceInitialised;
-	CurrentState.LastUpdated        = this->rmStatus.LastUpdated;
-	CurrentState.DoNotStimulate     = this->rmStatus.DoNotStimulate;
-	CurrentState.NumberOfStimErrors = this->rmStatus.NumberOfStimErrors;
-	CurrentState.BatteryLevel       = this->rmStatus.Device.BatteryLevel;
-	CurrentState.BatteryVoltage     = this->rmStatus.Device.BatteryVoltage;
-	CurrentState.HighVoltageVoltage = this->rmStatus.Device.HighVoltageVoltage;
+	CurrentState.DeviceIsOpen = this->rmStatus.DeviceIsOpen.Load();
+	CurrentState.DeviceLlIsInitialised = this->rmStatus.DeviceLlIsInitialised.Load();
+	CurrentState.DeviceMlIsInitialised = this->rmStatus.DeviceMlIsInitialised.Load();
+	CurrentState.DeviceInitialised     = this->rmStatus.DeviceInitialised.Load();
+	CurrentState.Reconnecting          = this->rmStatus.Reconnecting.Load();
+	CurrentState.LastUpdated        = this->rmStatus.LastUpdated.Load();
+	CurrentState.DoNotStimulate     = this->rmStatus.DoNotStimulate.Load();
+	CurrentState.NumberOfStimErrors = this->rmStatus.NumberOfStimErrors.Load();
+	// device status -> consistent copy of the values written by the receiver
+	rmStatus_t::rmStatusSnapshot_t Snapshot;
+	uint32_t Sequence = 0;
+	do {
+		Sequence = this->rmStatus.SnapshotLock.ReadBegin();
+		memcpy(&Snapshot, &this->rmStatus.Snapshot, sizeof(Snapshot));
+	} while (this->rmStatus.SnapshotLock.ReadRetry(Sequence));
+	uint64_t TimeNow_us = RehaMove3::GetTimeStamp_us();
+	CurrentState.BatteryLevel       = Snapshot.BatteryLevel;
+	CurrentState.BatteryVoltage     = Snapshot.BatteryVoltage;
+	CurrentState.HighVoltageVoltage = Snapshot.HighVoltageVoltage;
+	CurrentState.MainStatus         = Snapshot.MainStatus;
+	CurrentState.StimStatus         = Snapshot.StimStatus;
+	CurrentState.BatteryAge_ms      = (Snapshot.BatteryUpdated_us    != 0) ? ((double)(TimeNow_us - Snapshot.BatteryUpdated_us))/1000.0    : -1.0;
+	CurrentState.MainStatusAge_ms   = (Snapshot.MainStatusUpdated_us != 0) ? ((double)(TimeNow_us - Snapshot.MainStatusUpdated_us))/1000.0 : -1.0;
+	CurrentState.StimStatusAge_ms   = (Snapshot.StimStatusUpdated_us != 0) ? ((double)(TimeNow_us - Snapshot.StimStatusUpdated_us))/1000.0 : -1.0;
 	// return the current status
 	return CurrentState;
 }
 
+RehaMove3::rmStatistics_t RehaMove3::GetStatistics(void)
+{
+	// the counters are independent of each other -> every value is read atomically, the snapshot as whole is not
+	rmStatistics_t Stat;
+	memset(&Stat, 0, sizeof(Stat));
+	Stat.InvalidInput 					 = this->Stats.InvalidInput.Load();
+	Stat.InputCorrections_PulswidthOver  = this->Stats.InputCorrections_PulswidthOver.Load();
+	Stat.InputCorrections_PulswidthUnder = this->Stats.InputCorrections_PulswidthUnder.Load();
+	Stat.InputCorrections_CurrentOver 	 = this->Stats.InputCorrections_CurrentOver.Load();
+	Stat.InputCorrections_CurrentUnder 	 = this->Stats.InputCorrections_CurrentUnder.Load();
+	Stat.SequencesSend 					 = this->Stats.SequencesSend.Load();
+	Stat.SequencesSuccessful 			 = this->Stats.SequencesSuccessful.Load();
+	Stat.SequencesFailed 				 = this->Stats.SequencesFailed.Load();
+	Stat.SequencesFailed_StimError 		 = this->Stats.SequencesFailed_StimError.Load();
+	Stat.StimultionPulsesSend 			 = this->Stats.StimultionPulsesSend.Load();
+	Stat.StimultionPulsesNotSend 		 = this->Stats.StimultionPulsesNotSend.Load();
+	Stat.StimultionPulsesSuccessful 	 = this->Stats.StimultionPulsesSuccessful.Load();
+	Stat.StimultionPulsesFailed 		 = this->Stats.StimultionPulsesFailed.Load();
+	Stat.StimultionPulsesFailed_StimError = this->Stats.StimultionPulsesFailed_StimError.Load();
+	Stat.HybridSequencesOffloaded 		 = this->Stats.HybridSequencesOffloaded.Load();
+	Stat.HybridOffloads 				 = this->Stats.HybridOffloads.Load();
+	Stat.HybridFallbacks 				 = this->Stats.HybridFallbacks.Load();
+	Stat.UpdatesSend 					 = this->Stats.UpdatesSend.Load();
+	Stat.UpdatesFailed_StimError 		 = this->Stats.UpdatesFailed_StimError.Load();
+	Stat.UpdatesPosted 					 = this->rmSettings.MidLevel.MailboxPosted.Load();
+	Stat.UpdatesTaken 					 = this->rmSettings.MidLevel.MailboxSend.Load();
+	Stat.SendErrors 					 = this->Stats.SendErrors.Load();
+	Stat.Reconnects 					 = this->Stats.Reconnects.Load();
+	for (uint8_t iCh=0; iCh<REHAMOVE_NUMBER_OF_CHANNELS; iCh++){
+		Stat.Channel[iCh].PulsesSend 			 = this->Stats.Channel[iCh].PulsesSend.Load();
+		Stat.Channel[iCh].PulsesNotSend 		 = this->Stats.Channel[iCh].PulsesNotSend.Load();
+		Stat.Channel[iCh].PulsesSuccessful 		 = this->Stats.Channel[iCh].PulsesSuccessful.Load();
+		Stat.Channel[iCh].PulsesFailed_StimError = this->Stats.Channel[iCh].PulsesFailed_StimError.Load();
+		Stat.Channel[iCh].UpdatesActive 		 = this->Stats.Channel[iCh].UpdatesActive.Load();
+	}
+	Stat.LogMessagesDropped 			 = this->LogQueue.Dropped.Load();
+	Stat.BinaryLogRecordsDropped 		 = this->BinaryLog.Dropped.Load();
+	return Stat;
+}
+
+bool RehaMove3::WriteStatisticsFile(const char *FileName)
+{
+	/*
+	 * Write the statistics in the Prometheus text format (e.g. for the node exporter textfile collector)
+	 * -> the file is written to a temporary file first and then renamed, so the reader never sees a partial file
+	 */
+	if ((FileName == NULL) || (FileName[0] == 0)){
+		return false;
+	}
+	char TempFileName[300], Label[150];
+	if (snprintf(TempFileName, sizeof(TempFileName), "%s.tmp", FileName) >= (int)sizeof(TempFileName)){
+		return false;
+	}
+	// device label -> remove the characters which are not allowed in a label value
+	uint8_t iLabel = 0;
+	for (uint8_t i = 0; (this->DeviceIDClass[i] != 0) && (iLabel < sizeof(Label)-1); i++){
+		if ((this->DeviceIDClass[i] != '"') && (this->DeviceIDClass[i] != '\\') && (this->DeviceIDClass[i] != '\n')){
+			Label[iLabel++] = this->DeviceIDClass[i];
+		}
+	}
+	Label[iLabel] = 0;
+
+	rmStatistics_t Stat = RehaMove3::GetStatistics();
+	struct rmStatisticsExport_t {
+		const char *Name;
+		const char *Help;
+		uint64_t 	Value;
+	} Counters[] = {
+		{"invalid_input", 				"Pulses with invalid input", 								Stat.InvalidInput},
+		{"input_corrections_pulsewidth_over", "Pulses with a corrected (too high) pulse width", 	Stat.InputCorrections_PulswidthOver},
+		{"input_corrections_pulsewidth_under", "Pulses with a corrected (too low) pulse width", 	Stat.InputCorrections_PulswidthUnder},
+		{"input_corrections_current_over", "Pulses with a corrected (too high) current", 			Stat.InputCorrections_CurrentOver},
+		{"input_corrections_current_under", "Pulses with a corrected (too low) current", 			Stat.InputCorrections_CurrentUnder},
+		{"sequences_send", 				"LowLevel sequences send", 									Stat.SequencesSend},
+		{"sequences_successful", 		"LowLevel sequences executed successfully", 				Stat.SequencesSuccessful},
+		{"sequences_failed", 			"LowLevel sequences failed", 								Stat.SequencesFailed},
+		{"sequences_failed_stim_error", "LowLevel sequences failed due to a stimulation error", 	Stat.SequencesFailed_StimError},
+		{"pulses_send", 				"LowLevel pulses send", 									Stat.StimultionPulsesSend},
+		{"pulses_not_send", 			"LowLevel pulses NOT send", 								Stat.StimultionPulsesNotSend},
+		{"pulses_successful", 			"LowLevel pulses executed successfully", 					Stat.StimultionPulsesSuccessful},
+		{"pulses_failed", 				"LowLevel pulses failed", 									Stat.StimultionPulsesFailed},
+		{"pulses_failed_stim_error", 	"LowLevel pulses failed due to a stimulation error", 		Stat.StimultionPulsesFailed_StimError},
+		{"hybrid_sequences_offloaded", 	"LowLevel sequences executed by the device (hybrid mode)", 	Stat.HybridSequencesOffloaded},
+		{"hybrid_offloads", 			"Hand overs to the device (hybrid mode)", 					Stat.HybridOffloads},
+		{"hybrid_fallbacks", 			"Fall backs to the LowLevel mode (hybrid mode)", 			Stat.HybridFallbacks},
+		{"updates_send", 				"MidLevel updates send", 									Stat.UpdatesSend},
+		{"updates_failed_stim_error", 	"MidLevel updates with a stimulation error", 				Stat.UpdatesFailed_StimError},
+		{"updates_posted", 				"MidLevel updates posted to the update thread", 			Stat.UpdatesPosted},
+		{"updates_taken", 				"MidLevel updates taken by the update thread", 				Stat.UpdatesTaken},
+		{"send_errors", 				"Commands which could not be send to the device", 			Stat.SendErrors},
+		{"reconnects", 					"Reconnects after the connection to the device was lost", 	Stat.Reconnects},
+		{"log_messages_dropped", 		"Log messages dropped, because the log queue was full", 	Stat.LogMessagesDropped},
+		{"binary_log_records_dropped", 	"Binary log records dropped, because the queue was full or the file could not be written", Stat.BinaryLogRecordsDropped}
+	};
+
+	FILE *File = fopen(TempFileName, "w");
+	if (File == NULL){
+		RehaMove3::printMessage(printMSG_error, "%s Error: The statistics file %s could not be opened:\n     -> %s (%d)\n", this->DeviceIDClass, TempFileName, strerror(errno), errno);
+		return false;
+	}
+	for (uint8_t i = 0; i < sizeof(Counters)/sizeof(Counters[0]); i++){
+		fprintf(File, "# HELP rehamove3_%s_total %s\n# TYPE rehamove3_%s_total counter\nrehamove3_%s_total{device=\"%s\"} %" PRIu64 "\n",
+				Counters[i].Name, Counters[i].Help, Counters[i].Name, Counters[i].Name, Label, Counters[i].Value);
+	}
+	// per channel
+	fprintf(File, "# HELP rehamove3_channel_pulses_send_total LowLevel pulses send per channel\n# TYPE rehamove3_channel_pulses_send_total counter\n");
+	for (uint8_t iCh=0; iCh<REHAMOVE_NUMBER_OF_CHANNELS; iCh++){
+		fprintf(File, "rehamove3_channel_pulses_send_total{device=\"%s\",channel=\"%u\"} %" PRIu64 "\n", Label, iCh+1, Stat.Channel[iCh].PulsesSend);
+	}
+	fprintf(File, "# HELP rehamove3_channel_pulses_not_send_total LowLevel pulses NOT send per channel\n# TYPE rehamove3_channel_pulses_not_send_total counter\n");
+	for (uint8_t iCh=0; iCh<REHAMOVE_NUMBER_OF_CHANNELS; iCh++){
+		fprintf(File, "rehamove3_channel_pulses_not_send_total{device=\"%s\",channel=\"%u\"} %" PRIu64 "\n", Label, iCh+1, Stat.Channel[iCh].PulsesNotSend);
+	}
+	fprintf(File, "# HELP rehamove3_channel_pulses_successful_total LowLevel pulses executed successfully per channel\n# TYPE rehamove3_channel_pulses_successful_total counter\n");
+	for (uint8_t iCh=0; iCh<REHAMOVE_NUMBER_OF_CHANNELS; iCh++){
+		fprintf(File, "rehamove3_channel_pulses_successful_total{device=\"%s\",channel=\"%u\"} %" PRIu64 "\n", Label, iCh+1, Stat.Channel[iCh].PulsesSuccessful);
+	}
+	fprintf(File, "# HELP rehamove3_channel_pulses_failed_stim_error_total LowLevel pulses failed due to a stimulation error per channel\n# TYPE rehamove3_channel_pulses_failed_stim_error_total counter\n");
+	for (uint8_t iCh=0; iCh<REHAMOVE_NUMBER_OF_CHANNELS; iCh++){
+		fprintf(File, "rehamove3_channel_pulses_failed_stim_error_total{device=\"%s\",channel=\"%u\"} %" PRIu64 "\n", Label, iCh+1, Stat.Channel[iCh].PulsesFailed_StimError);
+	}
+	fprintf(File, "# HELP rehamove3_channel_updates_active_total MidLevel updates with the channel enabled\n# TYPE rehamove3_channel_updates_active_total counter\n");
+	for (uint8_t iCh=0; iCh<REHAMOVE_NUMBER_OF_CHANNELS; iCh++){
+		fprintf(File, "rehamove3_channel_updates_active_total{device=\"%s\",channel=\"%u\"} %" PRIu64 "\n", Label, iCh+1, Stat.Channel[iCh].UpdatesActive);
+	}
+	// device state
+	fprintf(File, "# HELP rehamove3_stimulation_disabled Stimulation is disabled due to stimulation errors\n# TYPE rehamove3_stimulation_disabled gauge\nrehamove3_stimulation_disabled{device=\"%s\"} %u\n",
+			Label, this->rmStatus.DoNotStimulate.Load() ? 1 : 0);
+
+	if (fclose(File) != 0){
+		remove(TempFileName);
+		return false;
+	}
+	if (rename(TempFileName, FileName) != 0){
+		RehaMove3::printMessage(printMSG_error, "%s Error: The statistics file %s could not be written:\n     -> %s (%d)\n", this->DeviceIDClass, FileName, strerror(errno), errno);
+		remove(TempFileName);
+		return false;
+	}
+	return true;
+}
+
 
 bool RehaMove3::DoDeviceReset(void)
 {
-	if (this->rmStatus.DeviceIsOpen){
+	if (this->rmStatus.DeviceIsOpen.Load()){
 		// close and open the device
 		RehaMove3::CloseSerial();
 		RehaMove3::OpenSerial();
@@ -1736,7 +3707,10 @@ bool RehaMove3::DoDeviceReset(void)
 
 	// execute the reset
 	RehaMove3::printMessage(printMSG_warning, "\n%s: Executing a device reset ... ", this->DeviceIDClass);
-	if (smpt_send_reset(&(this->Device), RehaMove3::GetPackageNumber())) {
+	pthread_mutex_lock(&(this->SendPackage_mutex));
+	bool ResetSend = smpt_send_reset(&(this->Device), RehaMove3::GetPackageNumber());
+	pthread_mutex_unlock(&(this->SendPackage_mutex));
+	if (ResetSend) {
 		if (RehaMove3::GetResponse(Smpt_Cmd_Reset_Ack, true, 5500) != Smpt_Cmd_Reset_Ack) {
 			RehaMove3::printMessage(printMSG_warning, "should be done. The reset acknowledgement is missing!\n");
 		} else {
@@ -1749,7 +3723,10 @@ bool RehaMove3::DoDeviceReset(void)
 	}
 	// General commands
 	// get the device id
-	if (smpt_send_get_device_id(&(this->Device), RehaMove3::GetPackageNumber())) {
+	pthread_mutex_lock(&(this->SendPackage_mutex));
+	bool DeviceIdSend = smpt_send_get_device_id(&(this->Device), RehaMove3::GetPackageNumber());
+	pthread_mutex_unlock(&(this->SendPackage_mutex));
+	if (DeviceIdSend) {
 		if (RehaMove3::GetResponse(Smpt_Cmd_Get_Device_Id_Ack, true, 200) != Smpt_Cmd_Get_Device_Id_Ack) {
 			// error
 			RehaMove3::printMessage(printMSG_error, "%s Error: The device ID could not be read!\n", this->DeviceIDClass);
@@ -1766,18 +3743,37 @@ bool RehaMove3::DoDeviceReset(void)
 bool RehaMove3::OpenSerial()
 {
 	if (access(this->DeviceFileName, R_OK | W_OK) != -1) {
-		// serial interface exists
-		if (smpt_open_serial_port(&(this->Device), this->DeviceFileName)) {
+		// serial interface exists -> open and lock it at once, so a discovery of this process does not probe it meanwhile
+		pthread_mutex_lock(&DiscoveryLock_mutex);
+		bool IsOpen = smpt_open_serial_port(&(this->Device), this->DeviceFileName);
+		if (IsOpen){
+			// lock the interface -> the discoveries of other processes and of this process do not probe it
+			this->InterfaceLockFile = open(this->DeviceFileName, O_RDWR | O_NOCTTY | O_NONBLOCK);
+			if ((this->InterfaceLockFile >= 0) && (flock(this->InterfaceLockFile, LOCK_EX | LOCK_NB) != 0)){
+				RehaMove3::printMessage(printMSG_warning, "%s Warning: The interface %s is locked by another process!\n", this->DeviceIDClass, this->DeviceFileName);
+			}
+		}
+		pthread_mutex_unlock(&DiscoveryLock_mutex);
+		if (IsOpen) {
 			// opening successful
 			RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: Device %s opened successfully.\n", this->DeviceFileName);
-			this->rmStatus.DeviceIsOpen = true;
+			this->rmStatus.DeviceIsOpen.Store(true);
 			/*
 			 *  Start the receiver threat
 			 */
-			if (this->rmSettings.UseThreadForAcks){
-				this->rmStatus.ReceiverThreatActive = true;
-				if (pthread_create(&(this->ReceiverThread), NULL, ReceiverThreadFunc, (void *)this) != 0) {
-					RehaMove3::printMessage(printMSG_error, "%s Error: The receiver threat could net be started:\n     -> %s (%d)\n", this->DeviceIDClass, strerror(errno), errno);
+			if (this->Manager != NULL){
+				// the acknowledgements are read by the receiver threat of the manager, when the file descriptor of the SMPT device has data
+				if ((this->Device.serial_port_handle_ < 0) || !this->Manager->AttachInterface(this, this->Device.serial_port_handle_)){
+					RehaMove3::printMessage(printMSG_error, "%s Error: The interface %s could not be added to the manager!\n", this->DeviceIDClass, this->DeviceFileName);
+					RehaMove3::CloseSerial();
+					return false;
+				}
+				RehaMove3::printMessage(printMSG_rmDeviceInfo, "RehaMove3 DEBUG: The acknowledgements are read by the manager.\n");
+			} else if (this->rmSettings.UseThreadForAcks){
+				this->rmStatus.ReceiverThreatActive.Store(true);
+				int ThreadReturnValue = RehaMove3::CreateRealTimeThread(&(this->ReceiverThread), ReceiverThreadFunc, "receiver");
+				if (ThreadReturnValue != 0) {
+					RehaMove3::printMessage(printMSG_error, "%s Error: The receiver threat could net be started:\n     -> %s (%d)\n", this->DeviceIDClass, strerror(ThreadReturnValue), ThreadReturnValue);
 					RehaMove3::CloseSerial();
 					return false;
 				}
@@ -1798,34 +3794,48 @@ bool RehaMove3::OpenSerial()
 
 bool RehaMove3::CloseSerial()
 {
-	if (this->rmStatus.DeviceIsOpen) {
-		if (this->rmStatus.InitThreatRunning) {
-			this->rmStatus.InitThreatActive = false;
+	if (this->rmStatus.DeviceIsOpen.Load()) {
+		if (this->rmStatus.InitThreatRunning.Load()) {
+			this->rmStatus.InitThreatActive.Store(false);
+		}
+		if (this->rmStatus.ReceiverThreatRunning.Load()) {
+			this->rmStatus.ReceiverThreatActive.Store(false);
 		}
-		if (this->rmStatus.ReceiverThreatRunning) {
-			this->rmStatus.ReceiverThreatActive = false;
+		RehaMove3::StopDeviceCheck();
+		RehaMove3::StopTelemetryPublisher();
+		RehaMove3::StopStatisticsExporter();
+		RehaMove3::StopStatusPoller();
+		RehaMove3::StopMidLevelUpdateSender();
+		RehaMove3::StopMidLevelKeepAliveTimer();
+		if (this->Manager != NULL){
+			this->Manager->DetachInterface(this);
 		}
-		if (this->rmStatus.InitThreatRunning) {
+		if (this->rmStatus.InitThreatRunning.Load()) {
 			//what for the init threat to stop
 			do {
 				usleep(500);
-			} while (this->rmStatus.InitThreatRunning);
+			} while (this->rmStatus.InitThreatRunning.Load());
 		}
-		if (this->rmStatus.ReceiverThreatRunning) {
+		if (this->rmStatus.ReceiverThreatRunning.Load()) {
 			//what for the receiver threat to stop
 			do {
 				usleep(500);
-			} while (this->rmStatus.ReceiverThreatRunning);
+			} while (this->rmStatus.ReceiverThreatRunning.Load());
 		}
 
+		if (this->InterfaceLockFile >= 0){
+			flock(this->InterfaceLockFile, LOCK_UN);
+			close(this->InterfaceLockFile);
+			this->InterfaceLockFile = -1;
+		}
 		if (smpt_close_serial_port(&(this->Device))) {
-			this->rmStatus.DeviceIsOpen = false;
+			this->rmStatus.DeviceIsOpen.Store(false);
 			return true;
 		} else {
 			return false;
 		}
 	} else {
-		this->rmStatus.DeviceIsOpen = false;
+		this->rmStatus.DeviceIsOpen.Store(false);
 		return true;
 	}
 }
@@ -1896,11 +3906,11 @@ bool RehaMove3::CheckChannel(uint8_t Channel_IN) {
 
 uint16_t RehaMove3::CheckAndCorrectPulsewidth(int PulseWidthIN, bool *Corrected) {
 	if (PulseWidthIN > this->rmSettings.MaxPulseWidth) {
-		this->Stats.InputCorrections_PulswidthOver++;
+		this->Stats.InputCorrections_PulswidthOver.Add(1);
 		*Corrected = true;
 		return this->rmSettings.MaxPulseWidth;
 	} else if (PulseWidthIN < 0) {
-		this->Stats.InputCorrections_PulswidthUnder++;
+		this->Stats.InputCorrections_PulswidthUnder.Add(1);
 		*Corrected = true;
 		return 0;
 	} else {
@@ -1911,11 +3921,11 @@ uint16_t RehaMove3::CheckAndCorrectPulsewidth(int PulseWidthIN, bool *Corrected)
 float RehaMove3::CheckAndCorrectCurrent(float CurrentIN, bool *Corrected)
 {
 	if (CurrentIN > this->rmSettings.MaxCurrent) {
-		this->Stats.InputCorrections_CurrentOver++;
+		this->Stats.InputCorrections_CurrentOver.Add(1);
 		*Corrected = true;
 		return this->rmSettings.MaxCurrent;
 	} else if (CurrentIN < -1*this->rmSettings.MaxCurrent) {
-		this->Stats.InputCorrections_CurrentUnder++;
+		this->Stats.InputCorrections_CurrentUnder.Add(1);
 		*Corrected = true;
 		return -1*this->rmSettings.MaxCurrent;
 	} else {
@@ -1938,6 +3948,231 @@ float RehaMove3::CheckAndCorrectCurrent(float CurrentIN, bool *Corrected)
 	}
 }
 
+uint8_t RehaMove3::BuildPulseForm(LlPulseConfig_t *Pulse, LlPulseConfig_t *NextPulse, uint16_t *PulseWidth, float *Current, double *ChargeOverAll, uint8_t PulseNumber)
+{
+	// builds the point list of one pulse; used by the LowLevel and the MidLevel mode
+	// Pulse         -> pulse configuration; the current sign is adjusted for the NEGATIVE shapes
+	// NextPulse     -> following pulse configuration, needed for the FIRST/SECOUND shapes (NULL if there is none)
+	// ChargeOverAll -> charge of this channel so far; updated with the charge of this pulse
+	// returns the number of points; 0 -> the pulse is not executed
+	uint8_t  NumberOfPoints = 0, iPoint = 0;
+	uint16_t PWStepSize = 0, tempPW = 0;
+	float 	 CurrentSign = 0, CurrentStepSize = 0.0;
+	double 	 Charge = 0.0;
+
+	switch (Pulse->Shape) {
+	case Shape_Balanced_Symetric_Biphasic:
+	case Shape_Balanced_Symetric_Biphasic_NEGATIVE:
+		// 0/1 symmetric biphasic pulse; charge balanced
+		if (Pulse->Shape == Shape_Balanced_Symetric_Biphasic_NEGATIVE){
+			// handle the negative case
+			Pulse->Current = -1.0 *fabsf(Pulse->Current);
+		}
+		iPoint = 0;
+		PulseWidth[iPoint] = Pulse->PulseWidth;    	// positive pulse
+		Current[iPoint++] = Pulse->Current;
+		PulseWidth[iPoint] = 100;                                				// 100us break
+		Current[iPoint++] = 0.0;
+		PulseWidth[iPoint] = Pulse->PulseWidth;    	// negative pulse
+		Current[iPoint++] = -1.0 * Pulse->Current;
+		*ChargeOverAll += 0;
+		NumberOfPoints = iPoint;
+		break;
+
+	case Shape_Balanced_UNsymetric_Biphasic:
+	case Shape_Balanced_UNsymetric_Biphasic_NEGATIVE:
+		// 2/3 unsymmetric biphasic pulse; charge balanced
+		if (Pulse->Shape == Shape_Balanced_UNsymetric_Biphasic_NEGATIVE){
+			// handle the negative case
+			Pulse->Current = -1.0 *fabsf(Pulse->Current);
+		}
+		iPoint = 0;
+		PulseWidth[iPoint]  = Pulse->PulseWidth;    	// positive pulse
+		Current[iPoint]     = Pulse->Current;
+		Charge         		= (double)PulseWidth[iPoint] *Current[iPoint];
+		CurrentSign         = (Current[iPoint] < 0) ? -1.0 : 1.0;
+		iPoint++;
+		PulseWidth[iPoint]  = 100;                                					// 100us break
+		Current[iPoint++]   = 0.0;
+		iPoint += RehaMove3::GetMinimalCurrentPulse(&PulseWidth[iPoint], &Current[iPoint], &Charge, 1); // negative pulse
+		*ChargeOverAll += Charge;
+		NumberOfPoints = iPoint;
+		break;
+
+	case Shape_UNbalanced_UNsymetric_Monophasic:
+	case Shape_UNbalanced_UNsymetric_Monophasic_NEGATIVE:
+		// 4/5 -> monophasic pulse; charge balanced
+		if (Pulse->Shape == Shape_UNbalanced_UNsymetric_Monophasic_NEGATIVE){
+			// handle the negative case
+			Pulse->Current = -1.0 *fabsf(Pulse->Current);
+		}
+		iPoint = 0;
+		PulseWidth[iPoint] = Pulse->PulseWidth;     // first pulse
+		Current[iPoint]    = Pulse->Current;
+		*ChargeOverAll += PulseWidth[iPoint] * Current[iPoint];
+		iPoint++;
+		NumberOfPoints = iPoint;
+		break;
+
+	case Shape_UNbalanced_UNsymetric_Biphasic_FIRST:
+	case Shape_Balanced_UNsymetric_Biphasic_FIRST:
+	case Shape_Balanced_UNsymetric_LONG_Biphasic_FIRST:
+		// 6/8/10 -> first part of a unsymmetric biphasic pulse; polarity depends on the current sign
+		// does the secound pulse exist?
+		if ( (NextPulse != NULL) &&
+			(NextPulse->Shape == Shape_UNbalanced_UNsymetric_Biphasic_SECOUND ||
+			 NextPulse->Shape == Shape_Balanced_UNsymetric_Biphasic_SECOUND   ||
+			 NextPulse->Shape == Shape_Balanced_UNsymetric_LONG_Biphasic_SECOUND)) {
+			iPoint = 0;
+			PulseWidth[iPoint] = Pulse->PulseWidth;   	// first pulse
+			Current[iPoint]    = Pulse->Current;
+			CurrentSign        = (Current[iPoint] < 0) ? -1.0 : 1.0;
+			Charge = PulseWidth[iPoint] *Current[iPoint];
+			iPoint++;
+			PulseWidth[iPoint] = 100;                              					// 100us break
+			Current[iPoint++]  = 0.0;
+			PulseWidth[iPoint] = NextPulse->PulseWidth; // second pulse
+			Current[iPoint]    = -1.0 *CurrentSign	*fabsf(NextPulse->Current);
+			Charge = PulseWidth[iPoint] *Current[iPoint];
+			iPoint++;
+			// charge compensation
+			if (Pulse->Shape == Shape_Balanced_UNsymetric_Biphasic_FIRST) {
+				iPoint += RehaMove3::GetMinimalCurrentPulse(&PulseWidth[iPoint], &Current[iPoint], &Charge, 1);
+			} else if (Pulse->Shape == Shape_Balanced_UNsymetric_LONG_Biphasic_FIRST) {
+				iPoint += RehaMove3::GetMinimalCurrentPulse(&PulseWidth[iPoint], &Current[iPoint], &Charge, 7);
+			}
+			*ChargeOverAll += Charge;
+			NumberOfPoints = iPoint;
+		} else {
+			RehaMove3::printMessage(printMSG_rmSequenceError, "%s Error: The second half of an (UN)Balanced, UNsymmetric, biphasic pulse was not defined!\n     -> Pulse %u is discarded!\n!\n", this->DeviceIDClass, PulseNumber);
+			NumberOfPoints = 0;
+			return 0;
+
+		}
+		break;
+
+	case Shape_UNbalanced_UNsymetric_Biphasic_SECOUND:
+	case Shape_Balanced_UNsymetric_Biphasic_SECOUND:
+	case Shape_Balanced_UNsymetric_LONG_Biphasic_SECOUND:
+		// 7/9/11 -> second part of the unsymmetric biphasic pulse; the configuration was already used -> skip this pulse configuration
+		NumberOfPoints = 0;
+		return 0;
+		break;
+
+	case Shape_Balanced_UNsymetric_RisingTriangle:
+	case Shape_Balanced_UNsymetric_FallingTriangle:
+	case Shape_UNbalanced_UNsymetric_RisingTriangle:
+	case Shape_UNbalanced_UNsymetric_FallingTriangle:
+		{
+		// 12-15 -> Triangle pulse, balanced/UNbanced; polarity is defined by the current sign
+		// Pulse Breite
+		uint8_t tempNumberOfPoints = 0;
+		if (Pulse->Shape == Shape_Balanced_UNsymetric_RisingTriangle ||
+			Pulse->Shape == Shape_Balanced_UNsymetric_FallingTriangle){
+			tempNumberOfPoints = REHAMOVE_SHAPES__TRIAGLE_MAX_POINTS_BI;
+		} else {
+			tempNumberOfPoints = REHAMOVE_SHAPES__TRIAGLE_MAX_POINTS_MONO;
+		}
+		bool WasCorrected;
+		iPoint = 0;
+		Charge = 0.0;
+
+		// NumberOfPoints für den Rechtwinkligen Teil wenn wir dir minimale Breite deines Punktes annehmen
+		NumberOfPoints = (uint8_t) floor(Pulse->PulseWidth / REHAMOVE_SHAPES__PW_MIN);
+		if (NumberOfPoints == 0){
+			// no steps -> this pulse is no executed
+			return 0;
+		}
+		// Falls bei minimaler Breite mehr Punkte als REHAMOVE__TRIAGLE_MAX_POINTS (14?) berechnet wurden, werden nur REHAMOVE__TRIAGLE_MAX_POINTS verwendet und dafür die Pulsbreite vergrößert
+		NumberOfPoints = (NumberOfPoints > tempNumberOfPoints) ? tempNumberOfPoints : NumberOfPoints;
+		// Höhe der Stromstufen
+		CurrentStepSize = RehaMove3::CheckAndCorrectCurrent( fabsf(Pulse->Current / NumberOfPoints), &WasCorrected);
+		if (CurrentStepSize == 0.0){
+			// current step is two small -> this pulse is no executed
+			return 0;
+		}
+		NumberOfPoints = (uint8_t)roundf(Pulse->Current/CurrentStepSize);
+		NumberOfPoints = (NumberOfPoints > tempNumberOfPoints) ? tempNumberOfPoints : NumberOfPoints;
+		// Berechne die Pulsbreite einer Stufe des Dreiecks (Abrunden und dann den ersten Punkt länger machen um genau auf PW_Soll zu kommen)
+		PWStepSize = floor(Pulse->PulseWidth / NumberOfPoints);
+		if (REHAMOVE_SHAPES__TRIAGLE_USE_FIXED_PW_STEP) {
+			// ggf. feste Breite verwenden
+			PWStepSize = (PWStepSize > REHAMOVE_SHAPES__TRIAGLE_PW_STEP) ? REHAMOVE_SHAPES__TRIAGLE_PW_STEP : PWStepSize;
+		}
+		PWStepSize = (PWStepSize < REHAMOVE_SHAPES__PW_MIN) ? REHAMOVE_SHAPES__PW_MIN : PWStepSize;
+
+		CurrentSign    = (Pulse->Current < 0) ? -1.0 : 1.0;
+		tempPW = 0;
+		// calculate the steps of the triangle
+		// point 0
+		PulseWidth[0] = PWStepSize;
+		tempPW += PWStepSize;
+		Current[0] = (float)CurrentStepSize *CurrentSign;
+		Charge += (double)PulseWidth[0] *Current[0];
+		// point 1 - N
+		for (iPoint = 1; iPoint < NumberOfPoints; iPoint++) {
+			PulseWidth[iPoint] = PWStepSize;
+			tempPW += PWStepSize;
+			Current[iPoint] = Current[iPoint -1] +((float)CurrentStepSize *CurrentSign);
+			Charge += (double)PulseWidth[iPoint] *Current[iPoint];
+		}
+		// last step of the triangle
+		int tempPW2 = PulseWidth[iPoint -1] + Pulse->PulseWidth -tempPW;
+		PulseWidth[iPoint -1] = (tempPW2 > 0) ? (uint16_t)tempPW2 : 0;
+		Current[iPoint -1] = Pulse->Current;
+
+		// triangle in first or second flank ?
+		if (Pulse->Shape == Shape_Balanced_UNsymetric_FallingTriangle ||
+			Pulse->Shape == Shape_UNbalanced_UNsymetric_FallingTriangle){
+			// second flank -> reverse the order
+			uint16_t PWtemp[REHAMOVE_SHAPES__NUMBER_OF_POINTS_MAX] = {};
+			float 	 Itemp[REHAMOVE_SHAPES__NUMBER_OF_POINTS_MAX] = {};
+			for (uint8_t iTemp = 0; iTemp < NumberOfPoints; iTemp++) {
+				PWtemp[iTemp] = PulseWidth[NumberOfPoints -1 -iTemp];
+				Itemp[iTemp]  = Current[NumberOfPoints -1 -iTemp];
+			}
+			for (uint8_t iTemp = 0; iTemp < NumberOfPoints; iTemp++) {
+				PulseWidth[iTemp] = PWtemp[iTemp];
+				Current[iTemp]    = Itemp[iTemp];
+			}
+		}
+
+		// charge balance
+		if (Pulse->Shape == Shape_Balanced_UNsymetric_RisingTriangle ||
+			Pulse->Shape == Shape_Balanced_UNsymetric_FallingTriangle){
+			// 100us break
+			PulseWidth[iPoint] = 100;                             // 100us break
+			Current[iPoint++]  = 0.0;
+			// charge balance pulse
+			iPoint += RehaMove3::GetMinimalCurrentPulse(&PulseWidth[iPoint], &Current[iPoint], &Charge, 1);
+		}
+		// done
+		*ChargeOverAll += Charge;
+		NumberOfPoints = iPoint;
+		break;}
+
+	case Shape_UNbalanced_Charge_Compensation:
+		// 16 -> charge compensation for one channel
+		if (fabs(*ChargeOverAll) >= REHAMOVE_SHAPES__PW_MIN * REHAMOVE_SHAPES__I_MIN) {
+			NumberOfPoints = RehaMove3::GetMinimalCurrentPulse(&PulseWidth[0], &Current[0], ChargeOverAll, 2);
+		} else {
+			NumberOfPoints = 0;
+			return 0;
+		}
+		break;
+
+	/*
+	 * Done with the pulse form generation
+	 */
+	default:
+		// error: unknown shape
+		RehaMove3::printMessage(printMSG_error, "%s Error: The requested shape %u is invalid! (time: %0.3f; pulse: %u)\n", this->DeviceIDClass, Pulse->Shape, RehaMove3::GetCurrentTime(), PulseNumber);
+		return 0;
+	}
+
+	return NumberOfPoints;
+}
+
 uint8_t RehaMove3::GetMinimalCurrentPulse(uint16_t *PulseWidth, float *Current, double *Charge, uint8_t MaxNumberOfPoints)
 {
 	// get the current for the second pulse, very long with almost no current to achieve charge balance
@@ -1980,7 +4215,10 @@ bool RehaMove3::ReadAcks(void)
     	RehaMove3::printMessage(printMSG_error, "%s Error: The ReadAcks function is looked: %s (%d)\n", this->DeviceIDClass, strerror(retValue), retValue);
         return false;
     }
-    this->rmStatus.ReceiverThreatRunning = true;
+    this->rmStatus.ReceiverThreatRunning.Store(true);
+    if (this->rmInitSettings.StimConfig.LockMemory && this->rmStatus.ReceiverThreatActive.Load()){
+    	RehaMove3::PrefaultStack();
+    }
 
 	Smpt_get_main_status_ack 	GeneralMainStatusAck;
 	Smpt_get_stim_status_ack 	GeneralStimStatusAck;
@@ -1989,7 +4227,6 @@ bool RehaMove3::ReadAcks(void)
 	bool						 MlStimActive;
 	Smpt_ml_get_current_data_ack MlCurrentDataAck;
 
-	struct timeval 				time;
     SingleResponse_t 			Response;
     bool PackageReceived = false;
 
@@ -1999,13 +4236,15 @@ bool RehaMove3::ReadAcks(void)
 		 */
 		if (smpt_new_packet_received(&(this->Device))) {
 			PackageReceived = true;
+			this->rmStatus.LastAckReceived_us.Store(RehaMove3::GetTimeStamp_us());
 			/*
 			 * Get the Response
 			 */
 			smpt_clear_ack(&(Response.Ack));
 			smpt_last_ack(&(this->Device), &(Response.Ack));
+			RM3_TRACE_INSTANT(rmTrace_AckReceived, Response.Ack.command_number);
 			// debug output
-			RehaMove3::printMessage(printMSG_rmReceiveACK, "%s DEBUG: Response received\n   -> Ack: %i; Result: %i; Package Number: %i\n", this->DeviceIDClass, Response.Ack.command_number, Response.Ack.result, Response.Ack.packet_number);
+			RehaMove3::logMessage(printMSG_rmReceiveACK, rmLog_ResponseReceived, 3, (double)Response.Ack.command_number, (double)Response.Ack.result, (double)Response.Ack.packet_number);
 
 			/*
 			 * Error Handler 1, handle the error code as soon as the error comes in, otherwise handle the error in the response queue
@@ -2044,9 +4283,9 @@ bool RehaMove3::ReadAcks(void)
 				// lock the acks struct
 				pthread_mutex_lock(&(this->AcksLock_mutex));
 				/* Get the version response */
-				smpt_clear_get_version_ack(&(this->Acks.G_version_ack));
+				smpt_clear_get_version_ack(&(this->Acks.G_version_main_ack));
 				/* Writes the received data into ack struct */
-				smpt_get_get_version_main_ack(&(this->Device), &(this->Acks.G_version_ack));
+				smpt_get_get_version_main_ack(&(this->Device), &(this->Acks.G_version_main_ack));
 				// unlock the acks struct
 				pthread_mutex_unlock(&(this->AcksLock_mutex));
 				break;
@@ -2055,9 +4294,9 @@ bool RehaMove3::ReadAcks(void)
 				// lock the acks struct
 				pthread_mutex_lock(&(this->AcksLock_mutex));
 				/* Get the version response */
-				smpt_clear_get_version_ack(&(this->Acks.G_version_ack));
+				smpt_clear_get_version_ack(&(this->Acks.G_version_stim_ack));
 				/* Writes the received data into ack struct */
-				smpt_get_get_version_stim_ack(&(this->Device), &(this->Acks.G_version_ack));
+				smpt_get_get_version_stim_ack(&(this->Device), &(this->Acks.G_version_stim_ack));
 				// unlock the acks struct
 				pthread_mutex_unlock(&(this->AcksLock_mutex));
 				break;
@@ -2070,9 +4309,13 @@ bool RehaMove3::ReadAcks(void)
 				// save the current status
 				this->rmStatus.Device.BatteryLevel = GeneralBatteryStatusAck.battery_level;
 				this->rmStatus.Device.BatteryVoltage = ((float)GeneralBatteryStatusAck.battery_voltage) / 1000.0;
+				this->rmStatus.SnapshotLock.WriteBegin();
+				this->rmStatus.Snapshot.BatteryLevel = this->rmStatus.Device.BatteryLevel;
+				this->rmStatus.Snapshot.BatteryVoltage = this->rmStatus.Device.BatteryVoltage;
+				this->rmStatus.Snapshot.BatteryUpdated_us = RehaMove3::GetTimeStamp_us();
+				this->rmStatus.SnapshotLock.WriteEnd();
 				// save the current time
-				gettimeofday(&time,NULL);
-				this->rmStatus.LastUpdated = ((uint64_t)(time.tv_sec*1000.0) + (uint64_t)(time.tv_usec/1000.0)) - this->rmStatus.StartTime_ms;
+				this->rmStatus.LastUpdated.Store((RehaMove3::GetTimeStamp_ns() - this->rmStatus.StartTime_ns) /1000000);
 				// the response is handled -> do not add this response to the response queue
 				continue;
 				break;
@@ -2084,9 +4327,12 @@ bool RehaMove3::ReadAcks(void)
 				smpt_get_get_main_status_ack(&(this->Device), &GeneralMainStatusAck);
 				// save the current status
 				this->rmStatus.Device.MainStatus = GeneralMainStatusAck.main_status;
+				this->rmStatus.SnapshotLock.WriteBegin();
+				this->rmStatus.Snapshot.MainStatus = (uint8_t)this->rmStatus.Device.MainStatus;
+				this->rmStatus.Snapshot.MainStatusUpdated_us = RehaMove3::GetTimeStamp_us();
+				this->rmStatus.SnapshotLock.WriteEnd();
 				// save the current time
-				gettimeofday(&time,NULL);
-				this->rmStatus.LastUpdated = ((uint64_t)(time.tv_sec*1000.0) + (uint64_t)(time.tv_usec/1000.0)) - this->rmStatus.StartTime_ms;
+				this->rmStatus.LastUpdated.Store((RehaMove3::GetTimeStamp_ns() - this->rmStatus.StartTime_ns) /1000000);
 				// the response is handled -> do not add this response to the response queue
 				continue;
 				break;
@@ -2123,9 +4369,13 @@ bool RehaMove3::ReadAcks(void)
 					RehaMove3::printMessage(printMSG_error, "%s Error: An invalid option for the 'high voltage' setting was returned: %d!\n     -> Please check library version and this implementation!\n",
 							this->DeviceIDClass, this->rmStatus.Device.HighVoltageLevel);
 				}
+				this->rmStatus.SnapshotLock.WriteBegin();
+				this->rmStatus.Snapshot.StimStatus = (uint8_t)this->rmStatus.Device.StimStatus;
+				this->rmStatus.Snapshot.HighVoltageVoltage = this->rmStatus.Device.HighVoltageVoltage;
+				this->rmStatus.Snapshot.StimStatusUpdated_us = RehaMove3::GetTimeStamp_us();
+				this->rmStatus.SnapshotLock.WriteEnd();
 				// save the current time
-				gettimeofday(&time,NULL);
-				this->rmStatus.LastUpdated = ((uint64_t)(time.tv_sec*1000.0) + (uint64_t)(time.tv_usec/1000.0)) - this->rmStatus.StartTime_ms;
+				this->rmStatus.LastUpdated.Store((RehaMove3::GetTimeStamp_ns() - this->rmStatus.StartTime_ns) /1000000);
 				// the response is handled -> do not add this response to the response queue
 				continue;
 				break;
@@ -2168,8 +4418,15 @@ bool RehaMove3::ReadAcks(void)
 				break;
 
 			case Smpt_Cmd_Ml_Update_Ack: // PC <- stimulator stimulator smpt_last_ack()
+				{
+				// measure the latency of the update
+				uint64_t UpdateSend_us = this->rmSettings.MidLevel.UpdateLastSend_us.Exchange(0);
+				if (UpdateSend_us != 0){
+					this->rmStatus.MlUpdateAckLatencyLast_us.Store(RehaMove3::GetTimeStamp_us() - UpdateSend_us);
+				}
 				// the response is handled -> do not add this response to the response queue
 				continue;
+				}
 				break;
 
 			case Smpt_Cmd_Ml_Get_Current_Data_Ack: // PC <- stimulator smpt_get_ll_ch_config_ack()
@@ -2177,13 +4434,25 @@ bool RehaMove3::ReadAcks(void)
 				smpt_clear_ml_get_current_data_ack(&MlCurrentDataAck);
 				// Writes the received data into ml_get_current_data_ack
 				smpt_get_ml_get_current_data_ack(&(this->Device), &MlCurrentDataAck);
-				// lock the acks struct
-				pthread_mutex_lock(&(this->AcksLock_mutex));
-				MlStimActive = this->Acks.G_ml_StimActive;
+				MlStimActive = this->Acks.G_ml_StimActive.Load();
 				// Writes the received data into global ACK struct
+				this->Acks.G_ml_current_data_lock.WriteBegin();
 				memcpy(&this->Acks.G_ml_current_data_ack, &MlCurrentDataAck, sizeof(Smpt_ml_get_current_data_ack));
-				// unlock the acks struct
-				pthread_mutex_unlock(&(this->AcksLock_mutex));
+				this->Acks.G_ml_current_data_lock.WriteEnd();
+				this->Acks.G_ml_current_data_valid.Store(true);
+				// measure the latency of the keep alive signal -> smoothed, used to adapt the keep alive period
+				{
+				uint64_t KeepAliveLastSend_us = this->rmSettings.MidLevel.KeepAliveLastSend_us.Exchange(0);
+				if (KeepAliveLastSend_us != 0){
+					uint64_t Latency_us = RehaMove3::GetTimeStamp_us() - KeepAliveLastSend_us;
+					uint64_t LatencySmoothed_us = this->rmSettings.MidLevel.KeepAliveAckLatency_us.Load();
+					if (LatencySmoothed_us == 0){
+						this->rmSettings.MidLevel.KeepAliveAckLatency_us.Store(Latency_us);
+					} else {
+						this->rmSettings.MidLevel.KeepAliveAckLatency_us.Store((7*LatencySmoothed_us + Latency_us) /8);
+					}
+				}
+				}
 				RehaMove3::PutMlCurrentState(&MlCurrentDataAck, MlStimActive);
 				// the response is handled -> do not add this response to the response queue
 				continue;
@@ -2212,14 +4481,15 @@ bool RehaMove3::ReadAcks(void)
 		} else {
 			// no new responses available -> sleep
 			PackageReceived = false;
-			if (this->rmSettings.UseThreadForAcks){
+			// only the own receiver threat waits for new data; the callers of the other modes return
+			if (this->rmStatus.ReceiverThreatActive.Load()){
 				usleep(REHAMOVE_ACK_THREAD_DELAY_US);
 			}
 		}
-	} while (PackageReceived || this->rmStatus.ReceiverThreatActive); // do loop
+	} while (PackageReceived || this->rmStatus.ReceiverThreatActive.Load()); // do loop
 
 	// done
-	this->rmStatus.ReceiverThreatRunning = false;
+	this->rmStatus.ReceiverThreatRunning.Store(false);
 	// UnLock the function
     pthread_mutex_unlock(&(this->ReadPackage_mutex));
 	return true;
@@ -2228,12 +4498,13 @@ bool RehaMove3::ReadAcks(void)
 
 void RehaMove3::PutResponse(SingleResponse_t *Response)
 {
+	RM3_TRACE_SCOPE(rmTrace_PutResponse, Response->Ack.command_number);
 	/*
 	 * Check queue / Add response to queue
 	 */
 	bool wasRequested = false;
 	// lock the queue
-	pthread_mutex_lock(&(this->ResponseQueueLock_mutex));
+	RM3_TRACE_MUTEX_LOCK(rmTrace_LockResponseQueue, &(this->ResponseQueueLock_mutex));
 
 	// check if there is request for this response in the queue
 	bool SearchResponse = true;
@@ -2293,15 +4564,42 @@ void RehaMove3::PutResponse(SingleResponse_t *Response)
     // successfully finished
 }
 
+void RehaMove3::AddResponseExpectation(Smpt_Cmd ExpectedCommand, bool WaitForResponse)
+{
+	// lock the queue
+	RM3_TRACE_MUTEX_LOCK(rmTrace_LockResponseQueue, &(this->ResponseQueueLock_mutex));
+	this->ResponseQueue.QueueHead++;
+	if (this->ResponseQueue.QueueHead >= REHAMOVE_RESPONSE_QUEUE_SIZE){
+		this->ResponseQueue.QueueHead = 0;
+	}
+	if (this->ResponseQueue.QueueHead == this->ResponseQueue.QueueTail) {
+		// queue end was overrun -> we lose data
+		RehaMove3::printMessage(printMSG_error, "%s Error: The request for acknowledgement = %u could not be added to the response queue!\n     -> The oldest acknowledgement will be discarded.\n", this->DeviceIDClass, ExpectedCommand);
+		// IMPROVEMENT: wait until the queue is free again?
+		this->ResponseQueue.QueueTail++;
+		if (this->ResponseQueue.QueueTail >= REHAMOVE_RESPONSE_QUEUE_SIZE){
+			this->ResponseQueue.QueueTail = 0;
+		}
+	}
+	// write the response expectation
+	this->ResponseQueue.Queue[this->ResponseQueue.QueueHead].Request = ExpectedCommand;
+	this->ResponseQueue.Queue[this->ResponseQueue.QueueHead].ResponseReceived = false;
+	// WaitForResponse -> the response is taken by a later GetResponse(ExpectedCommand, false, timeout) call and not by the receiver
+	this->ResponseQueue.Queue[this->ResponseQueue.QueueHead].WaitForResponce = WaitForResponse;
+	this->ResponseQueue.Queue[this->ResponseQueue.QueueHead].WaitTimedOut = false;
+	this->ResponseQueue.Queue[this->ResponseQueue.QueueHead].Error = false;
+	// unlock the queue
+	pthread_mutex_unlock(&(this->ResponseQueueLock_mutex));
+}
+
 int RehaMove3::GetResponse(Smpt_Cmd ExpectedCommand, bool AddExpectedResponse, int MilliSecondsToWait)
 {
-	struct timeval TStart = {}, TStop = {};
-	double StartTime = 0, EndTime = 0;
+	RM3_TRACE_SCOPE(rmTrace_GetResponse, ExpectedCommand);
+	uint64_t StartTime_ns = 0;
 
-	if (this->rmInitSettings.DebugConfig.printSendCmdInfos){
-		gettimeofday(&TStart,NULL);
-		StartTime = (double)(TStart.tv_sec*1000.0) + (double)(TStart.tv_usec/1000.0);
-		RehaMove3::printMessage(printMSG_rmSendCMD, "%s DEBUG: Command send for ACK %u\n", this->DeviceIDClass, ExpectedCommand);
+	if (this->rmInitSettings.DebugConfig.printSendCmdInfos || this->BinaryLog.Active.Load()){
+		StartTime_ns = RehaMove3::GetTimeStamp_ns();
+		RehaMove3::logMessage(printMSG_rmSendCMD, rmLog_CommandSend, 1, (double)ExpectedCommand);
 	}
 
 	// input checks
@@ -2316,40 +4614,13 @@ int RehaMove3::GetResponse(Smpt_Cmd ExpectedCommand, bool AddExpectedResponse, i
 	 * Add a response to the queue
 	 */
 	if (AddExpectedResponse){
-		// lock the queue
-		pthread_mutex_lock(&(this->ResponseQueueLock_mutex));
-		this->ResponseQueue.QueueHead++;
-		if (this->ResponseQueue.QueueHead >= REHAMOVE_RESPONSE_QUEUE_SIZE){
-			this->ResponseQueue.QueueHead = 0;
-		}
-		if (this->ResponseQueue.QueueHead == this->ResponseQueue.QueueTail) {
-			// queue end was overrun -> we lose data
-			RehaMove3::printMessage(printMSG_error, "%s Error: The request for acknowledgement = %u could not be added to the response queue!\n     -> The oldest acknowledgement will be discarded.\n", this->DeviceIDClass, ExpectedCommand);
-			// IMPROVEMENT: wait until the queue is free again?
-			this->ResponseQueue.QueueTail++;
-			if (this->ResponseQueue.QueueTail >= REHAMOVE_RESPONSE_QUEUE_SIZE){
-				this->ResponseQueue.QueueTail = 0;
-			}
-		}
-		// write the response expectation
-		this->ResponseQueue.Queue[this->ResponseQueue.QueueHead].Request = ExpectedCommand;
-		this->ResponseQueue.Queue[this->ResponseQueue.QueueHead].ResponseReceived = false;
-		if (MilliSecondsToWait > 0){
-			this->ResponseQueue.Queue[this->ResponseQueue.QueueHead].WaitForResponce = true;
-		} else {
-			this->ResponseQueue.Queue[this->ResponseQueue.QueueHead].WaitForResponce = false;
-		}
-		this->ResponseQueue.Queue[this->ResponseQueue.QueueHead].WaitTimedOut = false;
-		this->ResponseQueue.Queue[this->ResponseQueue.QueueHead].Error = false;
-		// unlock the queue
-		pthread_mutex_unlock(&(this->ResponseQueueLock_mutex));
+		RehaMove3::AddResponseExpectation(ExpectedCommand, (MilliSecondsToWait > 0));
 	}
 
 	/*
 	 * Wait for the expected response to arrive
 	 */
 	uint16_t QueueEntry = this->ResponseQueue.QueueTail;
-	struct timeval time;
 	uint64_t TimeStart = 0, TimeNow = 0;
 	int TimeToWait = MilliSecondsToWait;
 
@@ -2369,8 +4640,7 @@ int RehaMove3::GetResponse(Smpt_Cmd ExpectedCommand, bool AddExpectedResponse, i
 	}
 	// Prepare for waiting
 	if (TimeToWait > 0){
-		gettimeofday(&time,NULL);
-		TimeStart = (uint64_t)(time.tv_sec*1000.0) + (uint64_t)(time.tv_usec/1000.0);
+		TimeStart = RehaMove3::GetTimeStamp_ns() /1000000;
 	}
 
 	do {
@@ -2382,12 +4652,11 @@ int RehaMove3::GetResponse(Smpt_Cmd ExpectedCommand, bool AddExpectedResponse, i
 			break;
 		}
 		if (MilliSecondsToWait > 0){
-			usleep(500);
-			gettimeofday(&time,NULL);
-			TimeNow = (uint64_t)(time.tv_sec*1000.0) + (uint64_t)(time.tv_usec/1000.0);
+			RehaMove3::SleepFor_us(500);
+			TimeNow = RehaMove3::GetTimeStamp_ns() /1000000;
 			TimeToWait = MilliSecondsToWait - (int)(TimeNow - TimeStart);
 		}
-		if (this->rmStatus.InitThreatRunning && !this->rmStatus.InitThreatActive){
+		if (this->rmStatus.InitThreatRunning.Load() && !this->rmStatus.InitThreatActive.Load()){
 			TimeToWait = 0;
 		}
 	} while (TimeToWait > 0);
@@ -2397,7 +4666,7 @@ int RehaMove3::GetResponse(Smpt_Cmd ExpectedCommand, bool AddExpectedResponse, i
 		if (DoWait) {
 			// the response was not received -> timeout occurred
 			// lock the queue
-			pthread_mutex_lock(&(this->ResponseQueueLock_mutex));
+			RM3_TRACE_MUTEX_LOCK(rmTrace_LockResponseQueue, &(this->ResponseQueueLock_mutex));
 			this->ResponseQueue.Queue[QueueEntry].WaitTimedOut = true;
 			// unlock the queue
 			pthread_mutex_unlock(&(this->ResponseQueueLock_mutex));
@@ -2414,7 +4683,7 @@ int RehaMove3::GetResponse(Smpt_Cmd ExpectedCommand, bool AddExpectedResponse, i
 	 */
 	SingleResponse_t Response;
 	// lock the queue
-	pthread_mutex_lock(&(this->ResponseQueueLock_mutex));
+	RM3_TRACE_MUTEX_LOCK(rmTrace_LockResponseQueue, &(this->ResponseQueueLock_mutex));
 	memcpy(&Response, &(this->ResponseQueue.Queue[QueueEntry]), sizeof(Response));
 	// remove response from the queue
 	this->ResponseQueue.QueueTail++;
@@ -2490,10 +4759,8 @@ int RehaMove3::GetResponse(Smpt_Cmd ExpectedCommand, bool AddExpectedResponse, i
 	}
 
 	// done
-	if (this->rmInitSettings.DebugConfig.printSendCmdInfos){
-		gettimeofday(&TStop,NULL);
-		EndTime = (double)(TStop.tv_sec*1000.0) + (double)(TStop.tv_usec/1000.0);
-		RehaMove3::printMessage(printMSG_rmSendCMD, "   -> ACK %u needed %f ms to finish\n", Response.Request, (EndTime - StartTime));
+	if (this->rmInitSettings.DebugConfig.printSendCmdInfos || this->BinaryLog.Active.Load()){
+		RehaMove3::logMessage(printMSG_rmSendCMD, rmLog_CommandDuration, 2, (double)Response.Request, ((double)(RehaMove3::GetTimeStamp_ns() - StartTime_ns)) /1000000.0);
 	}
 	return (int) ExpectedCommand;
 }
@@ -2505,7 +4772,7 @@ uint64_t RehaMove3::PutLLChannelResponseExpectation(uint64_t SequenceNumber, Smp
 	 * Add the expected stimulation response to the queue
 	 */
 	// lock the queue
-	pthread_mutex_lock(&(this->LlSequenceQueueLock_mutex));
+	RM3_TRACE_MUTEX_LOCK(rmTrace_LockLlSequenceQueue, &(this->LlSequenceQueueLock_mutex));
 
 	// add a new sequence or add a pulse to the last one?
 	if (this->LlSequenceQueue.Queue[this->LlSequenceQueue.QueueHead].SequenceNumber != SequenceNumber){
@@ -2540,6 +4807,7 @@ uint64_t RehaMove3::PutLLChannelResponseExpectation(uint64_t SequenceNumber, Smp
 	// add the response expectation to the queue
 	this->LlSequenceQueue.Queue[this->LlSequenceQueue.QueueHead].StimulationPulse[this->LlSequenceQueue.Queue[this->LlSequenceQueue.QueueHead].NumberOfPulses].Channel = Channel;
 	this->LlSequenceQueue.Queue[this->LlSequenceQueue.QueueHead].StimulationPulse[this->LlSequenceQueue.Queue[this->LlSequenceQueue.QueueHead].NumberOfPulses].PackageNumber = PackageNumber;
+	this->LlSequenceQueue.Queue[this->LlSequenceQueue.QueueHead].StimulationPulse[this->LlSequenceQueue.Queue[this->LlSequenceQueue.QueueHead].NumberOfPulses].SendTime_us = RehaMove3::GetTimeStamp_us();
 	this->LlSequenceQueue.Queue[this->LlSequenceQueue.QueueHead].NumberOfPulses++;
 
 	// unlock the queue
@@ -2549,11 +4817,12 @@ uint64_t RehaMove3::PutLLChannelResponseExpectation(uint64_t SequenceNumber, Smp
 
 void RehaMove3::PutLLChannelResponse(uint8_t PackageNumber, Smpt_Result Result, Smpt_Channel ChannelError)
 {
+	RM3_TRACE_SCOPE(rmTrace_PutLlChannelResponse, PackageNumber);
 	/*
 	 * Update the expected stimulation response with the response
 	 */
 	// lock the queue
-	pthread_mutex_lock(&(this->LlSequenceQueueLock_mutex));
+	RM3_TRACE_MUTEX_LOCK(rmTrace_LockLlSequenceQueue, &(this->LlSequenceQueueLock_mutex));
 
 	// search backwards for the last stimulation pulse with no ack ( and were the package number match )
 	bool DoSearch = true, PulseFound = false;
@@ -2597,16 +4866,36 @@ void RehaMove3::PutLLChannelResponse(uint8_t PackageNumber, Smpt_Result Result,
 	if (PulseFound){
 		this->LlSequenceQueue.Queue[iQueue].NumberOfAcks++;
 		this->LlSequenceQueue.Queue[iQueue].StimulationPulse[PulsePointer].Result = (uint8_t)Result;
+		// latency of the acknowledgement
+		uint64_t Latency_us = RehaMove3::GetTimeStamp_us() - this->LlSequenceQueue.Queue[iQueue].StimulationPulse[PulsePointer].SendTime_us;
+		this->rmStatus.LlAckLatencyLast_us.Store(Latency_us);
+		if (Latency_us > this->rmStatus.LlAckLatencyMax_us.Load()){
+			this->rmStatus.LlAckLatencyMax_us.Store(Latency_us);
+		}
+		uint64_t LatencyMean_us = this->rmStatus.LlAckLatencyMean_us.Load();
+		if (LatencyMean_us == 0){
+			LatencyMean_us = Latency_us;
+		} else {
+			LatencyMean_us = (LatencyMean_us *(REHAMOVE_ACK_LATENCY_AVERAGE -1) + Latency_us) /REHAMOVE_ACK_LATENCY_AVERAGE;
+		}
+		this->rmStatus.LlAckLatencyMean_us.Store(LatencyMean_us);
+		if (PulsePointer == 0){
+			this->rmStatus.LlFirstPulseSequenceNumber = this->LlSequenceQueue.Queue[iQueue].SequenceNumber;
+			this->rmStatus.LlFirstPulseSendTime_us = this->LlSequenceQueue.Queue[iQueue].StimulationPulse[0].SendTime_us;
+			this->rmStatus.LlFirstPulseAckTime_us = this->LlSequenceQueue.Queue[iQueue].StimulationPulse[0].SendTime_us + Latency_us;
+		}
 		// check the result
 		switch (Result){
 		case Smpt_Result_Successful:
 			// stimulation pulse was successful -> end now
-			this->Stats.StimultionPulsesSuccessful++;
+			this->Stats.StimultionPulsesSuccessful.Add(1);
+			this->Stats.Channel[this->LlSequenceQueue.Queue[iQueue].StimulationPulse[PulsePointer].Channel].PulsesSuccessful.Add(1);
 			break;
 		case Smpt_Result_Electrode_Error:
 			// a stimulation error was detected
-			this->Stats.StimultionPulsesFailed++;
-			this->Stats.StimultionPulsesFailed_StimError++;
+			this->Stats.StimultionPulsesFailed.Add(1);
+			this->Stats.StimultionPulsesFailed_StimError.Add(1);
+			this->Stats.Channel[this->LlSequenceQueue.Queue[iQueue].StimulationPulse[PulsePointer].Channel].PulsesFailed_StimError.Add(1);
 			break;
 		default:
 			RehaMove3::printMessage(printMSG_error,"%s Error: the result code %d is not handled in function 'PutLLChannelResponse'\n", this->DeviceIDClass, Result);
@@ -2634,13 +4923,14 @@ void RehaMove3::PutLLChannelResponse(uint8_t PackageNumber, Smpt_Result Result,
 					//this->Stats.StimultionPulsesFailed_StimError++;
 					snprintf(tempString, sizeof(tempString), "   -> Electrode Error => Pulse Number: %d; Channel: %d (%s)\n",
 							(i+1), ((int8_t)this->LlSequenceQueue.Queue[iQueue].StimulationPulse[i].Channel+1), RehaMove3::GetChannelNameString((Smpt_Channel)this->LlSequenceQueue.Queue[iQueue].StimulationPulse[i].Channel));
-					strcat(ErrorString, tempString);
+					strncat(ErrorString, tempString, sizeof(ErrorString) -strlen(ErrorString) -1);
 					break;
 
 				default:
 					SequenceWasSuccessful = false;
-					snprintf(ErrorString, sizeof(ErrorString), "%s     -> UNDEFINED Error => Pulse Number: %d; Channel: %d (%s) Result: %d\n",
-							ErrorString, (PulsePointer+1), ((int8_t)ChannelError+1), RehaMove3::GetChannelNameString(ChannelError), Result);
+					snprintf(tempString, sizeof(tempString), "     -> UNDEFINED Error => Pulse Number: %d; Channel: %d (%s) Result: %d\n",
+							(PulsePointer+1), ((int8_t)ChannelError+1), RehaMove3::GetChannelNameString(ChannelError), Result);
+					strncat(ErrorString, tempString, sizeof(ErrorString) -strlen(ErrorString) -1);
 					RehaMove3::printMessage(printMSG_error,"%s Error: the result code %d is not handled in function 'PutLLChannelResponse'\n", this->DeviceIDClass, Result);
 				}
 
@@ -2648,20 +4938,19 @@ void RehaMove3::PutLLChannelResponse(uint8_t PackageNumber, Smpt_Result Result,
 
 			if (SequenceWasSuccessful){
 				// no error occurred
-				this->Stats.SequencesSuccessful++;
+				this->Stats.SequencesSuccessful.Add(1);
 				this->LlSequenceQueue.Queue[iQueue].SequenceWasSuccessful = true;
 			} else {
 				// an error occurred
 				RehaMove3::printMessage(printMSG_rmSequenceError, "\n%s Sequence Error: Sequence %ld FAILED! (time=%fs)\n%s",
 					this->DeviceIDClass, this->LlSequenceQueue.Queue[iQueue].SequenceNumber, RehaMove3::GetCurrentTime(true), ErrorString );
-				this->Stats.SequencesFailed++;
+				this->Stats.SequencesFailed.Add(1);
 
 				/*
 				 * Handle Stimulation Errors e.g. electrode errors and check if the stimulation should be continued
 				 */
-				this->rmStatus.NumberOfStimErrors++;
-				if ((this->rmStatus.NumberOfStimErrors >= this->rmSettings.NumberOfErrorsAfterWhichToAbort) && (this->rmSettings.NumberOfErrorsAfterWhichToAbort != 0)){
-					this->rmStatus.DoNotStimulate = true;
+				uint16_t NumberOfStimErrors = this->rmStatus.NumberOfStimErrors.FetchAdd(1) +1;
+				if ((NumberOfStimErrors >= this->rmSettings.NumberOfErrorsAfterWhichToAbort) && (this->rmSettings.NumberOfErrorsAfterWhichToAbort != 0)){
 					if (this->rmSettings.NumberOfSequencesAfterWhichToRetestForError != 0){
 						this->rmStatus.NumberOfSequencesUntilErrorRetest = this->rmSettings.NumberOfSequencesAfterWhichToRetestForError;
 						this->rmStatus.DoReTestTheStimError = true;
@@ -2671,12 +4960,14 @@ void RehaMove3::PutLLChannelResponse(uint8_t PackageNumber, Smpt_Result Result,
 						this->rmStatus.NumberOfSequencesUntilErrorRetest = 0xFFFF;
 						snprintf(ErrorString, sizeof(ErrorString), "The stimulation will never be resumed!");
 					}
+					// publish the retest settings above
+					this->rmStatus.DoNotStimulate.Store(true);
 					RehaMove3::printMessage(printMSG_rmSequenceError, "%s Stimulation Error: %u Stimulation Sequence(s) FAILED!\n   -> The stimulation will be DISABLED!\n   -> PLEASE CHECK THE SETUP AND THE SETTINGS!\n\n   -> RE-TEST: %s\n",
-										this->DeviceIDClass, this->rmStatus.NumberOfStimErrors, ErrorString );
+										this->DeviceIDClass, NumberOfStimErrors, ErrorString );
 				}
 
 				if (StimErrorsOccurred) {
-					this->Stats.SequencesFailed_StimError++;
+					this->Stats.SequencesFailed_StimError.Add(1);
 				}
 			}
 		}
@@ -2709,7 +5000,7 @@ void RehaMove3::PutMlCurrentState(Smpt_ml_get_current_data_ack *State, bool Stim
 			// print the error
 			RehaMove3::printMessage(printMSG_rmSequenceError, "\n%s Stimulation Update Error: Stimulation failed FAILED! (time=%fs)\n   -> Electrode Error => Channel: %d (%s)\n",
 					this->DeviceIDClass, RehaMove3::GetCurrentTime(true), Channel+1, RehaMove3::GetChannelNameString((Smpt_Channel)Channel) );
-			this->Stats.UpdatesFailed_StimError++;
+			this->Stats.UpdatesFailed_StimError.Add(1);
 		} else {
 			// no error -> return
 			return;
@@ -2729,9 +5020,8 @@ void RehaMove3::PutMlCurrentState(Smpt_ml_get_current_data_ack *State, bool Stim
 	 * Handle Stimulation Errors e.g. electrode errors and check if the stimulation should be continued
 	 */
 	char ErrorString[200] = {0};
-	this->rmStatus.NumberOfStimErrors++;
-	if ((this->rmStatus.NumberOfStimErrors >= this->rmSettings.NumberOfErrorsAfterWhichToAbort) && (this->rmSettings.NumberOfErrorsAfterWhichToAbort != 0)){
-		this->rmStatus.DoNotStimulate = true;
+	uint16_t NumberOfStimErrors = this->rmStatus.NumberOfStimErrors.FetchAdd(1) +1;
+	if ((NumberOfStimErrors >= this->rmSettings.NumberOfErrorsAfterWhichToAbort) && (this->rmSettings.NumberOfErrorsAfterWhichToAbort != 0)){
 		if (this->rmSettings.NumberOfSequencesAfterWhichToRetestForError != 0){
 			this->rmStatus.NumberOfSequencesUntilErrorRetest = this->rmSettings.NumberOfSequencesAfterWhichToRetestForError;
 			this->rmStatus.DoReTestTheStimError = true;
@@ -2741,16 +5031,14 @@ void RehaMove3::PutMlCurrentState(Smpt_ml_get_current_data_ack *State, bool Stim
 			this->rmStatus.NumberOfSequencesUntilErrorRetest = 0xFFFF;
 			snprintf(ErrorString, sizeof(ErrorString), "The stimulation will never be resumed!");
 		}
+		// publish the retest settings above
+		this->rmStatus.DoNotStimulate.Store(true);
 		RehaMove3::printMessage(printMSG_rmSequenceError, "%s Stimulation Error: %u Stimulation Update(s) FAILED!\n   -> The stimulation will be DISABLED!\n   -> PLEASE CHECK THE SETUP AND THE SETTINGS!\n\n   -> RE-TEST: %s\n",
-				this->DeviceIDClass, this->rmStatus.NumberOfStimErrors, ErrorString );
+				this->DeviceIDClass, NumberOfStimErrors, ErrorString );
 	}
 
-	// lock the acks struct
-	pthread_mutex_lock(&(this->AcksLock_mutex));
-	this->Acks.G_ml_StimActive = IsStimActiv;
-	this->Acks.G_ml_StimError = true;
-	// unlock the acks struct
-	pthread_mutex_unlock(&(this->AcksLock_mutex));
+	this->Acks.G_ml_StimActive.Store(IsStimActiv);
+	this->Acks.G_ml_StimError.Store(true);
 }
 
 
@@ -2759,28 +5047,62 @@ bool RehaMove3::NewStatusUpdateReceived(uint32_t MilliSecondsToWait)
 	/*
 	 * Wait for the expected response to arrive
 	 */
-	struct timeval time;
 	uint64_t TimeStart = 0, TimeNow = 0;
 	int TimeToWait = MilliSecondsToWait;
 	// Prepare for waiting
 	if (TimeToWait > 0){
-		gettimeofday(&time,NULL);
-		TimeStart = (uint64_t)(time.tv_sec*1000.0) + (uint64_t)(time.tv_usec/1000.0);
+		TimeStart = RehaMove3::GetTimeStamp_ns() /1000000;
 	}
-	uint64_t OldStatusUpdateTime = this->rmStatus.LastUpdated;
+	uint64_t OldStatusUpdateTime = this->rmStatus.LastUpdated.Load();
 	do {
 		// check for ACKs and process them
 		RehaMove3::ReadAcksBlocking();
 		// check if the time of the last update changed
-		if (OldStatusUpdateTime != this->rmStatus.LastUpdated){
+		if (OldStatusUpdateTime != this->rmStatus.LastUpdated.Load()){
 			// something changed -> abort the loop
 			return true;
 			break;
 		}
 		if (MilliSecondsToWait > 0){
-			usleep(500);
-			gettimeofday(&time,NULL);
-			TimeNow = (uint64_t)(time.tv_sec*1000.0) + (uint64_t)(time.tv_usec/1000.0);
+			RehaMove3::SleepFor_us(500);
+			TimeNow = RehaMove3::GetTimeStamp_ns() /1000000;
+			TimeToWait = MilliSecondsToWait - (int)(TimeNow - TimeStart);
+		}
+	} while (TimeToWait > 0);
+
+	// timeout occurred
+	return false;
+}
+
+
+bool RehaMove3::NewStatusUpdatesReceived(uint64_t Since_us, bool Battery, bool MainStatus, bool StimStatus, uint32_t MilliSecondsToWait)
+{
+	/*
+	 * Wait until all requested status acknowledgements were received after Since_us
+	 */
+	uint64_t TimeStart = 0, TimeNow = 0;
+	int TimeToWait = MilliSecondsToWait;
+	// Prepare for waiting
+	if (TimeToWait > 0){
+		TimeStart = RehaMove3::GetTimeStamp_ns() /1000000;
+	}
+	rmStatus_t::rmStatusSnapshot_t Snapshot;
+	uint32_t Sequence = 0;
+	do {
+		// check for ACKs and process them
+		RehaMove3::ReadAcksBlocking();
+		do {
+			Sequence = this->rmStatus.SnapshotLock.ReadBegin();
+			memcpy(&Snapshot, &this->rmStatus.Snapshot, sizeof(Snapshot));
+		} while (this->rmStatus.SnapshotLock.ReadRetry(Sequence));
+		if ((!Battery    || (Snapshot.BatteryUpdated_us    >= Since_us)) &&
+			(!MainStatus || (Snapshot.MainStatusUpdated_us >= Since_us)) &&
+			(!StimStatus || (Snapshot.StimStatusUpdated_us >= Since_us))){
+			return true;
+		}
+		if (MilliSecondsToWait > 0){
+			RehaMove3::SleepFor_us(500);
+			TimeNow = RehaMove3::GetTimeStamp_ns() /1000000;
 			TimeToWait = MilliSecondsToWait - (int)(TimeNow - TimeStart);
 		}
 	} while (TimeToWait > 0);
@@ -2789,28 +5111,69 @@ bool RehaMove3::NewStatusUpdateReceived(uint32_t MilliSecondsToWait)
 	return false;
 }
 
+int RehaMove3::GetTimeUntil_ms(uint64_t Deadline_ms)
+{
+	// at least 1ms -> GetResponse does not wait (and does not mark the timeout) for 0ms
+	uint64_t TimeNow_ms = RehaMove3::GetTimeStamp_ns() /1000000;
+	if (TimeNow_ms >= Deadline_ms){
+		return 1;
+	}
+	return (int)(Deadline_ms - TimeNow_ms);
+}
 
 double RehaMove3::GetCurrentTime(void){
-	return RehaMove3::GetCurrentTime(true);
+	// the time of the current step -> updated by the Send* functions
+	return RehaMove3::GetCurrentTime(false);
 }
 double RehaMove3::GetCurrentTime(bool DoUpdate)
 {
+	// time since the start of the session in s
 	if (DoUpdate){
-		struct timeval time;
-		gettimeofday(&time,NULL);
-		uint64_t Time_ms = (uint64_t)(time.tv_sec*1000.0) + (uint64_t)(time.tv_usec/1000.0);
-		this->rmStatus.CurrentTime_ms = Time_ms - this->rmStatus.StartTime_ms;
+		this->rmStatus.CurrentTime_ns.Store(RehaMove3::GetTimeStamp_ns() - this->rmStatus.StartTime_ns);
 	}
-	return ((double)this->rmStatus.CurrentTime_ms) / 1000.0;
+	return ((double)this->rmStatus.CurrentTime_ns.Load()) / 1e9;
 }
 
-uint8_t RehaMove3::GetPackageNumber() {
-	uint8_t PackageNumber_old = this->rmStatus.LocalPackageNumber;
-	this->rmStatus.LocalPackageNumber++;
-	if (this->rmStatus.LocalPackageNumber > 63) {
-		this->rmStatus.LocalPackageNumber = 0;
+uint64_t RehaMove3::GetTimeStamp_us(void)
+{
+	return RehaMove3::GetTimeStamp_ns() /1000;
+}
+
+uint64_t RehaMove3::GetTimeStamp_ns(void)
+{
+	// default: CLOCK_MONOTONIC -> not affected by changes of the system time (e.g. NTP)
+	return this->Clock.Now_ns(this->Clock.Context);
+}
+
+void RehaMove3::SleepFor_us(uint32_t Duration_us)
+{
+	this->Clock.Sleep_us(this->Clock.Context, Duration_us);
+}
+
+bool RehaMove3::SetClock(const rmClock_t *NewClock)
+{
+	// the clock can not be changed while the helper threats are running
+	if (this->rmStatus.DeviceIsOpen.Load()){
+		RehaMove3::printMessage(printMSG_error, "%s Error: The clock can not be changed while the device is open!\n", this->DeviceIDClass);
+		return false;
+	}
+	if (NewClock == NULL){
+		this->Clock.Now_ns 	 = DefaultClockNow_ns;
+		this->Clock.Sleep_us = DefaultClockSleep_us;
+		this->Clock.Context  = NULL;
+		return true;
+	}
+	if ((NewClock->Now_ns == NULL) || (NewClock->Sleep_us == NULL)){
+		RehaMove3::printMessage(printMSG_error, "%s Error: The clock is invalid!\n", this->DeviceIDClass);
+		return false;
 	}
-	return PackageNumber_old;
+	memcpy(&this->Clock, NewClock, sizeof(rmClock_t));
+	return true;
+}
+
+uint8_t RehaMove3::GetPackageNumber() {
+	// the package numbers run from 0 to 63 (the counter wraps at 256) -> call it with the SendPackage_mutex locked, so the numbers are send in order
+	return (uint8_t)(this->rmStatus.LocalPackageNumber.FetchAdd(1) % 64);
 }
 
 const char* RehaMove3::GetResultString(Smpt_Result Result)
@@ -2857,106 +5220,123 @@ const char* RehaMove3::GetChannelNameString(Smpt_Channel Channel)
 }
 
 void RehaMove3::printMessage(printMessageType_t type, const char *format, ... )
+{
+	/*
+	 * The message is formatted by the calling thread and printed by the logger threat, so a slow terminal does not stall the stimulation
+	 * -> full queue: the message is dropped (see the statistics), except for errors; for errors, the calling thread waits for a free slot
+	 */
+	uint8_t Style = logStyle_plain;
+	if (!RehaMove3::IsMessageEnabled(type, &Style)){
+		return;
+	}
+	va_list args;
+	va_start( args, format );
+	RehaMove3::PutLogMessage(Style, (type == printMSG_error), format, args);
+	va_end( args );
+}
+
+void RehaMove3::printExternalMessage(RehaMove3 *Device, bool IsError, const char *format, ... )
 {
 	va_list args;
 	va_start( args, format );
+	if (Device != NULL){
+		uint8_t Style = logStyle_plain;
+		Device->IsMessageEnabled(IsError ? printMSG_error : printMSG_warning, &Style);
+		Device->PutLogMessage(Style, IsError, format, args);
+	} else {
+		char Text[REHAMOVE_LOG_MESSAGE_SIZE];
+		vsnprintf(Text, sizeof(Text), format, args);
+		RehaMove3::WriteLogMessage(IsError ? logStyle_error : logStyle_warning, Text);
+		fflush(stdout);
+	}
+	va_end( args );
+}
+
+bool RehaMove3::IsMessageEnabled(printMessageType_t type, uint8_t *Style)
+{
+	// is the message type enabled in the debug settings? -> also returns the style to print it with
+	bool DoPrint = false;
+	uint8_t ColorStyle = logStyle_plain;
 	switch (type){
 	case printMSG_general:
-		vprintf(format, args );
+		DoPrint = true;
 		break;
 	case printMSG_warning:
-		if (this->rmInitSettings.DebugConfig.useColors){
-			// color codes: http://misc.flogisoft.com/bash/tip_colors_and_formatting
-			printf("\033[1m\033[93m"); // bold and light yellow
-		}
-		vprintf(format, args );
-		if (this->rmInitSettings.DebugConfig.useColors){
-			printf("\033[0m");
-		}
+		DoPrint = true;
+		ColorStyle = logStyle_warning;
 		break;
 	case printMSG_error:
-		if (this->rmInitSettings.DebugConfig.useColors){
-			printf("\n\033[1m\033[91m"); // bold and light red
-		}
-		vprintf(format, args );
-		if (this->rmInitSettings.DebugConfig.useColors){
-			printf("\033[0m\n");
-		}
+		DoPrint = true;
+		ColorStyle = logStyle_error;
 		break;
 	case printMSG_rmDeviceInfo:
-		if (this->rmInitSettings.DebugConfig.printDeviceInfos){
-			vprintf(format, args );
-		}
+		DoPrint = this->rmInitSettings.DebugConfig.printDeviceInfos;
 		break;
 	case printMSG_rmInitInfo:
-		if (this->rmInitSettings.DebugConfig.printInitInfos){
-			vprintf(format, args );
-		}
+		DoPrint = this->rmInitSettings.DebugConfig.printInitInfos;
 		break;
 	case printMSG_rmInitParam:
-		if (this->rmInitSettings.DebugConfig.printInitSettings){
-			vprintf(format, args );
-		}
+		DoPrint = this->rmInitSettings.DebugConfig.printInitSettings;
 		break;
 	case printMSG_rmSendCMD:
-		if (this->rmInitSettings.DebugConfig.printSendCmdInfos){
-			vprintf(format, args );
-		}
+		DoPrint = this->rmInitSettings.DebugConfig.printSendCmdInfos;
 		break;
 	case printMSG_rmReceiveACK:
-		if (this->rmInitSettings.DebugConfig.printReceivedAckInfos){
-			vprintf(format, args );
-		}
+		DoPrint = this->rmInitSettings.DebugConfig.printReceivedAckInfos;
 		break;
 	case printMSG_rmPulseConfig:
-		if (this->rmInitSettings.DebugConfig.printStimInfos){
-			vprintf(format, args );
-		}
+		DoPrint = this->rmInitSettings.DebugConfig.printStimInfos;
 		break;
 	case printMSG_rmErrorUnclaimedSequence:
-		if (this->rmInitSettings.DebugConfig.printErrorsTiming){
-			if (this->rmInitSettings.DebugConfig.useColors){
-				printf("\033[1m\033[93m"); // bold and light yellow
-			}
-			vprintf(format, args );
-			if (this->rmInitSettings.DebugConfig.useColors){
-				printf("\033[0m");
-			}
-		}
+		DoPrint = this->rmInitSettings.DebugConfig.printErrorsTiming;
+		ColorStyle = logStyle_warning;
 		break;
 	case printMSG_rmWarningCorrectionChargeInbalace:
-		if (this->rmInitSettings.DebugConfig.printCorrectionChargeWarnings){
-			if (this->rmInitSettings.DebugConfig.useColors){
-				printf("\033[1m\033[93m"); // bold and light yellow
-			}
-			vprintf(format, args );
-			if (this->rmInitSettings.DebugConfig.useColors){
-				printf("\033[0m");
-			}
-		}
+		DoPrint = this->rmInitSettings.DebugConfig.printCorrectionChargeWarnings;
+		ColorStyle = logStyle_warning;
 		break;
 	case printMSG_rmSequenceError:
-		if (this->rmInitSettings.DebugConfig.printErrorsSequence){
-			if (this->rmInitSettings.DebugConfig.useColors){
-				printf("\n\033[1m\033[91m"); // bold and light red
-			}
-			vprintf(format, args );
-			if (this->rmInitSettings.DebugConfig.useColors){
-				printf("\033[0m\n");
-			}
-		}
+		DoPrint = this->rmInitSettings.DebugConfig.printErrorsSequence;
+		ColorStyle = logStyle_error;
 		break;
 	case printMSG_rmStats:
-		if (this->rmInitSettings.DebugConfig.printStats){
-			vprintf(format, args );
-		}
+		DoPrint = this->rmInitSettings.DebugConfig.printStats;
 		break;
 	default:
 		printf("\nRMP ERROR: unsupported printf type: %u....\n\n", (uint16_t)type);
 	}
-	va_end( args );
+	*Style = (this->rmInitSettings.DebugConfig.useColors) ? ColorStyle : (uint8_t)logStyle_plain;
+	return DoPrint;
 }
 
+void RehaMove3::logMessage(printMessageType_t type, uint16_t MessageID, uint32_t NumberOfArgs, ... )
+{
+	/*
+	 * Messages with a fixed format (see RehaMove3BinaryLog.hpp); all arguments have to be passed as double
+	 * -> binary log: only the message ID and the arguments are queued; the logger threat writes them to the file
+	 * -> otherwise: the text is created and printed like with printMessage
+	 */
+	uint8_t Style = logStyle_plain;
+	if ((!this->BinaryLog.Active.Load()) && (!RehaMove3::IsMessageEnabled(type, &Style))){
+		return;
+	}
+	double Args[REHAMOVE_BINLOG_MAX_ARGS];
+	NumberOfArgs = (NumberOfArgs > REHAMOVE_BINLOG_MAX_ARGS) ? REHAMOVE_BINLOG_MAX_ARGS : NumberOfArgs;
+	va_list args;
+	va_start( args, NumberOfArgs );
+	for (uint32_t i=0; i<NumberOfArgs; i++){
+		Args[i] = va_arg( args, double );
+	}
+	va_end( args );
+
+	if (this->BinaryLog.Active.Load()){
+		RehaMove3::PutBinaryLogRecord(MessageID, Args, (uint8_t)NumberOfArgs);
+		return;
+	}
+	char Text[REHAMOVE_LOG_MESSAGE_SIZE];
+	rmLogFormat(Text, sizeof(Text), MessageID, this->DeviceIDClass, Args, (uint8_t)NumberOfArgs);
+	RehaMove3::printMessage(type, "%s", Text);
+}
 
 void RehaMove3::printBits(char *msgString, void const * const ptr, size_t const size)
 {
@@ -27,10 +27,16 @@
 #include <sys/time.h>
 #include <errno.h>
 #include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
 #else
 // Windows is not supported at the moment
 //#include <windows.h>
 #endif
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS	// PRIu64 in C++98
+#endif
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
@@ -41,6 +47,15 @@
 #include <cmath>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <limits.h>
+
+#include "RehaMove3Telemetry.hpp"
+#include "RehaMove3Trace.hpp"
+#include "RehaMove3BinaryLog.hpp"
 
 extern "C" {
 // General
@@ -75,12 +90,39 @@ static const uint8_t RM3_ErrorWarningBand				= 3; // warning if difference of mi
  * RehaMove3 Interface defines
  */
 #define REHAMOVE_MAX_RESETS_INIT							20
+#define REHAMOVE_INIT_QUERY_TIMEOUT_MS						500		// deadline for all acknowledgements of the queries send back-to-back
+#define REHAMOVE_INIT_STIM_STATUS_STOPPED					0		// stim status of a device without an initialised protocol
+#define REHAMOVE_DEVICECHECK_DELAY_MS						1000	// a cached device is checked after the first stimulation command or this delay
+#define REHAMOVE_DEVICECHECK_THREAD_DELAY_US				10000
+#define REHAMOVE_RECONNECT_SILENCE_MS						1000	// no acknowledgement for this time -> the connection is probed
+#define REHAMOVE_RECONNECT_PROBE_TIMEOUT_MS					500
+#define REHAMOVE_RECONNECT_RETRY_MS							1000	// delay between the attempts to open and initialise the device again
+#define REHAMOVE_RECONNECT_THREAD_DELAY_US					50000
+#define REHAMOVE_SERIAL_LINK_DIR							"/dev/serial/by-id"
+#define REHAMOVE_DISCOVERY_TIMEOUT_MS						300		// the device ID is answered within a few ms; other devices do not answer at all
+#define REHAMOVE_DISCOVERY_MAX_INTERFACES					32
+#define REHAMOVE_DISCOVERY_VENDOR_NAME						"hasomed"	// part of the /dev/serial/by-id names of the interfaces of the devices (case insensitive)
 #define REHAMOVE_NUMBER_OF_CHANNELS							4
 #define REHAMOVE_MAX_SEQUENCE_SIZE							12
 #define REHAMOVE_RESPONSE_QUEUE_SIZE						100
 #define REHAMOVE_RESPONSE_ERROR_DESC_SIZE					100
 #define REHAMOVE_SEQUENCE_QUEUE_SIZE						10
+#define REHAMOVE_ACK_LATENCY_AVERAGE						8		// weight of the exponential average of the LowLevel acknowledgement latency
 #define REHAMOVE_ACK_THREAD_DELAY_US						500
+#define REHAMOVE_KEEPALIVE_THREAD_DELAY_US					2000
+#define REHAMOVE_KEEPALIVE_PERIOD_MIN_MS					20		// the adaptive keep alive period is never shorter than this
+#define REHAMOVE_KEEPALIVE_AFTER_UPDATE_MS					20		// ask for the electrode status shortly after an update
+#define REHAMOVE_MLUPDATE_THREAD_DELAY_US					500
+#define REHAMOVE_STATUSPOLL_THREAD_DELAY_US					10000
+#define REHAMOVE_STATSEXPORT_THREAD_DELAY_US				100000
+#define REHAMOVE_TELEMETRY_THREAD_DELAY_US					1000
+#define REHAMOVE_LOGGER_THREAD_DELAY_US						1000
+#define REHAMOVE_LOG_QUEUE_SIZE								256		// messages; must be a power of 2
+#define REHAMOVE_LOG_MESSAGE_SIZE							1024	// longer messages are truncated
+#define REHAMOVE_STACK_PREFAULT_SIZE						(64*1024)
+#define REHAMOVE_BINLOG_QUEUE_SIZE							4096	// records; must be a power of 2
+#define REHAMOVE_HYBRID_KEEPALIVE_PERIOD_MS					250		// keep alive period while a LowLevel sequence is executed by the MidLevel protocol
+#define REHAMOVE_HYBRID_ACK_TIMEOUT_MS						100		// deadline for the acknowledgements of the protocol switch
 
 #define REHAMOVE_MODE_LOWLEVEL_PREDEDINED					1
 #define REHAMOVE_MODE_LOWLEVEL_CUSTOM						2
@@ -143,6 +185,47 @@ enum PulseShapes_t {
 	LastPulsShape										= 16
 };
 
+/*
+ * Helper for the data exchange between the threads without locks
+ * -> GCC atomic builtins, since the code has to compile with C++98; both types are POD and can be cleared with memset
+ */
+template <typename T>
+struct rmAtomic {
+	volatile T Value;
+	inline T	Load(void) const		{ return __atomic_load_n(&Value, __ATOMIC_ACQUIRE); }
+	inline void	Store(T NewValue)		{ __atomic_store_n(&Value, NewValue, __ATOMIC_RELEASE); }
+	inline T	Exchange(T NewValue)	{ return __atomic_exchange_n(&Value, NewValue, __ATOMIC_ACQ_REL); }
+	inline T	FetchAdd(T Increment)	{ return __atomic_fetch_add(&Value, Increment, __ATOMIC_ACQ_REL); }
+	// false -> Expected is updated with the current value
+	inline bool	CompareExchange(T &Expected, T NewValue) { return __atomic_compare_exchange_n(&Value, &Expected, NewValue, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE); }
+	// counters -> no ordering needed
+	inline void	Add(T Increment)		{ __atomic_fetch_add(&Value, Increment, __ATOMIC_RELAXED); }
+};
+
+// sequence lock for records with more than one field; one writer, any number of readers which never block the writer
+struct rmSeqLock {
+	volatile uint32_t Sequence;
+	inline void WriteBegin(void) {
+		__atomic_store_n(&Sequence, Sequence +1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+	}
+	inline void WriteEnd(void) {
+		__atomic_store_n(&Sequence, Sequence +1, __ATOMIC_RELEASE);
+	}
+	inline uint32_t ReadBegin(void) const {
+		uint32_t Start;
+		// odd -> the writer is active
+		while ((Start = __atomic_load_n(&Sequence, __ATOMIC_ACQUIRE)) & 1) {}
+		return Start;
+	}
+	inline bool ReadRetry(uint32_t Start) const {
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		return (__atomic_load_n(&Sequence, __ATOMIC_RELAXED) != Start);
+	}
+};
+
+class RehaMove3Manager;
+
 class RehaMove3 {
 public:
 
@@ -158,10 +241,20 @@ public:
 		uint16_t ErrorRetestAfter;
 		bool  	 UseThreadForInit;
 		bool	 UseThreadForAcks;
+		double	 StatusPollPeriod_ms; // > 0 -> a helper thread requests the device status; GetCurrentStatus does not send requests anymore
+		// scheduling of the receiver and init threat; all 0 -> default attributes
+		int		 ThreadSchedPolicy;	  // SCHED_OTHER (0), SCHED_FIFO or SCHED_RR; needs root or CAP_SYS_NICE
+		int		 ThreadSchedPriority; // 1-99 for SCHED_FIFO and SCHED_RR
+		uint64_t ThreadCpuAffinity;	  // bit mask of the CPUs; 0 -> all CPUs
+		bool	 LockMemory;		  // mlock() the buffers of the library and prefault the stacks, so the threats do not get page faults during the stimulation; the host process is not locked
+		char	 DeviceCacheFile[255]; // != "" -> the device ID and the validated versions are cached per interface; the device ID is always read, the versions of a known device are checked after the initialisation
+		bool	 AutoReconnect;		  // a lost connection (e.g. USB disconnect) is detected by a watchdog threat, which opens and initialises the device again; needs UseThreadForAcks
 	};
 	struct rmLowLevelSettings_t {
 		uint8_t  HighVoltageLevel;
 		bool 	 UseDenervation;  // not implemented yet
+		bool	 UseHybridMode;	  // let the device (MidLevel protocol) execute stable sequences of the predefined LowLevel mode
+		uint16_t HybridStableSequences; // number of identical sequences before the sequence is handed over to the device
 	};
 	struct rmMidLevelSettings_t {
 		double GeneralStimFrequency;
@@ -173,6 +266,10 @@ public:
 		double RampsZeroUpdates;
 		bool   SendKeepAliveSignalDuringPeriodicMlUpdateCall;
 		double KeepAliveNumberOfUpdateCalls;
+		bool   UseTimerForKeepAliveSignal;	// send the keep alive signal from a helper thread instead of counting update calls
+		double KeepAlivePeriod_ms;
+		bool   UseUpdateMailbox;			// SendMidLevelUpdate only posts the update; a helper thread sends the latest one
+		double UpdateMinPeriod_ms;			// min. time between two updates send by the helper thread; KeepAliveNumberOfUpdateCalls and the ramps still count the update calls
 	};
 	struct rmDebugSettings_t{
 		bool printDeviceInfos;
@@ -187,6 +284,12 @@ public:
 		bool printStats;
 		bool useColors;
 		bool disableVersionCheck;
+		char   StatsExportFile[255];  // != "" -> a helper thread writes the statistics as Prometheus text file
+		double StatsExportPeriod_ms;
+		char   TelemetrySegmentName[64]; // != "" -> a helper thread publishes the status in /dev/shm/<name> (see RehaMove3Telemetry.hpp)
+		double TelemetryPeriod_ms;
+		char   TraceFile[255];		// != "" -> the trace is written to this file by DeInitialiseDevice (only with REHAMOVE_ENABLE_TRACE)
+		char   BinaryLogFile[255];	// != "" -> the pulse, ack and send command messages are written to this file instead of printed (see RehaMove3BinaryLog.hpp)
 	};
 	struct rmInitSettings_t {
 		// General
@@ -206,15 +309,79 @@ public:
 		bool DeviceLlIsInitialised;
 		bool DeviceMlIsInitialised;
 		bool DeviceInitialised;
+		bool Reconnecting;
 		bool DoNotStimulate;
 		uint16_t NumberOfStimErrors;
 		uint64_t LastUpdated;
 		uint8_t	 BatteryLevel;
 		float	 BatteryVoltage;
 		uint8_t  HighVoltageVoltage;
+		uint8_t  MainStatus;
+		uint8_t  StimStatus;
+		// age of the device status in ms; -1 -> not received yet
+		double	 BatteryAge_ms;
+		double	 MainStatusAge_ms;
+		double	 StimStatusAge_ms;
 	};
 	rmGetStatus_t GetCurrentStatus(bool DoPrintStatus, bool DoPrintStatistic, uint16_t WaitTimeout);
 
+	struct rmStatistics_t {
+		// inputs
+		uint64_t InvalidInput;
+		uint64_t InputCorrections_PulswidthOver;
+		uint64_t InputCorrections_PulswidthUnder;
+		uint64_t InputCorrections_CurrentOver;
+		uint64_t InputCorrections_CurrentUnder;
+		// LowLevel sequence execution
+		uint64_t SequencesSend;
+		uint64_t SequencesSuccessful;
+		uint64_t SequencesFailed;
+		uint64_t SequencesFailed_StimError;
+		uint64_t StimultionPulsesSend;
+		uint64_t StimultionPulsesNotSend;
+		uint64_t StimultionPulsesSuccessful;
+		uint64_t StimultionPulsesFailed;
+		uint64_t StimultionPulsesFailed_StimError;
+		// LowLevel hybrid mode
+		uint64_t HybridSequencesOffloaded;
+		uint64_t HybridOffloads;
+		uint64_t HybridFallbacks;
+		// MidLevel updates
+		uint64_t UpdatesSend;
+		uint64_t UpdatesFailed_StimError;
+		uint64_t UpdatesPosted;
+		uint64_t UpdatesTaken;
+		// connection
+		uint64_t SendErrors;
+		uint64_t Reconnects;
+		// per channel
+		struct rmChannelStatistics_t {
+			uint64_t PulsesSend;
+			uint64_t PulsesNotSend;
+			uint64_t PulsesSuccessful;
+			uint64_t PulsesFailed_StimError;
+			uint64_t UpdatesActive;
+		} Channel[REHAMOVE_NUMBER_OF_CHANNELS];
+		// debug
+		uint64_t LogMessagesDropped;
+		uint64_t BinaryLogRecordsDropped;
+	};
+	rmStatistics_t GetStatistics(void);
+	bool	WriteStatisticsFile(const char *FileName);
+
+	/*
+	 * Clock of the interface class -> the time stamps, timeouts and periods of the helper threats are based on it
+	 * -> default: CLOCK_MONOTONIC and usleep; a test driver can set a virtual clock (e.g. advanced by Sleep_us) before the initialisation
+	 */
+	struct rmClock_t {
+		uint64_t (*Now_ns)(void *Context);
+		void	 (*Sleep_us)(void *Context, uint32_t Duration_us);
+		void	 *Context;
+	};
+	bool	SetClock(const rmClock_t *NewClock);
+	uint64_t GetTimeStamp_us(void);
+	void	 SleepFor_us(uint32_t Duration_us);
+
 	struct actionResult_t {
 		bool 	finished;
 		bool	successful;
@@ -224,6 +391,51 @@ public:
 	bool 	InitialiseRehaMove3(rmInitSettings_t *InitSetup, actionResult_t *InitResult);
 	bool	InitialiseDevice(void);
 	bool 	IsDeviceInitialised(actionResult_t *InitResult);
+	bool	IsReconnecting(void);
+
+	/*
+	 * Device discovery -> used by the initialisation, if no interface but the serial number (RequestedDeviceID) is given
+	 * -> the interfaces of the vendor in /dev/serial/by-id (all ttyUSB/ttyACM interfaces, if there are none), which are not opened
+	 *    by this process already, are probed in parallel with get_device_id
+	 * -> one discovery per process at a time; the interfaces are locked with flock() while they are probed or opened, busy ones are skipped
+	 */
+	struct rmDiscoveryProbe_t {
+		RehaMove3 *Device;
+		pthread_t Thread;
+		bool	ThreadStarted;
+		char	DevicePath[255];
+		char	DeviceID[Smpt_Length_Device_Id+1];
+		uint32_t MilliSecondsToWait;
+		bool	DeviceIdReceived;
+	};
+	bool	DiscoverDevice(const char *DeviceID, uint32_t MilliSecondsToWait);
+	uint8_t	CollectDiscoveryCandidates(rmDiscoveryProbe_t *Probes, const char *DirectoryName, const char *VendorName, uint32_t MilliSecondsToWait);
+	void	RunDiscoveryProbe(rmDiscoveryProbe_t *Probe);
+
+	// the acknowledgements are read by the receiver threat of the manager (see RehaMove3Manager.hpp) -> set by RehaMove3Manager::AddDevice()
+	bool	SetManager(RehaMove3Manager *NewManager);
+	// creates a threat with the scheduling policy, priority and CPU affinity (see rmStimSettings_t) -> returns the result of pthread_create()
+	static int CreateThreadWithAttributes(pthread_t *Thread, void *(*ThreadFunction)(void *), void *Argument, int SchedPolicy, int SchedPriority, uint64_t CpuAffinity);
+
+	/*
+	 * Duration of the initialisation phases -> the time of a failed phase is counted for this phase, before the reset
+	 * -> a running device is stopped and initialised again; a reset (10-15s) is only done if the device does not respond
+	 */
+	enum rmInitPhase_t {
+		rmInitPhase_Open = 0,		// open the serial interface, start the receiver
+		rmInitPhase_Probe,			// device ID, battery, versions, stim status
+		rmInitPhase_Stop,			// stop the LowLevel/MidLevel protocol of a running device
+		rmInitPhase_ProtocolInit,	// ll_init / ml_init
+		rmInitPhase_Checks,			// stim and main status
+		rmInitPhase_Reset,			// device resets
+		rmInitPhase_NumberOfPhases
+	};
+	struct rmInitTiming_t {
+		double  Phase_ms[rmInitPhase_NumberOfPhases];
+		double  Total_ms;
+		uint8_t NumberOfResets;
+	};
+	bool	GetInitTiming(rmInitTiming_t *InitTiming);
 
 	struct LlPulseConfig_t {
 		uint8_t  Channel;
@@ -264,15 +476,28 @@ public:
 	};
 	bool 	SendMidLevelUpdate(MlUpdateConfig_t *SequenceConfig);
 	bool    SendMidLevelKeepAliveSignal(void);
+	void	RunMidLevelKeepAliveTimer(void);
+	void	RunMidLevelUpdateSender(void);
+	void	RunStatusPoller(void);
+	void	RunStatisticsExporter(void);
+	void	RunTelemetryPublisher(void);
+	void	RunLogger(void);
+	void	RunDeviceCheck(void);
+	void	RunReconnectWatchdog(void);
 
     bool 	GetLastLowLevelStimulationResult(double *PulseErrors, uint64_t SequenceID);
     bool 	GetLastMidLevelStimulationResult(double *PulseErrors);
+    bool 	GetLowLevelSequenceTiming(uint64_t SequenceID, uint64_t *SendTime_us, uint64_t *AckTime_us);
+    uint64_t GetLowLevelAckLatency_us(void);
 
 	bool 	DeInitialiseDevice(bool doPrintInfos, bool doPrintStats);
 
 	bool 	ReadAcks(void);
     bool 	DoDeviceReset(void);
 
+	// warnings and errors of the manager and the registry -> printed by the logger threat of the device; without a device (NULL) directly
+	static void printExternalMessage(RehaMove3 *Device, bool IsError, const char *format, ... );
+
 private:
     enum printMessageType_t {
     	printMSG_general		= 1,
@@ -295,25 +520,67 @@ private:
 	Smpt_device Device;
 	char DeviceIDClass[100];
 	char DeviceFileName[255];
+	RehaMove3Manager *Manager;
+	char DeviceLinkName[255];	// /dev/serial/by-id link of the interface -> followed by the reconnect, if the tty is renamed
+	int  InterfaceLockFile;		// flock() on the interface while it is open -> the discoveries of other processes skip it
+	rmClock_t Clock;
 
 	struct rmStatus_t {
-		// General
-		bool DeviceIsOpen;
-		bool DeviceInitialised;
-		bool DeviceLlIsInitialised;
-		bool DeviceMlIsInitialised;
-		bool InitThreatRunning;
-		bool InitThreatActive;
-		bool ReceiverThreatRunning;
-		bool ReceiverThreatActive;
-		uint8_t LocalPackageNumber;
-		uint64_t StartTime_ms;
-		uint64_t CurrentTime_ms;
-		uint64_t LastUpdated;
-		bool DoNotStimulate;
-		uint16_t NumberOfStimErrors;
+		// General -> the flags shared between the threads are atomic
+		rmAtomic<bool> DeviceIsOpen;
+		rmAtomic<bool> DeviceInitialised;
+		rmAtomic<bool> DeviceLlIsInitialised;
+		rmAtomic<bool> DeviceMlIsInitialised;
+		rmAtomic<bool> InitThreatRunning;
+		rmAtomic<bool> InitThreatActive;
+		rmAtomic<bool> ReceiverThreatRunning;
+		rmAtomic<bool> ReceiverThreatActive;
+		rmAtomic<bool> KeepAliveThreatRunning;
+		rmAtomic<bool> KeepAliveThreatActive;
+		rmAtomic<bool> MlUpdateThreatRunning;
+		rmAtomic<bool> MlUpdateThreatActive;
+		rmAtomic<bool> StatusPollThreatRunning;
+		rmAtomic<bool> StatusPollThreatActive;
+		rmAtomic<bool> StatsExportThreatRunning;
+		rmAtomic<bool> StatsExportThreatActive;
+		rmAtomic<bool> TelemetryThreatRunning;
+		rmAtomic<bool> TelemetryThreatActive;
+		rmAtomic<bool> LoggerThreatRunning;
+		rmAtomic<bool> LoggerThreatActive;
+		rmAtomic<bool> DeviceCheckThreatRunning;
+		rmAtomic<bool> DeviceCheckThreatActive;
+		rmAtomic<bool> ReconnectThreatRunning;
+		rmAtomic<bool> ReconnectThreatActive;
+		rmAtomic<bool> Reconnecting;		// the connection was lost -> the device is opened and initialised again by the watchdog threat
+		rmAtomic<uint64_t> LastAckReceived_us;	// written by the receiver
+		bool DeviceCacheUsed;		// the versions were taken from the device cache -> checked by the device check threat
+		bool MemoryLocked;			// the object (incl. the queues) is locked by mlock() -> unlocked by the destructor
+		rmAtomic<bool> HybridSequenceOffloaded;
+		rmAtomic<uint8_t> LocalPackageNumber;
+		// time -> CLOCK_MONOTONIC; the wall clock is only read once at the start of the session
+		uint64_t StartTime_ns;
+		uint64_t StartWallTime_us;
+		rmAtomic<uint64_t> CurrentTime_ns;	// since StartTime_ns; updated once per step and used for the time stamps of the messages
+		rmAtomic<uint64_t> LastUpdated;		// in ms since StartTime_ns
+		// written by the receiver: the retest settings are written before DoNotStimulate is set (release) and read after it (acquire)
+		rmAtomic<bool> DoNotStimulate;
+		rmAtomic<uint16_t> NumberOfStimErrors;
 		bool DoReTestTheStimError;
 		uint16_t NumberOfSequencesUntilErrorRetest;
+		// acknowledgement latencies -> written by the receiver
+		rmAtomic<uint64_t> LlAckLatencyLast_us;
+		rmAtomic<uint64_t> LlAckLatencyMax_us;
+		rmAtomic<uint64_t> LlAckLatencyMean_us;		// exponential average -> used to compensate the latency of the devices of a manager
+		rmAtomic<uint64_t> MlUpdateAckLatencyLast_us;
+		// timing of the first pulse of the last acknowledged sequence -> protected by the sequence queue lock
+		uint64_t LlFirstPulseSequenceNumber;
+		uint64_t LlFirstPulseSendTime_us;
+		uint64_t LlFirstPulseAckTime_us;
+		// initialisation -> written by the initialisation threat
+		rmInitTiming_t InitTiming;
+		uint8_t  InitPhase;
+		uint64_t InitPhaseStart_ns;
+		uint64_t InitStart_ns;
 
 		struct rmDeviceStatus_t {
 			// General
@@ -330,6 +597,19 @@ private:
 			uint8_t HighVoltageLevel;
 			uint8_t HighVoltageVoltage;
 		} Device;
+
+		// copy of the device status for GetCurrentStatus -> written by the receiver only
+		struct rmStatusSnapshot_t {
+			uint8_t  BatteryLevel;
+			float	 BatteryVoltage;
+			uint64_t BatteryUpdated_us;
+			uint8_t  MainStatus;
+			uint64_t MainStatusUpdated_us;
+			uint8_t  StimStatus;
+			uint8_t  HighVoltageVoltage;
+			uint64_t StimStatusUpdated_us;
+		} Snapshot;
+		rmSeqLock SnapshotLock;
 	} rmStatus;
 
 	rmInitSettings_t 	rmInitSettings;
@@ -344,7 +624,9 @@ private:
 		bool  	 UseThreadForInit;
 		bool	 UseThreadForAcks;
 		struct rmLowLevelSettings_t {
-			//
+			// hybrid mode
+			LlSequenceConfig_t HybridLastSequence;
+			uint32_t HybridStableSequences;
 		} LowLevel;
 		struct rmMidLevelSettings_t {
 			MlUpdateConfig_t CurrentMlStimConfig;
@@ -353,6 +635,18 @@ private:
 			int32_t  UpdateCallsUntilKeepAliveSignal;
 			bool     ChannelDisabled[REHAMOVE_NUMBER_OF_CHANNELS];
 			int32_t  UpdateCallsUntilRedoRamp[REHAMOVE_NUMBER_OF_CHANNELS];
+			// timer driven keep alive signal
+			double   KeepAlivePeriod_ms;				// configured period; set by the hybrid mode, if it is not configured
+			rmAtomic<uint64_t> KeepAliveLastSend_us;	// written by the senders, cleared by the receiver
+			rmAtomic<uint64_t> KeepAliveNextSend_us;	// written by the update function and the keep alive threat
+			rmAtomic<uint64_t> KeepAliveAckLatency_us;
+			rmAtomic<uint64_t> UpdateLastSend_us;
+			// latest-wins mailbox for the update thread -> written by SendMidLevelUpdate, read by the update thread
+			MlUpdateConfig_t MailboxConfig;
+			rmSeqLock		 MailboxLock;
+			rmAtomic<bool>	 MailboxFull;
+			rmAtomic<uint64_t> MailboxPosted;
+			rmAtomic<uint64_t> MailboxSend;
 		} MidLevel;
 	} rmSettings;
 
@@ -363,16 +657,31 @@ private:
 	actionResult_t* rmInitResultExtern;
     pthread_t       ReceiverThread;
     pthread_mutex_t ReadPackage_mutex;
+    pthread_t       KeepAliveThread;
+    pthread_t       MlUpdateThread;
+    pthread_t       StatusPollThread;
+    pthread_t       StatsExportThread;
+    pthread_t       TelemetryThread;
+    pthread_t       LoggerThread;
+    pthread_t       DeviceCheckThread;
+    pthread_t       ReconnectThread;
+    rmTelemetrySegment_t *TelemetrySegment;
+    int             TelemetryFile;
+    pthread_mutex_t SendPackage_mutex;
 
     struct RehaMoveAcks_t {
     	Smpt_get_device_id_ack 			G_device_id_ack;
-    	Smpt_get_version_ack 			G_version_ack;
+    	Smpt_get_version_ack 			G_version_main_ack;
+    	Smpt_get_version_ack 			G_version_stim_ack;
     	Smpt_ll_init_ack 				G_ll_init_ack;
-    	bool							G_ml_StimActive;
-    	bool							G_ml_StimError;
+    	rmAtomic<bool>					G_ml_StimActive;
+    	rmAtomic<bool>					G_ml_StimError;
+    	// written by the receiver only
     	Smpt_ml_get_current_data_ack	G_ml_current_data_ack;
+    	rmSeqLock						G_ml_current_data_lock;
+    	rmAtomic<bool>					G_ml_current_data_valid;
     } Acks;
-    pthread_mutex_t AcksLock_mutex;
+    pthread_mutex_t AcksLock_mutex; // only for the acks received during the initialisation
 
 	struct SingleResponse_t {
 		Smpt_Cmd Request;
@@ -396,6 +705,7 @@ private:
     			uint8_t Channel;
     			uint8_t PackageNumber;
     			uint8_t Result;
+    			uint64_t SendTime_us;
     		} StimulationPulse[REHAMOVE_MAX_SEQUENCE_SIZE];
     		uint64_t 					SequenceNumber;
     		bool						SequenceWasSuccessful;
@@ -409,36 +719,129 @@ private:
     } LlSequenceQueue;
     pthread_mutex_t LlSequenceQueueLock_mutex;
 
+    // counters updated by the sending thread(s) and the receiver -> relaxed atomics, read via GetStatistics()
     struct DeviceStatistic_t {
     	// inputs
-    	uint64_t InvalidInput;
-    	uint32_t InputCorrections_PulswidthOver;
-    	uint32_t InputCorrections_PulswidthUnder;
-    	uint32_t InputCorrections_CurrentOver;
-    	uint32_t InputCorrections_CurrentUnder;
+    	rmAtomic<uint64_t> InvalidInput;
+    	rmAtomic<uint64_t> InputCorrections_PulswidthOver;
+    	rmAtomic<uint64_t> InputCorrections_PulswidthUnder;
+    	rmAtomic<uint64_t> InputCorrections_CurrentOver;
+    	rmAtomic<uint64_t> InputCorrections_CurrentUnder;
     	// LowLevel sequence execution
-    	uint64_t SequencesSend;
-    	uint64_t SequencesNotSend;
-    	uint64_t SequencesSuccessful;
-    	uint64_t SequencesFailed;
-    	uint64_t SequencesFailed_StimError;
-    	uint64_t StimultionPulsesSend;
-    	uint64_t StimultionPulsesNotSend;
-    	uint64_t StimultionPulsesSuccessful;
-    	uint64_t StimultionPulsesFailed;
-    	uint64_t StimultionPulsesFailed_StimError;
+    	rmAtomic<uint64_t> SequencesSend;
+    	rmAtomic<uint64_t> SequencesSuccessful;
+    	rmAtomic<uint64_t> SequencesFailed;
+    	rmAtomic<uint64_t> SequencesFailed_StimError;
+    	rmAtomic<uint64_t> StimultionPulsesSend;
+    	rmAtomic<uint64_t> StimultionPulsesNotSend;
+    	rmAtomic<uint64_t> StimultionPulsesSuccessful;
+    	rmAtomic<uint64_t> StimultionPulsesFailed;
+    	rmAtomic<uint64_t> StimultionPulsesFailed_StimError;
+    	// LowLevel hybrid mode
+    	rmAtomic<uint64_t> HybridSequencesOffloaded;
+    	rmAtomic<uint64_t> HybridOffloads;
+    	rmAtomic<uint64_t> HybridFallbacks;
     	// MidLevel updates
-    	uint64_t UpdatesSend;
-    	uint64_t UpdatesFailed_StimError;
+    	rmAtomic<uint64_t> UpdatesSend;
+    	rmAtomic<uint64_t> UpdatesFailed_StimError;
+    	// connection
+    	rmAtomic<uint64_t> SendErrors;
+    	rmAtomic<uint64_t> Reconnects;
+    	// per channel
+    	struct DeviceChannelStatistic_t {
+    		rmAtomic<uint64_t> PulsesSend;
+    		rmAtomic<uint64_t> PulsesNotSend;
+    		rmAtomic<uint64_t> PulsesSuccessful;
+    		rmAtomic<uint64_t> PulsesFailed_StimError;
+    		rmAtomic<uint64_t> UpdatesActive;
+    	} Channel[REHAMOVE_NUMBER_OF_CHANNELS];
     } Stats;
 
+    // messages of printMessage() -> written by all threads, printed by the logger threat
+    enum logStyle_t {
+    	logStyle_plain		= 0,
+		logStyle_warning	= 1,
+		logStyle_error		= 2
+    };
+    struct LogQueue_t {
+    	struct LogMessage_t {
+    		rmAtomic<uint64_t> Sequence;	// == position +1 -> the message is ready to print; == position -> the slot is free
+    		uint8_t	Style;
+    		char	Text[REHAMOVE_LOG_MESSAGE_SIZE];
+    	} Queue[REHAMOVE_LOG_QUEUE_SIZE];
+    	rmAtomic<uint64_t> Head;	// next position to write; claimed by the writers via compare exchange
+    	rmAtomic<uint64_t> Tail;	// next position to print; written by the logger threat only
+    	rmAtomic<uint64_t> Dropped;
+    	sem_t	NewMessages;	// posted by the writers of both queues -> wakes the logger threat
+    } LogQueue;
+    // messages of logMessage() in binary form -> written by all threads, written to the file by the logger threat
+    struct BinaryLog_t {
+    	struct BinaryLogRecord_t {
+    		rmAtomic<uint64_t> Sequence;	// same as for the LogQueue
+    		rmBinLogRecord_t Record;
+    	} Queue[REHAMOVE_BINLOG_QUEUE_SIZE];
+    	rmAtomic<uint64_t> Head;
+    	rmAtomic<uint64_t> Tail;
+    	rmAtomic<bool>	   Active;
+    	rmAtomic<uint64_t> Dropped;		// queue full or the record could not be written
+    	FILE			   *File;
+    	pthread_mutex_t	   File_mutex;
+    } BinaryLog;
+
 	//private functions
 	bool 	 OpenSerial(void);
 	bool 	 CloseSerial(void);
 	void 	 AbortDeviceInitialisation();
+	void	 SetInitPhase(uint8_t NextPhase);
+	void	 PrintInitTiming(void);
+	struct rmDeviceCacheEntry_t {
+		char	DevicePath[255];
+		char	DeviceID[Smpt_Length_Device_Id+1];
+		Smpt_uc_version MainVersion;
+		Smpt_uc_version StimVersion;
+		uint8_t	HighVoltageLevel;
+	} DeviceCacheEntry;
+	bool	 ReadDeviceCache(const char *FileName, const char *DevicePath, rmDeviceCacheEntry_t *Entry);
+	bool	 UpdateDeviceCache(const char *FileName, const rmDeviceCacheEntry_t *Entry, bool DoRemove);
+	bool	 StartDeviceCheck(void);
+	void	 StopDeviceCheck(void);
+	bool	 StartReconnectWatchdog(void);
+	void	 StopReconnectWatchdog(void);
+	bool	 IsConnectionLost(uint64_t *LastSendErrors);
+	bool	 Reconnect(void);
+	void	 FindSerialLink(void);
+	bool	 StartMidLevelKeepAliveTimer(void);
+	void	 StopMidLevelKeepAliveTimer(void);
+	uint64_t GetMidLevelKeepAlivePeriod_us(void);
+	bool	 SendMidLevelUpdateNow(MlUpdateConfig_t *UpdateConfig, uint32_t NumberOfCalls);
+	bool	 StartStatusPoller(void);
+	void	 StopStatusPoller(void);
+	bool	 StartStatisticsExporter(void);
+	void	 StopStatisticsExporter(void);
+	bool	 StartTelemetryPublisher(void);
+	void	 StopTelemetryPublisher(void);
+	void	 PublishTelemetry(void);
+	int		 CreateRealTimeThread(pthread_t *Thread, void *(*ThreadFunction)(void *), const char *Name);
+	void	 PrefaultStack(void);
+	bool	 StartLogger(void);
+	void	 StopLogger(void);
+	bool	 PutLogMessage(uint8_t Style, bool DoWait, const char *format, va_list args);
+	bool	 PrintLogMessages(void);
+	void	 FlushLogMessages(void);
+	static void WriteLogMessage(uint8_t Style, const char *Text);
+	bool	 OpenBinaryLog(const char *FileName);
+	void	 CloseBinaryLog(void);
+	bool	 PutBinaryLogRecord(uint16_t MessageID, const double *Args, uint8_t NumberOfArgs);
+	bool	 WriteBinaryLogRecords(void);
+	bool	 StartMidLevelUpdateSender(void);
+	void	 StopMidLevelUpdateSender(void);
+	bool	 HandleHybridLowLevelSequence(LlSequenceConfig_t *SequenceConfig);
+	bool	 StartHybridOffload(LlSequenceConfig_t *SequenceConfig);
+	void	 StopHybridOffload(void);
 
 	inline void	 ReadAcksBlocking(void);
 	void 	 PutResponse(SingleResponse_t *Response);
+	void	 AddResponseExpectation(Smpt_Cmd ExpectedCommand, bool WaitForResponse);
 	int 	 GetResponse(Smpt_Cmd ExpectedCommand, bool DoIncreaseAckCounter, int MilliSecondsToWait);
 
 	uint64_t PutLLChannelResponseExpectation(uint64_t SequenceNumber, Smpt_Channel Channel, uint8_t PackageNumber);
@@ -449,18 +852,24 @@ private:
 	bool 	 CheckChannel(uint8_t ChannelIn);
 	uint16_t CheckAndCorrectPulsewidth(int Pulse_Width_IN, bool *Corrected);
 	float 	 CheckAndCorrectCurrent(float Current_IN, bool *Corrected);
+	uint8_t	 BuildPulseForm(LlPulseConfig_t *Pulse, LlPulseConfig_t *NextPulse, uint16_t *PulseWidth, float *Current, double *ChargeOverAll, uint8_t PulseNumber);
 	uint8_t	 GetMinimalCurrentPulse(uint16_t *PulseWidth, float *Current, double *Charge, uint8_t MaxNumberOfPoints);
 
 	uint8_t  GetPackageNumber(void);
 	uint8_t  GetLastPackageNumber(void);
 	bool 	 NewStatusUpdateReceived(uint32_t MilliSecondsToWait);
+	bool	 NewStatusUpdatesReceived(uint64_t Since_us, bool Battery, bool MainStatus, bool StimStatus, uint32_t MilliSecondsToWait);
+	int		 GetTimeUntil_ms(uint64_t Deadline_ms);
 	double 	 GetCurrentTime(void);
 	double 	 GetCurrentTime(bool DoUpdate);
+	uint64_t GetTimeStamp_ns(void);
 
 	const char*	GetResultString(Smpt_Result Result);
 	const char*	GetChannelNameString(Smpt_Channel Channel);
 	// Debug
 	void printMessage(printMessageType_t type, const char *format, ... );
+	bool IsMessageEnabled(printMessageType_t type, uint8_t *Style);
+	void logMessage(printMessageType_t type, uint16_t MessageID, uint32_t NumberOfArgs, ... );
 	void printBits(char *msgString, void const * const ptr, size_t const size);
 	void printSupportedVersion(char *msgString, const uint8_t SupportedVersions[][3]);
 };
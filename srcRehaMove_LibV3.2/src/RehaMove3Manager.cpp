@@ -0,0 +1,511 @@
+/*
+ *      TU Berlin --- Fachgebiet Regelungssystem
+ *      C++ Interface class for the Hasomed GmbH device RehaMove3
+ *
+ *      Author: agent
+ *      Copyright © 2026 agent <agent@local>. All rights reserved.
+ *
+ *      File:           RehaMove3Manager.cpp -> Source file for the manager of several RehaMove3 devices.
+ *      Version:        01 (2026)
+ *      Changelog:
+ *      	- 10.2026: initial release
+ *
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ *      NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include <RehaMove3Manager.hpp>
+
+
+namespace nsRehaMove3_SMPT_32X_01 {
+
+void *ManagerReceiverThreadFunc(void *data)
+{
+	RehaMove3Manager *Manager = (RehaMove3Manager *) data;
+	Manager->RunReceiver();
+	pthread_exit(NULL);
+}
+
+RehaMove3Manager::RehaMove3Manager(int ThreadSchedPolicy, int ThreadSchedPriority, uint64_t ThreadCpuAffinity)
+{
+	memset(&(this->Devices), 0, sizeof(this->Devices));
+	for (uint8_t i = 0; i < REHAMOVE_MANAGER_MAX_DEVICES; i++){
+		this->Devices[i].FileDescriptor = -1;
+	}
+	this->NumberOfDevices = 0;
+	memset(&(this->LastDispatch), 0, sizeof(this->LastDispatch));
+	this->SyncMaxOffset_us = REHAMOVE_MANAGER_SYNC_MAX_OFFSET_US;
+	memset(&(this->VirtualSequence), 0, sizeof(this->VirtualSequence));
+	pthread_mutex_init(&this->Devices_mutex, NULL);
+	this->ReceiverThread = 0;
+	this->ReceiverThreatRunning.Store(false);
+	this->ReceiverThreatActive.Store(false);
+
+	/*
+	 * Start the receiver threat -> it sleeps in epoll_wait() until an interface is attached
+	 */
+	this->EpollFile = epoll_create(REHAMOVE_MANAGER_MAX_DEVICES);
+	if (this->EpollFile < 0){
+		RehaMove3::printExternalMessage(NULL, true, "RehaMove3Manager Error: The epoll instance could not be created:\n     -> %s (%d)\n", strerror(errno), errno);
+		return;
+	}
+	this->ReceiverThreatActive.Store(true);
+	int ReturnValue = RehaMove3::CreateThreadWithAttributes(&(this->ReceiverThread), ManagerReceiverThreadFunc, (void *)this, ThreadSchedPolicy, ThreadSchedPriority, ThreadCpuAffinity);
+	if (ReturnValue != 0){
+		// the attributes are not allowed (e.g. no root) -> default attributes
+		RehaMove3::printExternalMessage(NULL, false, "RehaMove3Manager Warning: The receiver threat could not be started with the scheduling policy %d (priority %d) and the CPU mask 0x%lx:\n     -> %s (%d)\n     -> Using the default attributes instead.\n",
+				ThreadSchedPolicy, ThreadSchedPriority, (unsigned long)ThreadCpuAffinity, strerror(ReturnValue), ReturnValue);
+		ReturnValue = pthread_create(&(this->ReceiverThread), NULL, ManagerReceiverThreadFunc, (void *)this);
+	}
+	if (ReturnValue != 0) {
+		this->ReceiverThreatActive.Store(false);
+		this->ReceiverThread = 0;
+		RehaMove3::printExternalMessage(NULL, true, "RehaMove3Manager Error: The receiver threat could not be started:\n     -> %s (%d)\n", strerror(ReturnValue), ReturnValue);
+	}
+}
+
+RehaMove3Manager::~RehaMove3Manager(void)
+{
+	// the devices must not use the manager anymore
+	while (this->NumberOfDevices > 0){
+		RehaMove3Manager::RemoveDevice(this->Devices[this->NumberOfDevices -1].Device);
+	}
+	this->ReceiverThreatActive.Store(false);
+	if (this->ReceiverThread != 0){
+		//wait for the receiver threat to stop
+		pthread_join(this->ReceiverThread, NULL);
+		this->ReceiverThread = 0;
+	}
+	if (this->EpollFile >= 0){
+		close(this->EpollFile);
+	}
+	pthread_mutex_destroy(&this->Devices_mutex);
+}
+
+bool RehaMove3Manager::AddDevice(RehaMove3 *Device)
+{
+	if ((Device == NULL) || !this->ReceiverThreatActive.Load()){
+		return false;
+	}
+	pthread_mutex_lock(&(this->Devices_mutex));
+	if (this->NumberOfDevices >= REHAMOVE_MANAGER_MAX_DEVICES){
+		pthread_mutex_unlock(&(this->Devices_mutex));
+		RehaMove3::printExternalMessage(Device, true, "RehaMove3Manager Error: Only %u devices can be managed!\n", (unsigned int)REHAMOVE_MANAGER_MAX_DEVICES);
+		return false;
+	}
+	for (uint8_t i = 0; i < this->NumberOfDevices; i++){
+		if (this->Devices[i].Device == Device){
+			pthread_mutex_unlock(&(this->Devices_mutex));
+			return true;
+		}
+	}
+	pthread_mutex_unlock(&(this->Devices_mutex));
+	// the device refuses the manager, if its interface is already open
+	if (!Device->SetManager(this)){
+		return false;
+	}
+	pthread_mutex_lock(&(this->Devices_mutex));
+	this->Devices[this->NumberOfDevices].Device = Device;
+	this->Devices[this->NumberOfDevices].FileDescriptor = -1;
+	this->NumberOfDevices++;
+	pthread_mutex_unlock(&(this->Devices_mutex));
+	return true;
+}
+
+bool RehaMove3Manager::RemoveDevice(RehaMove3 *Device)
+{
+	pthread_mutex_lock(&(this->Devices_mutex));
+	uint8_t iDevice = 0;
+	while ((iDevice < this->NumberOfDevices) && (this->Devices[iDevice].Device != Device)){
+		iDevice++;
+	}
+	if (iDevice >= this->NumberOfDevices){
+		pthread_mutex_unlock(&(this->Devices_mutex));
+		return false;
+	}
+	if (this->Devices[iDevice].FileDescriptor >= 0){
+		epoll_ctl(this->EpollFile, EPOLL_CTL_DEL, this->Devices[iDevice].FileDescriptor, NULL);
+	}
+	// keep the order of the other devices -> the event data (index) of their interfaces is updated
+	for (uint8_t i = iDevice; i < this->NumberOfDevices -1; i++){
+		this->Devices[i] = this->Devices[i+1];
+		if (this->Devices[i].FileDescriptor >= 0){
+			struct epoll_event Event;
+			memset(&Event, 0, sizeof(Event));
+			Event.events = EPOLLIN;
+			Event.data.u32 = i;
+			epoll_ctl(this->EpollFile, EPOLL_CTL_MOD, this->Devices[i].FileDescriptor, &Event);
+		}
+	}
+	this->NumberOfDevices--;
+	this->Devices[this->NumberOfDevices].Device = NULL;
+	this->Devices[this->NumberOfDevices].FileDescriptor = -1;
+	for (uint8_t i = 0; i < this->LastDispatch.NumberOfDevices; i++){
+		if (this->LastDispatch.Device[i] == Device){
+			this->LastDispatch.NumberOfDevices = 0;
+		}
+	}
+	this->VirtualSequence.NumberOfDevices = 0;
+	pthread_mutex_unlock(&(this->Devices_mutex));
+	Device->SetManager(NULL);
+	return true;
+}
+
+uint8_t RehaMove3Manager::GetNumberOfDevices(void)
+{
+	return this->NumberOfDevices;
+}
+
+RehaMove3* RehaMove3Manager::GetDevice(uint8_t Index)
+{
+	if (Index >= this->NumberOfDevices){
+		return NULL;
+	}
+	return this->Devices[Index].Device;
+}
+
+bool RehaMove3Manager::SendNewPreDefinedLowLevelSequences(RehaMove3::LlSequenceConfig_t **SequenceConfigs, uint64_t *SequenceIDs)
+{
+	bool ReturnValue = true;
+	for (uint8_t i = 0; i < this->NumberOfDevices; i++){
+		if (SequenceConfigs[i] == NULL){
+			SequenceIDs[i] = 0;
+			continue;
+		}
+		ReturnValue &= this->Devices[i].Device->SendNewPreDefinedLowLevelSequence(SequenceConfigs[i], &SequenceIDs[i]);
+	}
+	return ReturnValue;
+}
+
+bool RehaMove3Manager::SendNewCustomLowLevelSequences(RehaMove3::CustomLlSequenceConfig_t **CustomSequenceConfigs, uint64_t *SequenceIDs)
+{
+	bool ReturnValue = true;
+	for (uint8_t i = 0; i < this->NumberOfDevices; i++){
+		if (CustomSequenceConfigs[i] == NULL){
+			SequenceIDs[i] = 0;
+			continue;
+		}
+		ReturnValue &= this->Devices[i].Device->SendNewCustomLowLevelSequence(CustomSequenceConfigs[i], &SequenceIDs[i]);
+	}
+	return ReturnValue;
+}
+
+bool RehaMove3Manager::SendMidLevelUpdates(RehaMove3::MlUpdateConfig_t **UpdateConfigs)
+{
+	bool ReturnValue = true;
+	for (uint8_t i = 0; i < this->NumberOfDevices; i++){
+		if (UpdateConfigs[i] == NULL){
+			continue;
+		}
+		ReturnValue &= this->Devices[i].Device->SendMidLevelUpdate(UpdateConfigs[i]);
+	}
+	return ReturnValue;
+}
+
+bool RehaMove3Manager::SendSynchronisedLowLevelSequences(RehaMove3::LlSequenceConfig_t **SequenceConfigs, uint64_t *SequenceIDs, double *ExpectedSkew_us)
+{
+	bool ReturnValue = true;
+	uint8_t  Order[REHAMOVE_MANAGER_MAX_DEVICES];
+	uint64_t Latency_us[REHAMOVE_MANAGER_MAX_DEVICES];
+	uint8_t  NumberToSend = 0;
+	this->LastDispatch.NumberOfDevices = 0;
+	if (ExpectedSkew_us != NULL){
+		*ExpectedSkew_us = 0.0;
+	}
+
+	// sort the devices by their averaged write-to-ack latency -> the sequence of the slowest device is send first
+	for (uint8_t i = 0; i < this->NumberOfDevices; i++){
+		SequenceIDs[i] = 0;
+		if (SequenceConfigs[i] == NULL){
+			continue;
+		}
+		Latency_us[i] = this->Devices[i].Device->GetLowLevelAckLatency_us();
+		uint8_t j = NumberToSend;
+		while ((j > 0) && (Latency_us[Order[j-1]] < Latency_us[i])){
+			Order[j] = Order[j-1];
+			j--;
+		}
+		Order[j] = i;
+		NumberToSend++;
+	}
+	if (NumberToSend == 0){
+		return true;
+	}
+
+	/*
+	 * send the sequences -> the one way latency is estimated as half of the write-to-ack latency
+	 * -> device i is send (LatencyMax - Latency_i)/2 after the slowest device; the offset is limited by SetSamplePeriod()
+	 * -> the step is slept until shortly before the send time, only the last REHAMOVE_MANAGER_SYNC_SPIN_US are spun
+	 */
+	uint64_t LatencyMax_us = Latency_us[Order[0]];
+	uint64_t StartTime_us = this->Devices[Order[0]].Device->GetTimeStamp_us();
+	double ExpectedStartMin_us = 0.0, ExpectedStartMax_us = 0.0;
+	for (uint8_t k = 0; k < NumberToSend; k++){
+		uint8_t i = Order[k];
+		uint64_t Offset_us = (LatencyMax_us - Latency_us[i]) /2;
+		if (Offset_us > this->SyncMaxOffset_us){
+			Offset_us = this->SyncMaxOffset_us;
+		}
+		uint64_t SendTime_us = this->Devices[i].Device->GetTimeStamp_us();
+		if ((SendTime_us + REHAMOVE_MANAGER_SYNC_SPIN_US) < (StartTime_us + Offset_us)){
+			this->Devices[i].Device->SleepFor_us((uint32_t)(StartTime_us + Offset_us - SendTime_us - REHAMOVE_MANAGER_SYNC_SPIN_US));
+			SendTime_us = this->Devices[i].Device->GetTimeStamp_us();
+		}
+		while (SendTime_us < (StartTime_us + Offset_us)){
+			SendTime_us = this->Devices[i].Device->GetTimeStamp_us();
+		}
+		ReturnValue &= this->Devices[i].Device->SendNewPreDefinedLowLevelSequence(SequenceConfigs[i], &SequenceIDs[i]);
+
+		double ExpectedStart_us = (double)SendTime_us + (double)Latency_us[i] /2.0;
+		if ((k == 0) || (ExpectedStart_us < ExpectedStartMin_us)){
+			ExpectedStartMin_us = ExpectedStart_us;
+		}
+		if ((k == 0) || (ExpectedStart_us > ExpectedStartMax_us)){
+			ExpectedStartMax_us = ExpectedStart_us;
+		}
+		if (SequenceIDs[i] != 0){
+			this->LastDispatch.Device[this->LastDispatch.NumberOfDevices] = this->Devices[i].Device;
+			this->LastDispatch.SequenceID[this->LastDispatch.NumberOfDevices] = SequenceIDs[i];
+			this->LastDispatch.NumberOfDevices++;
+		}
+	}
+	if (ExpectedSkew_us != NULL){
+		*ExpectedSkew_us = ExpectedStartMax_us - ExpectedStartMin_us;
+	}
+	return ReturnValue;
+}
+
+void RehaMove3Manager::SetSamplePeriod(double SamplePeriod_s)
+{
+	// the offsets delay the step function -> a part of the sample period at most
+	this->SyncMaxOffset_us = REHAMOVE_MANAGER_SYNC_MAX_OFFSET_US;
+	if ((SamplePeriod_s > 0.0) && ((SamplePeriod_s *1000000.0 *REHAMOVE_MANAGER_SYNC_MAX_OFFSET_FRACTION) < (double)REHAMOVE_MANAGER_SYNC_MAX_OFFSET_US)){
+		this->SyncMaxOffset_us = (uint64_t)(SamplePeriod_s *1000000.0 *REHAMOVE_MANAGER_SYNC_MAX_OFFSET_FRACTION);
+	}
+}
+
+bool RehaMove3Manager::GetSynchronisationSkew(double *AchievedSkew_us)
+{
+	/*
+	 * the pulse is expected in the middle between the write and the acknowledgement of the first pulse
+	 * -> false, if an acknowledgement of the last synchronised dispatch is missing
+	 */
+	if (this->LastDispatch.NumberOfDevices == 0){
+		return false;
+	}
+	double StartMin_us = 0.0, StartMax_us = 0.0;
+	for (uint8_t i = 0; i < this->LastDispatch.NumberOfDevices; i++){
+		uint64_t SendTime_us = 0, AckTime_us = 0;
+		if (!this->LastDispatch.Device[i]->GetLowLevelSequenceTiming(this->LastDispatch.SequenceID[i], &SendTime_us, &AckTime_us)){
+			return false;
+		}
+		double Start_us = ((double)SendTime_us + (double)AckTime_us) /2.0;
+		if ((i == 0) || (Start_us < StartMin_us)){
+			StartMin_us = Start_us;
+		}
+		if ((i == 0) || (Start_us > StartMax_us)){
+			StartMax_us = Start_us;
+		}
+	}
+	if (AchievedSkew_us != NULL){
+		*AchievedSkew_us = StartMax_us - StartMin_us;
+	}
+	return true;
+}
+
+bool RehaMove3Manager::GetDeviceChannel(uint8_t VirtualChannel, uint8_t *DeviceIndex, uint8_t *Channel)
+{
+	// the virtual channels start with 1 like the channels of the devices
+	if ((VirtualChannel == 0) || (VirtualChannel > this->NumberOfDevices *REHAMOVE_NUMBER_OF_CHANNELS)){
+		return false;
+	}
+	*DeviceIndex = (VirtualChannel -1) /REHAMOVE_NUMBER_OF_CHANNELS;
+	*Channel     = (VirtualChannel -1) %REHAMOVE_NUMBER_OF_CHANNELS +1;
+	return true;
+}
+
+bool RehaMove3Manager::SendNewPreDefinedLowLevelSequence(RehaMove3::LlSequenceConfig_t *SequenceConfig, double *ExpectedSkew_us)
+{
+	bool ReturnValue = true;
+	RehaMove3::LlSequenceConfig_t *SequenceConfigs[REHAMOVE_MANAGER_MAX_DEVICES];
+	for (uint8_t iDevice = 0; iDevice < this->NumberOfDevices; iDevice++){
+		this->DeviceSequenceConfigs[iDevice].NumberOfPulses = 0;
+		SequenceConfigs[iDevice] = &(this->DeviceSequenceConfigs[iDevice]);
+	}
+	// split the sequence -> the order of the pulses of one device is kept
+	for (uint8_t i = 0; i < SequenceConfig->NumberOfPulses; i++){
+		uint8_t iDevice = 0, Channel = 0;
+		if (!RehaMove3Manager::GetDeviceChannel(SequenceConfig->PulseConfig[i].Channel, &iDevice, &Channel)){
+			// printed by the logger of the first device -> the send path does not block on the console
+			RehaMove3::printExternalMessage(this->Devices[0].Device, true, "RehaMove3Manager Error: The channel %u is not available on the %u devices -> the pulse is not send!\n", (unsigned int)SequenceConfig->PulseConfig[i].Channel, (unsigned int)this->NumberOfDevices);
+			ReturnValue = false;
+			continue;
+		}
+		RehaMove3::LlSequenceConfig_t *DeviceConfig = &(this->DeviceSequenceConfigs[iDevice]);
+		if (DeviceConfig->NumberOfPulses >= REHAMOVE_MAX_SEQUENCE_SIZE){
+			ReturnValue = false;
+			continue;
+		}
+		DeviceConfig->PulseConfig[DeviceConfig->NumberOfPulses] = SequenceConfig->PulseConfig[i];
+		DeviceConfig->PulseConfig[DeviceConfig->NumberOfPulses].Channel = Channel;
+		this->VirtualSequence.PulseIndex[iDevice][DeviceConfig->NumberOfPulses] = i;
+		DeviceConfig->NumberOfPulses++;
+	}
+	// send the sequences of all devices, also the empty ones -> every device has a result for this step
+	ReturnValue &= RehaMove3Manager::SendSynchronisedLowLevelSequences(SequenceConfigs, this->VirtualSequence.SequenceIDs, ExpectedSkew_us);
+	this->VirtualSequence.NumberOfDevices = this->NumberOfDevices;
+	return ReturnValue;
+}
+
+bool RehaMove3Manager::SendNewCustomLowLevelSequence(RehaMove3::CustomLlSequenceConfig_t *CustomSequenceConfig)
+{
+	bool ReturnValue = true;
+	RehaMove3::CustomLlSequenceConfig_t *CustomSequenceConfigs[REHAMOVE_MANAGER_MAX_DEVICES];
+	for (uint8_t iDevice = 0; iDevice < this->NumberOfDevices; iDevice++){
+		this->DeviceCustomSequenceConfigs[iDevice].NumberOfPulses = 0;
+		CustomSequenceConfigs[iDevice] = &(this->DeviceCustomSequenceConfigs[iDevice]);
+	}
+	for (uint8_t i = 0; i < CustomSequenceConfig->NumberOfPulses; i++){
+		uint8_t iDevice = 0, Channel = 0;
+		if (!RehaMove3Manager::GetDeviceChannel(CustomSequenceConfig->PulseConfig[i].Channel, &iDevice, &Channel)){
+			RehaMove3::printExternalMessage(this->Devices[0].Device, true, "RehaMove3Manager Error: The channel %u is not available on the %u devices -> the pulse is not send!\n", (unsigned int)CustomSequenceConfig->PulseConfig[i].Channel, (unsigned int)this->NumberOfDevices);
+			ReturnValue = false;
+			continue;
+		}
+		RehaMove3::CustomLlSequenceConfig_t *DeviceConfig = &(this->DeviceCustomSequenceConfigs[iDevice]);
+		if (DeviceConfig->NumberOfPulses >= REHAMOVE_MAX_SEQUENCE_SIZE){
+			ReturnValue = false;
+			continue;
+		}
+		DeviceConfig->PulseConfig[DeviceConfig->NumberOfPulses] = CustomSequenceConfig->PulseConfig[i];
+		DeviceConfig->PulseConfig[DeviceConfig->NumberOfPulses].Channel = Channel;
+		this->VirtualSequence.PulseIndex[iDevice][DeviceConfig->NumberOfPulses] = i;
+		DeviceConfig->NumberOfPulses++;
+	}
+	ReturnValue &= RehaMove3Manager::SendNewCustomLowLevelSequences(CustomSequenceConfigs, this->VirtualSequence.SequenceIDs);
+	this->VirtualSequence.NumberOfDevices = this->NumberOfDevices;
+	return ReturnValue;
+}
+
+bool RehaMove3Manager::GetLastLowLevelStimulationResult(double *PulseErrors)
+{
+	/*
+	 * results of the last sequence with virtual channels
+	 * -> PulseErrors: like the result of one device -> the number (index +1) of the failed pulse in the virtual sequence
+	 */
+	bool ReturnValue = true;
+	if (PulseErrors != NULL){
+		*PulseErrors = 0.0;
+	}
+	for (uint8_t iDevice = 0; (iDevice < this->VirtualSequence.NumberOfDevices) && (iDevice < this->NumberOfDevices); iDevice++){
+		double DeviceErrors = 0.0;
+		if (!this->Devices[iDevice].Device->GetLastLowLevelStimulationResult(&DeviceErrors, this->VirtualSequence.SequenceIDs[iDevice])){
+			ReturnValue = false;
+			uint8_t iPulse = (uint8_t)DeviceErrors;
+			if ((PulseErrors != NULL) && (iPulse > 0) && (iPulse <= REHAMOVE_MAX_SEQUENCE_SIZE)){
+				*PulseErrors = this->VirtualSequence.PulseIndex[iDevice][iPulse -1] +1;
+			}
+		}
+	}
+	return ReturnValue;
+}
+
+bool RehaMove3Manager::GetLastMidLevelStimulationResult(double *PulseErrors)
+{
+	// PulseErrors: the virtual channel (index +1) with an error
+	bool ReturnValue = true;
+	if (PulseErrors != NULL){
+		*PulseErrors = 0.0;
+	}
+	for (uint8_t iDevice = 0; iDevice < this->NumberOfDevices; iDevice++){
+		double DeviceErrors = 0.0;
+		if (!this->Devices[iDevice].Device->GetLastMidLevelStimulationResult(&DeviceErrors)){
+			ReturnValue = false;
+			if ((PulseErrors != NULL) && (DeviceErrors > 0.0)){
+				*PulseErrors = DeviceErrors + iDevice *REHAMOVE_NUMBER_OF_CHANNELS;
+			}
+		}
+	}
+	return ReturnValue;
+}
+
+bool RehaMove3Manager::AttachInterface(RehaMove3 *Device, int FileDescriptor)
+{
+	pthread_mutex_lock(&(this->Devices_mutex));
+	for (uint8_t i = 0; i < this->NumberOfDevices; i++){
+		if (this->Devices[i].Device != Device){
+			continue;
+		}
+		struct epoll_event Event;
+		memset(&Event, 0, sizeof(Event));
+		Event.events = EPOLLIN;
+		Event.data.u32 = i;
+		if (epoll_ctl(this->EpollFile, EPOLL_CTL_ADD, FileDescriptor, &Event) != 0){
+			int Error = errno;
+			pthread_mutex_unlock(&(this->Devices_mutex));
+			RehaMove3::printExternalMessage(Device, true, "RehaMove3Manager Error: The interface could not be added to the epoll instance:\n     -> %s (%d)\n", strerror(Error), Error);
+			return false;
+		}
+		this->Devices[i].FileDescriptor = FileDescriptor;
+		pthread_mutex_unlock(&(this->Devices_mutex));
+		return true;
+	}
+	pthread_mutex_unlock(&(this->Devices_mutex));
+	return false;
+}
+
+void RehaMove3Manager::DetachInterface(RehaMove3 *Device)
+{
+	// the receiver threat holds the mutex while it reads -> no acknowledgement of this device is read after the return
+	pthread_mutex_lock(&(this->Devices_mutex));
+	for (uint8_t i = 0; i < this->NumberOfDevices; i++){
+		if ((this->Devices[i].Device == Device) && (this->Devices[i].FileDescriptor >= 0)){
+			epoll_ctl(this->EpollFile, EPOLL_CTL_DEL, this->Devices[i].FileDescriptor, NULL);
+			this->Devices[i].FileDescriptor = -1;
+		}
+	}
+	pthread_mutex_unlock(&(this->Devices_mutex));
+}
+
+void RehaMove3Manager::RunReceiver(void)
+{
+	this->ReceiverThreatRunning.Store(true);
+	struct epoll_event Events[REHAMOVE_MANAGER_MAX_DEVICES];
+
+	while (this->ReceiverThreatActive.Load()){
+		int NumberOfEvents = epoll_wait(this->EpollFile, Events, REHAMOVE_MANAGER_MAX_DEVICES, REHAMOVE_MANAGER_EPOLL_TIMEOUT_MS);
+		if ((NumberOfEvents < 0) && (errno != EINTR)){
+			RehaMove3::printExternalMessage(NULL, true, "RehaMove3Manager Error: Waiting for the interfaces failed:\n     -> %s (%d)\n", strerror(errno), errno);
+			break;
+		}
+		pthread_mutex_lock(&(this->Devices_mutex));
+		if (NumberOfEvents > 0){
+			// read all acknowledgements of the devices with data
+			for (int i = 0; i < NumberOfEvents; i++){
+				uint32_t iDevice = Events[i].data.u32;
+				if ((iDevice < this->NumberOfDevices) && (this->Devices[iDevice].FileDescriptor >= 0)){
+					this->Devices[iDevice].Device->ReadAcks();
+				}
+			}
+		} else if (NumberOfEvents == 0){
+			// timeout -> read the acknowledgements, which were read from the interface but not taken from the SMPT library yet
+			for (uint8_t iDevice = 0; iDevice < this->NumberOfDevices; iDevice++){
+				if (this->Devices[iDevice].FileDescriptor >= 0){
+					this->Devices[iDevice].Device->ReadAcks();
+				}
+			}
+		}
+		pthread_mutex_unlock(&(this->Devices_mutex));
+	}
+
+	// done
+	this->ReceiverThreatRunning.Store(false);
+}
+
+} // namespace
@@ -0,0 +1,113 @@
+/*
+ *      TU Berlin --- Fachgebiet Regelungssystem
+ *      C++ Interface class for the Hasomed GmbH device RehaMove3
+ *
+ *      Author: agent
+ *      Copyright © 2026 agent <agent@local>. All rights reserved.
+ *
+ *      File:           RehaMove3Manager.hpp -> Header file for the manager of several RehaMove3 devices.
+ *      Version:        01 (2026)
+ *      Changelog:
+ *      	- 10.2026: initial release
+ *
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ *      NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef REHAMOVE3MANAGER_H
+#define REHAMOVE3MANAGER_H
+
+#include <sys/epoll.h>
+
+#include "RehaMove3Interface_SMPT32X.hpp"
+
+#define REHAMOVE_MANAGER_MAX_DEVICES						8
+#define REHAMOVE_MANAGER_EPOLL_TIMEOUT_MS					100		// all devices are read after this time without an event -> acknowledgements buffered by the SMPT library
+#define REHAMOVE_MANAGER_SYNC_MAX_OFFSET_US					5000	// the send time of a device is never delayed longer than this
+#define REHAMOVE_MANAGER_SYNC_MAX_OFFSET_FRACTION			0.1		// ... and never longer than this part of the sample period
+#define REHAMOVE_MANAGER_SYNC_SPIN_US						100		// longer offsets are slept; only the last part is spun for the accuracy
+
+namespace nsRehaMove3_SMPT_32X_01 {
+
+/*
+ * Manager of several devices -> the acknowledgements of all devices are read by one receiver threat, which sleeps in epoll_wait()
+ * until one of the interfaces has data; the devices do not start an own receiver threat
+ *
+ * -> the devices are added before their initialisation and removed after their deinitialisation (or deleted)
+ * -> the configurations of the Send* functions are given per device in the order in which the devices were added; NULL -> skipped
+ * -> virtual channels: the channels 1-4 belong to the first device, the channels 5-8 to the second device, ...; a sequence with
+ *    virtual channels is split into one sequence per device, which are send synchronised; the results are joined again
+ * -> SendSynchronisedLowLevelSequences() delays the sequences of the devices with a shorter write-to-ack latency, so that the
+ *    expected start times on the devices (send time + half of the averaged latency) line up; all devices must use the same clock
+ */
+class RehaMove3Manager {
+public:
+
+	// the receiver threat is created with the scheduling policy, priority and CPU affinity (see RehaMove3::rmStimSettings_t)
+	RehaMove3Manager(int ThreadSchedPolicy = SCHED_OTHER, int ThreadSchedPriority = 0, uint64_t ThreadCpuAffinity = 0);
+	~RehaMove3Manager(void);
+
+	bool	AddDevice(RehaMove3 *Device);
+	bool	RemoveDevice(RehaMove3 *Device);
+	uint8_t	GetNumberOfDevices(void);
+	RehaMove3* GetDevice(uint8_t Index);
+
+	bool	SendNewPreDefinedLowLevelSequences(RehaMove3::LlSequenceConfig_t **SequenceConfigs, uint64_t *SequenceIDs);
+	bool	SendNewCustomLowLevelSequences(RehaMove3::CustomLlSequenceConfig_t **CustomSequenceConfigs, uint64_t *SequenceIDs);
+	bool	SendMidLevelUpdates(RehaMove3::MlUpdateConfig_t **UpdateConfigs);
+	bool	SendSynchronisedLowLevelSequences(RehaMove3::LlSequenceConfig_t **SequenceConfigs, uint64_t *SequenceIDs, double *ExpectedSkew_us);
+	void	SetSamplePeriod(double SamplePeriod_s);	// limits the send offsets of the synchronisation to a part of the sample period
+	bool	GetSynchronisationSkew(double *AchievedSkew_us);
+
+	// virtual channels over all devices
+	bool	GetDeviceChannel(uint8_t VirtualChannel, uint8_t *DeviceIndex, uint8_t *Channel);
+	bool	SendNewPreDefinedLowLevelSequence(RehaMove3::LlSequenceConfig_t *SequenceConfig, double *ExpectedSkew_us);
+	bool	SendNewCustomLowLevelSequence(RehaMove3::CustomLlSequenceConfig_t *CustomSequenceConfig);
+	bool	GetLastLowLevelStimulationResult(double *PulseErrors);
+	bool	GetLastMidLevelStimulationResult(double *PulseErrors);
+
+	// used by the devices when the interface is opened and closed
+	bool	AttachInterface(RehaMove3 *Device, int FileDescriptor);
+	void	DetachInterface(RehaMove3 *Device);
+
+	void	RunReceiver(void);
+
+private:
+	struct rmManagedDevice_t {
+		RehaMove3 *Device;
+		int		  FileDescriptor;	// -1 -> the interface is not open
+	} Devices[REHAMOVE_MANAGER_MAX_DEVICES];
+	uint8_t	NumberOfDevices;
+	pthread_mutex_t Devices_mutex;	// held by the receiver threat while the acknowledgements of a device are read
+
+	// last synchronised dispatch -> the achieved skew is calculated from the acknowledgements of the first pulses
+	struct rmSyncDispatch_t {
+		RehaMove3 *Device[REHAMOVE_MANAGER_MAX_DEVICES];
+		uint64_t SequenceID[REHAMOVE_MANAGER_MAX_DEVICES];
+		uint8_t	 NumberOfDevices;
+	} LastDispatch;
+	uint64_t SyncMaxOffset_us;
+
+	// last sequence with virtual channels -> index of the pulse in the virtual sequence for each pulse of the device sequences
+	struct rmVirtualSequence_t {
+		uint64_t SequenceIDs[REHAMOVE_MANAGER_MAX_DEVICES];
+		uint8_t  PulseIndex[REHAMOVE_MANAGER_MAX_DEVICES][REHAMOVE_MAX_SEQUENCE_SIZE];
+		uint8_t  NumberOfDevices;
+	} VirtualSequence;
+	RehaMove3::LlSequenceConfig_t		DeviceSequenceConfigs[REHAMOVE_MANAGER_MAX_DEVICES];
+	RehaMove3::CustomLlSequenceConfig_t	DeviceCustomSequenceConfigs[REHAMOVE_MANAGER_MAX_DEVICES];
+
+	int		EpollFile;
+	pthread_t ReceiverThread;
+	rmAtomic<bool> ReceiverThreatRunning;
+	rmAtomic<bool> ReceiverThreatActive;
+};
+
+} // namespace
+
+#endif /* REHAMOVE3MANAGER_H */
@@ -0,0 +1,485 @@
+/*
+ *      TU Berlin --- Fachgebiet Regelungssystem
+ *      C++ Interface class for the Hasomed GmbH device RehaMove3
+ *
+ *      Author: agent
+ *      Copyright © 2026 agent <agent@local>. All rights reserved.
+ *
+ *      File:           RehaMove3Registry.cpp -> Source file for the process wide registry of shared RehaMove3 devices.
+ *      Version:        01 (2026)
+ *      Changelog:
+ *      	- 10.2026: initial release
+ *
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ *      NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include <RehaMove3Registry.hpp>
+
+
+namespace nsRehaMove3_SMPT_32X_01 {
+
+enum rmRegistryPending_t {
+	rmRegistryPending_none = 0,
+	rmRegistryPending_LowLevel,
+	rmRegistryPending_CustomLowLevel,
+	rmRegistryPending_MidLevel
+};
+
+struct rmRegistryEntry_t {
+	RehaMove3	*Device;
+	char		Key[PATH_MAX];
+	RehaMove3::rmInitSettings_t InitSettings;	// of the first user -> the device is initialised with them
+	// lock of the merged sequence and of the sends -> the registry lock is only held for the lookup and the users
+	pthread_mutex_t Lock;
+	bool		UserActive[REHAMOVE_REGISTRY_MAX_USERS];
+	bool		UserPosted[REHAMOVE_REGISTRY_MAX_USERS];
+	uint8_t		NumberOfUsers;
+	// owner of every channel -> a channel is owned by the first user, which posts a pulse for it, until this user releases the device
+	uint8_t		ChannelUser[REHAMOVE_NUMBER_OF_CHANNELS];
+	bool		ChannelConflictReported[REHAMOVE_REGISTRY_MAX_USERS];
+	// merged sequence of the current period -> user and index (in the sequence of the user) of every pulse
+	uint8_t		PendingType;
+	RehaMove3::LlSequenceConfig_t		SequenceConfig;
+	RehaMove3::CustomLlSequenceConfig_t	CustomSequenceConfig;
+	RehaMove3::MlUpdateConfig_t			MlUpdateConfig;
+	RehaMove3::MlUpdateConfig_t			UserMlUpdateConfig[REHAMOVE_REGISTRY_MAX_USERS];	// last posted update of every user
+	uint8_t		PulseUser[REHAMOVE_MAX_SEQUENCE_SIZE];
+	uint8_t		PulseIndex[REHAMOVE_MAX_SEQUENCE_SIZE];
+	// last send LowLevel sequence
+	uint64_t	SequenceID;
+	bool		SequenceSend;
+	uint8_t		SendPulseUser[REHAMOVE_MAX_SEQUENCE_SIZE];
+	uint8_t		SendPulseIndex[REHAMOVE_MAX_SEQUENCE_SIZE];
+	// result of the last send sequence -> the device removes a complete sequence from its queue, so the result is read only once
+	uint64_t	ResultSequenceID;
+	bool		ResultRead;
+	bool		ResultSuccessful;
+	uint8_t		ResultFailedPulse;	// number (index +1) of the failed pulse in the merged sequence; 0 -> none
+};
+
+static rmRegistryEntry_t*	rmRegistryEntries[REHAMOVE_REGISTRY_MAX_DEVICES];
+static pthread_mutex_t		rmRegistryLock = PTHREAD_MUTEX_INITIALIZER;	// lock order: rmRegistryLock -> Entry->Lock
+
+
+
+
+static void rmRegistryGetKey(char *Key, const char *DevicePath, const char *DeviceID)
+{
+	// the same interface can be given by different paths (e.g. /dev/serial/by-id/...)
+	char RealPath[PATH_MAX];
+	if ((DevicePath != NULL) && (DevicePath[0] != 0)){
+		if (realpath(DevicePath, RealPath) != NULL){
+			snprintf(Key, PATH_MAX, "%s", RealPath);
+		} else {
+			snprintf(Key, PATH_MAX, "%s", DevicePath);
+		}
+	} else {
+		snprintf(Key, PATH_MAX, "ID:%s", (DeviceID != NULL) ? DeviceID : "");
+	}
+}
+
+static const char* rmRegistryCompareSettings(const RehaMove3::rmInitSettings_t *First, const RehaMove3::rmInitSettings_t *Other)
+{
+	// the name of the first setting, which differs; NULL -> the settings used by the device are the same
+	const RehaMove3::rmStimSettings_t *S1 = &First->StimConfig, *S2 = &Other->StimConfig;
+	if (S1->rmProtocol != S2->rmProtocol)								return "protocol";
+	if (S1->StimFrequency != S2->StimFrequency)							return "stimulation frequency";
+	if (S1->PulseWidthMax != S2->PulseWidthMax)							return "max. pulse width";
+	if (S1->CurrentMax != S2->CurrentMax)								return "max. current";
+	if ((S1->ErrorAbortAfter != S2->ErrorAbortAfter) || (S1->ErrorRetestAfter != S2->ErrorRetestAfter))	return "error handling";
+
+	const RehaMove3::rmLowLevelSettings_t *L1 = &First->LowLevelConfig, *L2 = &Other->LowLevelConfig;
+	if ((L1->HighVoltageLevel != L2->HighVoltageLevel) || (L1->UseDenervation != L2->UseDenervation) ||
+		(L1->UseHybridMode != L2->UseHybridMode) || (L1->HybridStableSequences != L2->HybridStableSequences))	return "LowLevel config";
+
+	const RehaMove3::rmMidLevelSettings_t *M1 = &First->MidLevelConfig, *M2 = &Other->MidLevelConfig;
+	if ((M1->GeneralStimFrequency != M2->GeneralStimFrequency) || (M1->UseDynamicStimulationFrequncy != M2->UseDynamicStimulationFrequncy) ||
+		(M1->UseSoftStart != M2->UseSoftStart) || (M1->UseRamps != M2->UseRamps) ||
+		(M1->SetRampsDuringPeriodicMlUpdateCall != M2->SetRampsDuringPeriodicMlUpdateCall) || (M1->RampsUpdates != M2->RampsUpdates) ||
+		(M1->RampsZeroUpdates != M2->RampsZeroUpdates) || (M1->SendKeepAliveSignalDuringPeriodicMlUpdateCall != M2->SendKeepAliveSignalDuringPeriodicMlUpdateCall) ||
+		(M1->KeepAliveNumberOfUpdateCalls != M2->KeepAliveNumberOfUpdateCalls) || (M1->UseTimerForKeepAliveSignal != M2->UseTimerForKeepAliveSignal) ||
+		(M1->KeepAlivePeriod_ms != M2->KeepAlivePeriod_ms) || (M1->UseUpdateMailbox != M2->UseUpdateMailbox) ||
+		(M1->UpdateMinPeriod_ms != M2->UpdateMinPeriod_ms))			return "MidLevel config";
+
+	const RehaMove3::rmDebugSettings_t *D1 = &First->DebugConfig, *D2 = &Other->DebugConfig;
+	if ((D1->printDeviceInfos != D2->printDeviceInfos) || (D1->printInitInfos != D2->printInitInfos) ||
+		(D1->printInitSettings != D2->printInitSettings) || (D1->printSendCmdInfos != D2->printSendCmdInfos) ||
+		(D1->printStimInfos != D2->printStimInfos) || (D1->printReceivedAckInfos != D2->printReceivedAckInfos) ||
+		(D1->printCorrectionChargeWarnings != D2->printCorrectionChargeWarnings) || (D1->printErrorsSequence != D2->printErrorsSequence) ||
+		(D1->printErrorsTiming != D2->printErrorsTiming) || (D1->printStats != D2->printStats) ||
+		(D1->useColors != D2->useColors) || (D1->disableVersionCheck != D2->disableVersionCheck))	return "debug flags";
+	return NULL;
+}
+
+static rmRegistryEntry_t* rmRegistryFindEntry(RehaMove3 *Device)
+{
+	for (uint8_t i = 0; i < REHAMOVE_REGISTRY_MAX_DEVICES; i++){
+		if ((rmRegistryEntries[i] != NULL) && (rmRegistryEntries[i]->Device == Device)){
+			return rmRegistryEntries[i];
+		}
+	}
+	return NULL;
+}
+
+static rmRegistryEntry_t* rmRegistryLockEntry(RehaMove3 *Device, uint8_t UserIndex)
+{
+	// the entry is locked before the registry is unlocked -> the entry can not be freed by the last release meanwhile
+	pthread_mutex_lock(&rmRegistryLock);
+	rmRegistryEntry_t *Entry = rmRegistryFindEntry(Device);
+	if ((Entry == NULL) || (UserIndex >= REHAMOVE_REGISTRY_MAX_USERS) || !Entry->UserActive[UserIndex]){
+		pthread_mutex_unlock(&rmRegistryLock);
+		return NULL;
+	}
+	pthread_mutex_lock(&(Entry->Lock));
+	pthread_mutex_unlock(&rmRegistryLock);
+	return Entry;
+}
+
+static bool rmRegistryClaimChannel(rmRegistryEntry_t *Entry, uint8_t UserIndex, uint8_t Channel)
+{
+	// false -> the channel is owned by another user; invalid channels are rejected by the device
+	if ((Channel < 1) || (Channel > REHAMOVE_NUMBER_OF_CHANNELS)){
+		return true;
+	}
+	uint8_t iCh = Channel -1;
+	if (Entry->ChannelUser[iCh] == REHAMOVE_REGISTRY_CHANNEL_FREE){
+		Entry->ChannelUser[iCh] = UserIndex;
+	}
+	if (Entry->ChannelUser[iCh] == UserIndex){
+		return true;
+	}
+	if (!Entry->ChannelConflictReported[UserIndex]){
+		Entry->ChannelConflictReported[UserIndex] = true;
+		RehaMove3::printExternalMessage(Entry->Device, true, "%s Error: Channel %u is already used by another block of this device -> the pulses of block %u for this channel are not send!\n",
+				Entry->Key, (unsigned int)Channel, (unsigned int)UserIndex +1);
+	}
+	return false;
+}
+
+static void rmRegistryMergeMidLevelUpdates(rmRegistryEntry_t *Entry)
+{
+	// the channels of all users are merged from their last posted update -> a user, which did not post in this period yet, keeps its channels
+	// -> the stored updates contain only the channels owned by the user, so every channel is set by one user only
+	memset(Entry->MlUpdateConfig.ActiveChannels, 0, sizeof(Entry->MlUpdateConfig.ActiveChannels));
+	for (uint8_t iUser = 0; iUser < REHAMOVE_REGISTRY_MAX_USERS; iUser++){
+		if (!Entry->UserActive[iUser]){
+			continue;
+		}
+		for (uint8_t iCh = 0; iCh < REHAMOVE_NUMBER_OF_CHANNELS; iCh++){
+			if (Entry->UserMlUpdateConfig[iUser].ActiveChannels[iCh]){
+				Entry->MlUpdateConfig.ActiveChannels[iCh] = true;
+				Entry->MlUpdateConfig.PulseConfig[iCh] = Entry->UserMlUpdateConfig[iUser].PulseConfig[iCh];
+			}
+		}
+	}
+}
+
+static bool rmRegistrySendMerged(rmRegistryEntry_t *Entry)
+{
+	// called with the lock of the entry
+	bool ReturnValue = true;
+	switch (Entry->PendingType){
+	case rmRegistryPending_LowLevel:
+		ReturnValue = Entry->Device->SendNewPreDefinedLowLevelSequence(&(Entry->SequenceConfig), &(Entry->SequenceID));
+		memcpy(Entry->SendPulseUser, Entry->PulseUser, sizeof(Entry->SendPulseUser));
+		memcpy(Entry->SendPulseIndex, Entry->PulseIndex, sizeof(Entry->SendPulseIndex));
+		Entry->SequenceSend = true;
+		break;
+	case rmRegistryPending_CustomLowLevel:
+		ReturnValue = Entry->Device->SendNewCustomLowLevelSequence(&(Entry->CustomSequenceConfig), &(Entry->SequenceID));
+		memcpy(Entry->SendPulseUser, Entry->PulseUser, sizeof(Entry->SendPulseUser));
+		memcpy(Entry->SendPulseIndex, Entry->PulseIndex, sizeof(Entry->SendPulseIndex));
+		Entry->SequenceSend = true;
+		break;
+	case rmRegistryPending_MidLevel:
+		rmRegistryMergeMidLevelUpdates(Entry);
+		ReturnValue = Entry->Device->SendMidLevelUpdate(&(Entry->MlUpdateConfig));
+		break;
+	default:;
+	}
+	// next period
+	Entry->PendingType = rmRegistryPending_none;
+	memset(Entry->UserPosted, 0, sizeof(Entry->UserPosted));
+	return ReturnValue;
+}
+
+static bool rmRegistryStartPost(rmRegistryEntry_t *Entry, uint8_t UserIndex, uint8_t Type)
+{
+	bool ReturnValue = true;
+	// the user did already post in this period or the protocol changed -> send the pulses of the other users first
+	if ((Entry->PendingType != rmRegistryPending_none) && (Entry->UserPosted[UserIndex] || (Entry->PendingType != Type))){
+		ReturnValue = rmRegistrySendMerged(Entry);
+	}
+	if (Entry->PendingType == rmRegistryPending_none){
+		Entry->PendingType = Type;
+		Entry->SequenceConfig.NumberOfPulses = 0;
+		Entry->CustomSequenceConfig.NumberOfPulses = 0;
+		Entry->MlUpdateConfig.ForceUpdate = false;
+		Entry->MlUpdateConfig.RedoRamp = false;
+	}
+	return ReturnValue;
+}
+
+static bool rmRegistryFinishPost(rmRegistryEntry_t *Entry, uint8_t UserIndex)
+{
+	Entry->UserPosted[UserIndex] = true;
+	for (uint8_t i = 0; i < REHAMOVE_REGISTRY_MAX_USERS; i++){
+		if (Entry->UserActive[i] && !Entry->UserPosted[i]){
+			// wait for the other users
+			return true;
+		}
+	}
+	return rmRegistrySendMerged(Entry);
+}
+
+
+RehaMove3* rmRegistryAcquireDevice(const char *DeviceName, const char *DevicePath, const char *DeviceID, const RehaMove3::rmInitSettings_t *InitSettings,
+		uint8_t *UserIndex, bool *IsFirstUser)
+{
+	char Key[PATH_MAX];
+	rmRegistryGetKey(Key, DevicePath, DeviceID);
+	*IsFirstUser = false;
+
+	pthread_mutex_lock(&rmRegistryLock);
+	// is the device already used?
+	for (uint8_t i = 0; i < REHAMOVE_REGISTRY_MAX_DEVICES; i++){
+		rmRegistryEntry_t *Entry = rmRegistryEntries[i];
+		if ((Entry == NULL) || (strcmp(Entry->Key, Key) != 0)){
+			continue;
+		}
+		// the device is initialised with the settings of the first user
+		const char *Difference = rmRegistryCompareSettings(&(Entry->InitSettings), InitSettings);
+		if (Difference != NULL){
+			pthread_mutex_unlock(&rmRegistryLock);
+			RehaMove3::printExternalMessage(Entry->Device, true, "%s Error: The device '%s' is used by another block with a different %s!\n     -> All blocks of one device must use the same settings.\n", DeviceName, Key, Difference);
+			return NULL;
+		}
+		for (uint8_t iUser = 0; iUser < REHAMOVE_REGISTRY_MAX_USERS; iUser++){
+			if (!Entry->UserActive[iUser]){
+				pthread_mutex_lock(&(Entry->Lock));
+				Entry->UserActive[iUser] = true;
+				Entry->UserPosted[iUser] = false;
+				Entry->ChannelConflictReported[iUser] = false;
+				memset(&(Entry->UserMlUpdateConfig[iUser]), 0, sizeof(RehaMove3::MlUpdateConfig_t));
+				Entry->NumberOfUsers++;
+				pthread_mutex_unlock(&(Entry->Lock));
+				*UserIndex = iUser;
+				pthread_mutex_unlock(&rmRegistryLock);
+				return Entry->Device;
+			}
+		}
+		pthread_mutex_unlock(&rmRegistryLock);
+		RehaMove3::printExternalMessage(Entry->Device, true, "%s Error: The device '%s' is already used by %u users!\n", DeviceName, Key, (unsigned int)REHAMOVE_REGISTRY_MAX_USERS);
+		return NULL;
+	}
+	// no -> create the device
+	for (uint8_t i = 0; i < REHAMOVE_REGISTRY_MAX_DEVICES; i++){
+		if (rmRegistryEntries[i] != NULL){
+			continue;
+		}
+		rmRegistryEntry_t *Entry = (rmRegistryEntry_t *)calloc(1, sizeof(rmRegistryEntry_t));
+		if (Entry == NULL){
+			break;
+		}
+		snprintf(Entry->Key, sizeof(Entry->Key), "%s", Key);
+		memcpy(&(Entry->InitSettings), InitSettings, sizeof(RehaMove3::rmInitSettings_t));
+		pthread_mutex_init(&(Entry->Lock), NULL);
+		memset(Entry->ChannelUser, REHAMOVE_REGISTRY_CHANNEL_FREE, sizeof(Entry->ChannelUser));
+		Entry->Device = new RehaMove3(DeviceName, DevicePath);
+		Entry->UserActive[0] = true;
+		Entry->NumberOfUsers = 1;
+		rmRegistryEntries[i] = Entry;
+		*UserIndex = 0;
+		*IsFirstUser = true;
+		pthread_mutex_unlock(&rmRegistryLock);
+		return Entry->Device;
+	}
+	pthread_mutex_unlock(&rmRegistryLock);
+	RehaMove3::printExternalMessage(NULL, true, "%s Error: Only %u devices can be registered!\n", DeviceName, (unsigned int)REHAMOVE_REGISTRY_MAX_DEVICES);
+	return NULL;
+}
+
+bool rmRegistryReleaseDevice(RehaMove3 *Device, uint8_t UserIndex)
+{
+	// true -> this was the last user; the device has to be deinitialised and deleted by the caller
+	pthread_mutex_lock(&rmRegistryLock);
+	rmRegistryEntry_t *Entry = rmRegistryFindEntry(Device);
+	if ((Entry == NULL) || (UserIndex >= REHAMOVE_REGISTRY_MAX_USERS) || !Entry->UserActive[UserIndex]){
+		pthread_mutex_unlock(&rmRegistryLock);
+		return false;
+	}
+	pthread_mutex_lock(&(Entry->Lock));
+	Entry->UserActive[UserIndex] = false;
+	Entry->UserPosted[UserIndex] = false;
+	memset(&(Entry->UserMlUpdateConfig[UserIndex]), 0, sizeof(RehaMove3::MlUpdateConfig_t));
+	for (uint8_t iCh = 0; iCh < REHAMOVE_NUMBER_OF_CHANNELS; iCh++){
+		if (Entry->ChannelUser[iCh] == UserIndex){
+			Entry->ChannelUser[iCh] = REHAMOVE_REGISTRY_CHANNEL_FREE;
+		}
+	}
+	Entry->NumberOfUsers--;
+	if (Entry->NumberOfUsers > 0){
+		pthread_mutex_unlock(&rmRegistryLock);
+		// the other users may be waiting for this user
+		if (Entry->PendingType != rmRegistryPending_none){
+			bool AllUsersPosted = true;
+			for (uint8_t i = 0; i < REHAMOVE_REGISTRY_MAX_USERS; i++){
+				AllUsersPosted &= (!Entry->UserActive[i] || Entry->UserPosted[i]);
+			}
+			if (AllUsersPosted){
+				rmRegistrySendMerged(Entry);
+			}
+		}
+		pthread_mutex_unlock(&(Entry->Lock));
+		return false;
+	}
+	// last user -> no other user can find the entry anymore and no post is running (entry lock)
+	for (uint8_t i = 0; i < REHAMOVE_REGISTRY_MAX_DEVICES; i++){
+		if (rmRegistryEntries[i] == Entry){
+			rmRegistryEntries[i] = NULL;
+		}
+	}
+	pthread_mutex_unlock(&rmRegistryLock);
+	pthread_mutex_unlock(&(Entry->Lock));
+	pthread_mutex_destroy(&(Entry->Lock));
+	free(Entry);
+	return true;
+}
+
+uint8_t rmRegistryGetNumberOfUsers(RehaMove3 *Device)
+{
+	uint8_t NumberOfUsers = 0;
+	pthread_mutex_lock(&rmRegistryLock);
+	rmRegistryEntry_t *Entry = rmRegistryFindEntry(Device);
+	if (Entry != NULL){
+		NumberOfUsers = Entry->NumberOfUsers;
+	}
+	pthread_mutex_unlock(&rmRegistryLock);
+	return NumberOfUsers;
+}
+
+bool rmRegistryPostLowLevelSequence(RehaMove3 *Device, uint8_t UserIndex, RehaMove3::LlSequenceConfig_t *SequenceConfig)
+{
+	rmRegistryEntry_t *Entry = rmRegistryLockEntry(Device, UserIndex);
+	if (Entry == NULL){
+		return false;
+	}
+	bool ReturnValue = rmRegistryStartPost(Entry, UserIndex, rmRegistryPending_LowLevel);
+	for (uint8_t i = 0; i < SequenceConfig->NumberOfPulses; i++){
+		if (!rmRegistryClaimChannel(Entry, UserIndex, SequenceConfig->PulseConfig[i].Channel)){
+			ReturnValue = false;
+			continue;
+		}
+		if (Entry->SequenceConfig.NumberOfPulses >= REHAMOVE_MAX_SEQUENCE_SIZE){
+			RehaMove3::printExternalMessage(Entry->Device, true, "%s Error: The merged sequence is full (%u pulses) -> the pulse is not send!\n", Entry->Key, (unsigned int)REHAMOVE_MAX_SEQUENCE_SIZE);
+			ReturnValue = false;
+			break;
+		}
+		Entry->SequenceConfig.PulseConfig[Entry->SequenceConfig.NumberOfPulses] = SequenceConfig->PulseConfig[i];
+		Entry->PulseUser[Entry->SequenceConfig.NumberOfPulses]  = UserIndex;
+		Entry->PulseIndex[Entry->SequenceConfig.NumberOfPulses] = i;
+		Entry->SequenceConfig.NumberOfPulses++;
+	}
+	ReturnValue &= rmRegistryFinishPost(Entry, UserIndex);
+	pthread_mutex_unlock(&(Entry->Lock));
+	return ReturnValue;
+}
+
+bool rmRegistryPostCustomLowLevelSequence(RehaMove3 *Device, uint8_t UserIndex, RehaMove3::CustomLlSequenceConfig_t *CustomSequenceConfig)
+{
+	rmRegistryEntry_t *Entry = rmRegistryLockEntry(Device, UserIndex);
+	if (Entry == NULL){
+		return false;
+	}
+	bool ReturnValue = rmRegistryStartPost(Entry, UserIndex, rmRegistryPending_CustomLowLevel);
+	for (uint8_t i = 0; i < CustomSequenceConfig->NumberOfPulses; i++){
+		if (!rmRegistryClaimChannel(Entry, UserIndex, CustomSequenceConfig->PulseConfig[i].Channel)){
+			ReturnValue = false;
+			continue;
+		}
+		if (Entry->CustomSequenceConfig.NumberOfPulses >= REHAMOVE_MAX_SEQUENCE_SIZE){
+			RehaMove3::printExternalMessage(Entry->Device, true, "%s Error: The merged sequence is full (%u pulses) -> the pulse is not send!\n", Entry->Key, (unsigned int)REHAMOVE_MAX_SEQUENCE_SIZE);
+			ReturnValue = false;
+			break;
+		}
+		Entry->CustomSequenceConfig.PulseConfig[Entry->CustomSequenceConfig.NumberOfPulses] = CustomSequenceConfig->PulseConfig[i];
+		Entry->PulseUser[Entry->CustomSequenceConfig.NumberOfPulses]  = UserIndex;
+		Entry->PulseIndex[Entry->CustomSequenceConfig.NumberOfPulses] = i;
+		Entry->CustomSequenceConfig.NumberOfPulses++;
+	}
+	ReturnValue &= rmRegistryFinishPost(Entry, UserIndex);
+	pthread_mutex_unlock(&(Entry->Lock));
+	return ReturnValue;
+}
+
+bool rmRegistryPostMidLevelUpdate(RehaMove3 *Device, uint8_t UserIndex, RehaMove3::MlUpdateConfig_t *UpdateConfig)
+{
+	rmRegistryEntry_t *Entry = rmRegistryLockEntry(Device, UserIndex);
+	if (Entry == NULL){
+		return false;
+	}
+	bool ReturnValue = rmRegistryStartPost(Entry, UserIndex, rmRegistryPending_MidLevel);
+	// the channels of all users are merged into one update when it is send -> only the channels owned by the user are stored
+	memcpy(&(Entry->UserMlUpdateConfig[UserIndex]), UpdateConfig, sizeof(RehaMove3::MlUpdateConfig_t));
+	for (uint8_t iCh = 0; iCh < REHAMOVE_NUMBER_OF_CHANNELS; iCh++){
+		if (UpdateConfig->ActiveChannels[iCh] && !rmRegistryClaimChannel(Entry, UserIndex, iCh +1)){
+			Entry->UserMlUpdateConfig[UserIndex].ActiveChannels[iCh] = false;
+			ReturnValue = false;
+		}
+	}
+	Entry->MlUpdateConfig.ForceUpdate |= UpdateConfig->ForceUpdate;
+	Entry->MlUpdateConfig.RedoRamp    |= UpdateConfig->RedoRamp;
+	ReturnValue &= rmRegistryFinishPost(Entry, UserIndex);
+	pthread_mutex_unlock(&(Entry->Lock));
+	return ReturnValue;
+}
+
+bool rmRegistryGetLastLowLevelStimulationResult(RehaMove3 *Device, uint8_t UserIndex, double *PulseErrors)
+{
+	/*
+	 * result of the last merged sequence for one user
+	 * -> PulseErrors: the number (index +1) of the failed pulse in the sequence of the user
+	 * -> the device reports one failed pulse per sequence; the sequence failed only for the user of this pulse
+	 */
+	if (PulseErrors != NULL){
+		*PulseErrors = 0.0;
+	}
+	rmRegistryEntry_t *Entry = rmRegistryLockEntry(Device, UserIndex);
+	if (Entry == NULL){
+		return Device->GetLastLowLevelStimulationResult(PulseErrors, 0);
+	}
+	if (!Entry->SequenceSend || (Entry->SequenceID == 0)){
+		// no sequence was send yet (or hybrid mode) -> as without registry
+		uint64_t SequenceID = Entry->SequenceID;
+		pthread_mutex_unlock(&(Entry->Lock));
+		return Device->GetLastLowLevelStimulationResult(PulseErrors, SequenceID);
+	}
+	if (!Entry->ResultRead || (Entry->ResultSequenceID != Entry->SequenceID)){
+		double Errors = 0.0;
+		Entry->ResultSuccessful  = Device->GetLastLowLevelStimulationResult(&Errors, Entry->SequenceID);
+		Entry->ResultFailedPulse = (uint8_t)Errors;
+		Entry->ResultSequenceID  = Entry->SequenceID;
+		Entry->ResultRead = true;
+	}
+	bool ReturnValue = Entry->ResultSuccessful;
+	if (!ReturnValue && (Entry->ResultFailedPulse > 0) && (Entry->ResultFailedPulse <= REHAMOVE_MAX_SEQUENCE_SIZE)){
+		if (Entry->SendPulseUser[Entry->ResultFailedPulse -1] == UserIndex){
+			if (PulseErrors != NULL){
+				*PulseErrors = Entry->SendPulseIndex[Entry->ResultFailedPulse -1] +1;
+			}
+		} else {
+			ReturnValue = true;
+		}
+	}
+	pthread_mutex_unlock(&(Entry->Lock));
+	return ReturnValue;
+}
+
+} // namespace
@@ -0,0 +1,58 @@
+/*
+ *      TU Berlin --- Fachgebiet Regelungssystem
+ *      C++ Interface class for the Hasomed GmbH device RehaMove3
+ *
+ *      Author: agent
+ *      Copyright © 2026 agent <agent@local>. All rights reserved.
+ *
+ *      File:           RehaMove3Registry.hpp -> Header file for the process wide registry of shared RehaMove3 devices.
+ *      Version:        01 (2026)
+ *      Changelog:
+ *      	- 10.2026: initial release
+ *
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ *      NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef REHAMOVE3REGISTRY_H
+#define REHAMOVE3REGISTRY_H
+
+#include "RehaMove3Interface_SMPT32X.hpp"
+
+#define REHAMOVE_REGISTRY_MAX_DEVICES						8
+#define REHAMOVE_REGISTRY_MAX_USERS							8
+#define REHAMOVE_REGISTRY_CHANNEL_FREE						0xFF	// owner of a channel, which is not used yet
+
+namespace nsRehaMove3_SMPT_32X_01 {
+
+/*
+ * Process wide registry of the devices -> several users (e.g. Simulink blocks) with the same device path share one device object,
+ * i.e. one interface, one receiver and one initialisation
+ *
+ * -> the device is created by the first user (IsFirstUser -> the user initialises the device) and the last user has to deinitialise
+ *    and delete it (rmRegistryReleaseDevice() returns true)
+ * -> the other users must use the same settings as the first user (protocol, frequency, limits, LowLevel and MidLevel config, debug
+ *    flags); otherwise the device is not acquired (NULL)
+ * -> the sequences of all users are merged into one sequence per period; the merged sequence is send when all users have posted
+ *    their pulses or when a user posts a second time (period overrun of another user)
+ * -> a channel belongs to the first user, which posts a pulse for it; the pulses of other users for this channel are rejected
+ * -> the devices are found by the real path of the interface; without a path by the serial number
+ */
+RehaMove3* rmRegistryAcquireDevice(const char *DeviceName, const char *DevicePath, const char *DeviceID, const RehaMove3::rmInitSettings_t *InitSettings,
+		uint8_t *UserIndex, bool *IsFirstUser);
+bool rmRegistryReleaseDevice(RehaMove3 *Device, uint8_t UserIndex);
+uint8_t rmRegistryGetNumberOfUsers(RehaMove3 *Device);
+
+bool rmRegistryPostLowLevelSequence(RehaMove3 *Device, uint8_t UserIndex, RehaMove3::LlSequenceConfig_t *SequenceConfig);
+bool rmRegistryPostCustomLowLevelSequence(RehaMove3 *Device, uint8_t UserIndex, RehaMove3::CustomLlSequenceConfig_t *CustomSequenceConfig);
+bool rmRegistryPostMidLevelUpdate(RehaMove3 *Device, uint8_t UserIndex, RehaMove3::MlUpdateConfig_t *UpdateConfig);
+bool rmRegistryGetLastLowLevelStimulationResult(RehaMove3 *Device, uint8_t UserIndex, double *PulseErrors);
+
+} // namespace
+
+#endif /* REHAMOVE3REGISTRY_H */
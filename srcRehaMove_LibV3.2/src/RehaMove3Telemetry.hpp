@@ -0,0 +1,141 @@
+/*
+ *      TU Berlin --- Fachgebiet Regelungssystem
+ *      C++ Interface class for the Hasomed GmbH device RehaMove3
+ *
+ *      Author: agent
+ *      Copyright © 2026 agent <agent@local>. All rights reserved.
+ *
+ *      File:           RehaMove3Telemetry.hpp -> Layout of the shared memory telemetry segment.
+ *      Version:        01 (2026)
+ *      Changelog:
+ *      	- 10.2026: initial release
+ *
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ *      NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef REHAMOVE3TELEMETRY_H
+#define REHAMOVE3TELEMETRY_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * The segment /dev/shm/<TelemetrySegmentName> is written by the telemetry threat of the RehaMove3 class and can
+ * be read by any number of monitor processes. The header does not depend on the SMPT library, so monitors can include it directly.
+ *
+ * -> one writer; the readers copy the segment and retry, if 'Sequence' was odd or did change during the copy (sequence lock)
+ * -> the layout only uses fixed size types; new fields are appended and 'Version' is increased
+ */
+#define REHAMOVE_TELEMETRY_MAGIC							0x54334D52	// "RM3T"
+#define REHAMOVE_TELEMETRY_VERSION							1
+#define REHAMOVE_TELEMETRY_NUMBER_OF_CHANNELS				4
+#define REHAMOVE_TELEMETRY_ID_SIZE							128		// >= size of RehaMove3::DeviceIDClass
+#define REHAMOVE_TELEMETRY_FILE_SIZE						256		// >= size of RehaMove3::DeviceFileName
+
+struct rmTelemetryChannel_t {
+	uint64_t PulsesSend;
+	uint64_t PulsesNotSend;
+	uint64_t PulsesSuccessful;
+	uint64_t PulsesFailed_StimError;
+	uint64_t UpdatesActive;
+};
+
+struct rmTelemetrySegment_t {
+	// header -> constant after the segment was created, except 'Sequence'
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t Size;
+	uint32_t Sequence;					// odd -> the writer is active
+	// update
+	uint64_t UpdateCounter;
+	uint64_t UpdateTime_us;				// time stamp of the last update (CLOCK_MONOTONIC)
+	int32_t  WriterPid;
+	uint32_t UpdatePeriod_us;
+	char	 DeviceID[REHAMOVE_TELEMETRY_ID_SIZE];
+	char	 DeviceFile[REHAMOVE_TELEMETRY_FILE_SIZE];
+	// status
+	uint8_t  Protocol;
+	uint8_t  DeviceIsOpen;
+	uint8_t  DeviceInitialised;
+	uint8_t  DeviceLlIsInitialised;
+	uint8_t  DeviceMlIsInitialised;
+	uint8_t  DoNotStimulate;
+	uint8_t  HybridSequenceOffloaded;
+	uint8_t  MlStimActive;
+	uint8_t  MlStimError;
+	uint8_t  BatteryLevel;
+	uint8_t  HighVoltageVoltage;
+	uint8_t  MainStatus;
+	uint8_t  StimStatus;
+	uint8_t  Reserved0;
+	uint16_t NumberOfStimErrors;
+	float	 BatteryVoltage;
+	uint32_t Reserved1;
+	// queue depths
+	uint32_t ResponseQueueDepth;
+	uint32_t LlSequenceQueueDepth;
+	uint32_t MlUpdateMailboxFull;
+	uint32_t Reserved2;
+	// acknowledgement latencies
+	uint64_t LlAckLatencyLast_us;
+	uint64_t LlAckLatencyMax_us;
+	uint64_t MlUpdateAckLatencyLast_us;
+	uint64_t KeepAliveAckLatency_us;	// smoothed
+	// statistics
+	uint64_t InvalidInput;
+	uint64_t InputCorrections_PulswidthOver;
+	uint64_t InputCorrections_PulswidthUnder;
+	uint64_t InputCorrections_CurrentOver;
+	uint64_t InputCorrections_CurrentUnder;
+	uint64_t SequencesSend;
+	uint64_t SequencesSuccessful;
+	uint64_t SequencesFailed;
+	uint64_t SequencesFailed_StimError;
+	uint64_t StimultionPulsesSend;
+	uint64_t StimultionPulsesNotSend;
+	uint64_t StimultionPulsesSuccessful;
+	uint64_t StimultionPulsesFailed;
+	uint64_t StimultionPulsesFailed_StimError;
+	uint64_t HybridSequencesOffloaded;
+	uint64_t HybridOffloads;
+	uint64_t HybridFallbacks;
+	uint64_t UpdatesSend;
+	uint64_t UpdatesFailed_StimError;
+	uint64_t UpdatesPosted;
+	uint64_t UpdatesTaken;
+	rmTelemetryChannel_t Channel[REHAMOVE_TELEMETRY_NUMBER_OF_CHANNELS];
+};
+
+/*
+ * Reader helper for the monitor processes
+ * -> returns false, if the segment is not valid (yet) or the writer did not finish an update within MaxRetries
+ */
+static inline bool rmTelemetryRead(const rmTelemetrySegment_t *Segment, rmTelemetrySegment_t *Copy, uint32_t MaxRetries)
+{
+	if ((Segment == NULL) || (Copy == NULL)){
+		return false;
+	}
+	if ((__atomic_load_n(&Segment->Magic, __ATOMIC_ACQUIRE) != REHAMOVE_TELEMETRY_MAGIC) || (Segment->Version != REHAMOVE_TELEMETRY_VERSION)){
+		return false;
+	}
+	for (uint32_t i = 0; i < MaxRetries; i++){
+		uint32_t Start = __atomic_load_n(&Segment->Sequence, __ATOMIC_ACQUIRE);
+		if (Start & 1){
+			continue;
+		}
+		memcpy(Copy, Segment, sizeof(rmTelemetrySegment_t));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&Segment->Sequence, __ATOMIC_RELAXED) == Start){
+			return true;
+		}
+	}
+	return false;
+}
+
+#endif /* REHAMOVE3TELEMETRY_H */
@@ -0,0 +1,206 @@
+/*
+ *      TU Berlin --- Fachgebiet Regelungssystem
+ *      C++ Interface class for the Hasomed GmbH device RehaMove3
+ *
+ *      Author: agent
+ *      Copyright © 2026 agent <agent@local>. All rights reserved.
+ *
+ *      File:           RehaMove3Trace.cpp -> Trace ring buffers; only compiled with REHAMOVE_ENABLE_TRACE.
+ *      Version:        01 (2026)
+ *      Changelog:
+ *      	- 10.2026: initial release
+ *
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ *      NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "RehaMove3Trace.hpp"
+
+#ifdef REHAMOVE_ENABLE_TRACE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+struct rmTraceRing_t {
+	rmTraceEvent_t 	Events[REHAMOVE_TRACE_RING_SIZE];
+	uint64_t		Head;		// written by the owning thread only
+	uint32_t		ThreadID;
+	uint32_t		InUse;		// 1 -> owned by a running thread; 0 -> the thread ended, the ring can be taken by a new thread
+};
+
+static rmTraceRing_t*	rmTraceRings[REHAMOVE_TRACE_MAX_THREADS];
+static uint32_t			rmTraceNumberOfRings = 0;
+static __thread rmTraceRing_t*	rmTraceLocalRing = NULL;
+static __thread bool			rmTraceLocalRingFailed = false;
+static bool						rmTraceLockRings = false;
+static bool						rmTraceExhaustedReported = false;
+static pthread_key_t			rmTraceRingKey;
+static pthread_once_t			rmTraceRingKeyOnce = PTHREAD_ONCE_INIT;
+
+static void rmTraceReleaseRing(void *Ring)
+{
+	// called when the owning thread ends -> the events stay available for rmTraceDump() until the ring is taken by a new thread
+	__atomic_store_n(&((rmTraceRing_t *)Ring)->InUse, 0, __ATOMIC_RELEASE);
+}
+
+static void rmTraceCreateRingKey(void)
+{
+	pthread_key_create(&rmTraceRingKey, rmTraceReleaseRing);
+}
+
+static rmTraceRing_t* rmTraceReuseRing(void)
+{
+	// all slots are allocated -> take the ring of an ended thread; its events are overwritten
+	for (uint32_t i = 0; i < REHAMOVE_TRACE_MAX_THREADS; i++){
+		rmTraceRing_t *Ring = __atomic_load_n(&rmTraceRings[i], __ATOMIC_ACQUIRE);
+		uint32_t Free = 0;
+		if ((Ring != NULL) && __atomic_compare_exchange_n(&Ring->InUse, &Free, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)){
+			__atomic_store_n(&Ring->Head, 0, __ATOMIC_RELEASE);
+			return Ring;
+		}
+	}
+	return NULL;
+}
+
+static rmTraceRing_t* rmTraceRegisterThread(void)
+{
+	/*
+	 * the ring is allocated with the first event of a thread and released, when the thread ends
+	 * -> the events are still available after the thread ended; the ring is only reused, if all slots are allocated
+	 */
+	pthread_once(&rmTraceRingKeyOnce, rmTraceCreateRingKey);
+	rmTraceRing_t *Ring = NULL;
+	uint32_t Slot = __atomic_load_n(&rmTraceNumberOfRings, __ATOMIC_ACQUIRE);
+	while (Slot < REHAMOVE_TRACE_MAX_THREADS){
+		if (__atomic_compare_exchange_n(&rmTraceNumberOfRings, &Slot, Slot +1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)){
+			Ring = (rmTraceRing_t *)calloc(1, sizeof(rmTraceRing_t));
+			if (Ring == NULL){
+				rmTraceLocalRingFailed = true;
+				return NULL;
+			}
+			if (__atomic_load_n(&rmTraceLockRings, __ATOMIC_ACQUIRE)){
+				mlock(Ring, sizeof(rmTraceRing_t));
+			}
+			Ring->InUse = 1;
+			Ring->ThreadID = (uint32_t)syscall(SYS_gettid);
+			__atomic_store_n(&rmTraceRings[Slot], Ring, __ATOMIC_RELEASE);
+			break;
+		}
+	}
+	if (Ring == NULL){
+		Ring = rmTraceReuseRing();
+		if (Ring == NULL){
+			rmTraceLocalRingFailed = true;
+			if (!__atomic_exchange_n(&rmTraceExhaustedReported, true, __ATOMIC_ACQ_REL)){
+				fprintf(stderr, "RehaMove3 Trace Warning: All %u trace rings are used by running threads -> the events of further threads are not recorded!\n", (unsigned int)REHAMOVE_TRACE_MAX_THREADS);
+			}
+			return NULL;
+		}
+		Ring->ThreadID = (uint32_t)syscall(SYS_gettid);
+	}
+	pthread_setspecific(rmTraceRingKey, Ring);
+	rmTraceLocalRing = Ring;
+	return Ring;
+}
+
+void rmTraceRecord(uint16_t EventID, uint8_t Phase, uint32_t Arg)
+{
+	rmTraceRing_t *Ring = rmTraceLocalRing;
+	if (Ring == NULL){
+		if (rmTraceLocalRingFailed){
+			return;
+		}
+		Ring = rmTraceRegisterThread();
+		if (Ring == NULL){
+			return;
+		}
+	}
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+
+	uint64_t Head = Ring->Head;
+	rmTraceEvent_t *Event = &Ring->Events[Head & (REHAMOVE_TRACE_RING_SIZE -1)];
+	Event->Time_ns = ((uint64_t)Time.tv_sec *1000000000) + (uint64_t)Time.tv_nsec;
+	Event->Arg 	   = Arg;
+	Event->EventID = EventID;
+	Event->Phase   = Phase;
+	__atomic_store_n(&Ring->Head, Head +1, __ATOMIC_RELEASE);
+}
+
+void rmTraceLockMemory(void)
+{
+	// lock the existing rings and all rings allocated later; the rings are reused but never freed, so they are not unlocked
+	__atomic_store_n(&rmTraceLockRings, true, __ATOMIC_RELEASE);
+	uint32_t NumberOfRings = __atomic_load_n(&rmTraceNumberOfRings, __ATOMIC_ACQUIRE);
+	NumberOfRings = (NumberOfRings > REHAMOVE_TRACE_MAX_THREADS) ? REHAMOVE_TRACE_MAX_THREADS : NumberOfRings;
+	for (uint32_t i = 0; i < NumberOfRings; i++){
+		rmTraceRing_t *Ring = __atomic_load_n(&rmTraceRings[i], __ATOMIC_ACQUIRE);
+		if (Ring != NULL){
+			mlock(Ring, sizeof(rmTraceRing_t));
+		}
+	}
+}
+
+bool rmTraceDump(const char *FileName)
+{
+	/*
+	 * Write all rings to a binary file
+	 * -> call this function when the stimulation is stopped; events written during the dump might be inconsistent
+	 */
+	if ((FileName == NULL) || (FileName[0] == 0)){
+		return false;
+	}
+	FILE *File = fopen(FileName, "wb");
+	if (File == NULL){
+		return false;
+	}
+	uint32_t NumberOfRings = __atomic_load_n(&rmTraceNumberOfRings, __ATOMIC_ACQUIRE);
+	NumberOfRings = (NumberOfRings > REHAMOVE_TRACE_MAX_THREADS) ? REHAMOVE_TRACE_MAX_THREADS : NumberOfRings;
+	rmTraceRing_t *Rings[REHAMOVE_TRACE_MAX_THREADS];
+	uint32_t NumberOfThreads = 0;
+	for (uint32_t i = 0; i < NumberOfRings; i++){
+		// the ring might not be allocated yet
+		Rings[NumberOfThreads] = __atomic_load_n(&rmTraceRings[i], __ATOMIC_ACQUIRE);
+		if (Rings[NumberOfThreads] != NULL){
+			NumberOfThreads++;
+		}
+	}
+
+	rmTraceFileHeader_t FileHeader = {};
+	FileHeader.Magic 		   = REHAMOVE_TRACE_MAGIC;
+	FileHeader.Version 		   = REHAMOVE_TRACE_VERSION;
+	FileHeader.NumberOfThreads = NumberOfThreads;
+	FileHeader.EventSize 	   = sizeof(rmTraceEvent_t);
+	bool ReturnValue = (fwrite(&FileHeader, sizeof(FileHeader), 1, File) == 1);
+
+	for (uint32_t i = 0; (i < NumberOfThreads) && ReturnValue; i++){
+		uint64_t Head = __atomic_load_n(&Rings[i]->Head, __ATOMIC_ACQUIRE);
+		uint64_t NumberOfEvents = (Head > REHAMOVE_TRACE_RING_SIZE) ? REHAMOVE_TRACE_RING_SIZE : Head;
+		rmTraceThreadHeader_t ThreadHeader = {};
+		ThreadHeader.ThreadID 		   = Rings[i]->ThreadID;
+		ThreadHeader.NumberOfEvents    = (uint32_t)NumberOfEvents;
+		ThreadHeader.EventsOverwritten = Head - NumberOfEvents;
+		ReturnValue = (fwrite(&ThreadHeader, sizeof(ThreadHeader), 1, File) == 1);
+		// oldest event first
+		for (uint64_t iEvent = Head - NumberOfEvents; (iEvent < Head) && ReturnValue; iEvent++){
+			ReturnValue = (fwrite(&Rings[i]->Events[iEvent & (REHAMOVE_TRACE_RING_SIZE -1)], sizeof(rmTraceEvent_t), 1, File) == 1);
+		}
+	}
+
+	if (fclose(File) != 0){
+		ReturnValue = false;
+	}
+	return ReturnValue;
+}
+
+#endif /* REHAMOVE_ENABLE_TRACE */
@@ -0,0 +1,134 @@
+/*
+ *      TU Berlin --- Fachgebiet Regelungssystem
+ *      C++ Interface class for the Hasomed GmbH device RehaMove3
+ *
+ *      Author: agent
+ *      Copyright © 2026 agent <agent@local>. All rights reserved.
+ *
+ *      File:           RehaMove3Trace.hpp -> Trace points for the send/ack path of the interface class.
+ *      Version:        01 (2026)
+ *      Changelog:
+ *      	- 10.2026: initial release
+ *
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ *      NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef REHAMOVE3TRACE_H
+#define REHAMOVE3TRACE_H
+
+#include <stdint.h>
+
+/*
+ * The trace points are only compiled, if REHAMOVE_ENABLE_TRACE is defined (e.g. -DREHAMOVE_ENABLE_TRACE);
+ * otherwise the macros below expand to nothing.
+ *
+ * -> every thread writes into its own ring buffer (one writer, no locks); the oldest events are overwritten
+ * -> the ring of an ended thread is kept for the dump and only reused, when all REHAMOVE_TRACE_MAX_THREADS rings are allocated
+ * -> the time stamps are taken from CLOCK_MONOTONIC in ns
+ * -> rmTraceDump() writes the rings as binary file; developmentProgram/RehaMove3TraceDump.cpp converts it into the Chrome trace format (JSON)
+ */
+#define REHAMOVE_TRACE_MAGIC								0x52334D52	// "RM3R"
+#define REHAMOVE_TRACE_VERSION								1
+#define REHAMOVE_TRACE_MAX_THREADS							32
+#define REHAMOVE_TRACE_RING_SIZE							16384		// events per thread; must be a power of 2
+
+enum rmTraceEventID_t {
+	rmTrace_LlSequence 			= 0,	// SendNewPreDefinedLowLevelSequence;	arg: number of pulses
+	rmTrace_LlPulseSend 		= 1,	// channel config send;					arg: packet number
+	rmTrace_MlUpdate 			= 2,	// SendMidLevelUpdate
+	rmTrace_MlUpdateSend 		= 3,	// ml update send;						arg: packet number
+	rmTrace_AckReceived 		= 4,	// ReadAcks;							arg: command number
+	rmTrace_PutResponse 		= 5,	// PutResponse;							arg: command number
+	rmTrace_GetResponse 		= 6,	// GetResponse;							arg: expected command
+	rmTrace_PutLlChannelResponse = 7,	// PutLLChannelResponse;				arg: packet number
+	rmTrace_LockSendPackage 	= 8,	// waiting for the lock
+	rmTrace_LockResponseQueue 	= 9,	// waiting for the lock
+	rmTrace_LockLlSequenceQueue = 10,	// waiting for the lock
+	rmTrace_NumberOfEvents
+};
+
+static const char* const rmTraceEventNames[rmTrace_NumberOfEvents] = {
+	"LlSequence",
+	"LlPulseSend",
+	"MlUpdate",
+	"MlUpdateSend",
+	"AckReceived",
+	"PutResponse",
+	"GetResponse",
+	"PutLlChannelResponse",
+	"LockSendPackage",
+	"LockResponseQueue",
+	"LockLlSequenceQueue"
+};
+
+enum rmTracePhase_t {
+	rmTracePhase_Begin 	 = 'B',
+	rmTracePhase_End 	 = 'E',
+	rmTracePhase_Instant = 'i'
+};
+
+struct rmTraceEvent_t {
+	uint64_t Time_ns;
+	uint32_t Arg;
+	uint16_t EventID;
+	uint8_t	 Phase;
+	uint8_t  Reserved;
+};
+
+// trace file: rmTraceFileHeader_t, followed by NumberOfThreads x (rmTraceThreadHeader_t + NumberOfEvents x rmTraceEvent_t)
+struct rmTraceFileHeader_t {
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t NumberOfThreads;
+	uint32_t EventSize;
+};
+struct rmTraceThreadHeader_t {
+	uint32_t ThreadID;
+	uint32_t NumberOfEvents;
+	uint64_t EventsOverwritten;
+};
+
+
+#ifdef REHAMOVE_ENABLE_TRACE
+
+void rmTraceRecord(uint16_t EventID, uint8_t Phase, uint32_t Arg);
+bool rmTraceDump(const char *FileName);
+void rmTraceLockMemory(void);
+
+// begin/end pair for functions with more than one return
+class rmTraceScope {
+public:
+	rmTraceScope(uint16_t Event, uint32_t Arg) : EventID(Event) { rmTraceRecord(Event, rmTracePhase_Begin, Arg); }
+	~rmTraceScope(void) { rmTraceRecord(this->EventID, rmTracePhase_End, 0); }
+private:
+	uint16_t EventID;
+};
+
+#define RM3_TRACE_BEGIN(EventID, Arg)			rmTraceRecord((EventID), rmTracePhase_Begin, (uint32_t)(Arg))
+#define RM3_TRACE_END(EventID, Arg)				rmTraceRecord((EventID), rmTracePhase_End, (uint32_t)(Arg))
+#define RM3_TRACE_INSTANT(EventID, Arg)			rmTraceRecord((EventID), rmTracePhase_Instant, (uint32_t)(Arg))
+#define RM3_TRACE_SCOPE(EventID, Arg)			rmTraceScope rmTraceScopeLocal((EventID), (uint32_t)(Arg))
+#define RM3_TRACE_DUMP(FileName)				rmTraceDump(FileName)
+#define RM3_TRACE_LOCK_MEMORY()					rmTraceLockMemory()
+
+#else
+
+#define RM3_TRACE_BEGIN(EventID, Arg)			do {} while (0)
+#define RM3_TRACE_END(EventID, Arg)				do {} while (0)
+#define RM3_TRACE_INSTANT(EventID, Arg)			do {} while (0)
+#define RM3_TRACE_SCOPE(EventID, Arg)			do {} while (0)
+#define RM3_TRACE_DUMP(FileName)				do {} while (0)
+#define RM3_TRACE_LOCK_MEMORY()					do {} while (0)
+
+#endif /* REHAMOVE_ENABLE_TRACE */
+
+// the time needed to get the lock is traced as begin/end pair
+#define RM3_TRACE_MUTEX_LOCK(EventID, Mutex)	do { RM3_TRACE_BEGIN(EventID, 0); pthread_mutex_lock(Mutex); RM3_TRACE_END(EventID, 0); } while (0)
+
+#endif /* REHAMOVE3TRACE_H */
@@ -52,7 +52,8 @@ void lctRM3_Initialise(  void **work1, uint16_t stimOptions[], uint16_t sizeStim
 		bRehaMove3->TransverLlOptions(llOptions, sizeLlOptions);
 		break;
 	case RM3_MID_LEVEL_STIMULATION_PROTOCOL:
-		// MidLevel options
+		// MidLevel options; the pulse forms are taken from the LowLevel options
+		bRehaMove3->TransverLlOptions(llOptions, sizeLlOptions);
 		bRehaMove3->TransverMlOptions(mlOptions, sizeMlOptions);
 		break;
 	default:
@@ -72,46 +73,99 @@ void lctRM3_Initialise(  void **work1, uint16_t stimOptions[], uint16_t sizeStim
 	}
 
 #ifdef WITH_HW
-	// Create Device Class
-	bRehaMove3->Device = new nsRehaMove3_SMPT_32X_01::RehaMove3(bRehaMove3->stimOptions.blockID, bRehaMove3->stimOptions.devicePath);
-	if (!bRehaMove3->rmStatus.deviceInitialisationAborted){
-		// initialise the RehaMove Pro system
-		if (bRehaMove3->Device->InitialiseRehaMove3(&bRehaMove3->rmInitSettings, &bRehaMove3->rmResult)) {
+	// Create the Device Classes -> several devices share one manager, which reads the acknowledgements of all devices
+	if (bRehaMove3->stimOptions.numberOfDevices > 1){
+		bRehaMove3->Manager = new nsRehaMove3_SMPT_32X_01::RehaMove3Manager((int)bRehaMove3->stimOptions.threadSchedPolicy, (int)bRehaMove3->stimOptions.threadSchedPriority,
+				(uint64_t)bRehaMove3->stimOptions.threadCpuAffinity);
+		bRehaMove3->Manager->SetSamplePeriod(bRehaMove3->sampleTime);
+	}
+	bool isFirstUser = true;
+	for (uint8_t iDevice = 0; iDevice < bRehaMove3->stimOptions.numberOfDevices; iDevice++){
+		char deviceName[RM3_STRING_SIZE_MAX +10];
+		if (bRehaMove3->stimOptions.numberOfDevices > 1){
+			snprintf(deviceName, sizeof(deviceName), "%s[%u]", bRehaMove3->stimOptions.blockID, iDevice +1);
+			bRehaMove3->Devices[iDevice] = new nsRehaMove3_SMPT_32X_01::RehaMove3(deviceName, bRehaMove3->stimOptions.devicePaths[iDevice]);
+			if (!bRehaMove3->Manager->AddDevice(bRehaMove3->Devices[iDevice])){
+				printf("%s Error: The device %u could not be added to the manager! -> Initialisation aborted!\n\n", bRehaMove3->stimOptions.blockID, iDevice +1);
+				bRehaMove3->rmStatus.deviceInitialisationAborted = true;
+			}
+		} else {
+			// one device -> blocks with the same device share it; the first block initialises it with its settings
+			snprintf(deviceName, sizeof(deviceName), "%s", bRehaMove3->stimOptions.blockID);
+			bRehaMove3->Devices[iDevice] = rmRegistryAcquireDevice(deviceName, bRehaMove3->stimOptions.devicePaths[iDevice], bRehaMove3->stimOptions.deviceIDs[iDevice],
+					&bRehaMove3->rmInitSettings, &bRehaMove3->registryUser, &isFirstUser);
+			// an aborted block does not use the device -> release it, so it is not registered without being initialised
+			if (bRehaMove3->rmStatus.deviceInitialisationAborted && (bRehaMove3->Devices[iDevice] != NULL)){
+				if (rmRegistryReleaseDevice(bRehaMove3->Devices[iDevice], bRehaMove3->registryUser)){
+					delete bRehaMove3->Devices[iDevice];
+				}
+				bRehaMove3->Devices[iDevice] = NULL;
+			}
+		}
+	}
+	bRehaMove3->Device = bRehaMove3->Devices[0];
+	if (bRehaMove3->rmStatus.deviceInitialisationAborted){
+		// nothing to initialise
+	} else if (bRehaMove3->Device == NULL){
+		printf("%s Error: The device could not be created! -> Initialisation aborted!\n\n", bRehaMove3->stimOptions.blockID);
+		bRehaMove3->rmStatus.deviceInitialisationAborted = true;
+	} else if (!isFirstUser && !bRehaMove3->rmStatus.deviceInitialisationAborted){
+		// the device is initialised (or initialising) by another block
+		if (bRehaMove3->miscOptions.debugPrintBlockParameter){
+			printf("%s Block Debug: The device is shared with %u other block(s)\n", bRehaMove3->stimOptions.blockID, rmRegistryGetNumberOfUsers(bRehaMove3->Device) -1);
+		}
+		bRehaMove3->rmStatus.deviceIsInitialised = bRehaMove3->Device->IsDeviceInitialised(&bRehaMove3->rmResult[0]);
+		bRehaMove3->rmStatus.stimStatus1 = bRehaMove3->rmStatus.deviceIsInitialised ? 1 : (double)block_RehaMove3::blockError_notInitialised;
+	} else if (!bRehaMove3->rmStatus.deviceInitialisationAborted){
+		// initialise the RehaMove Pro systems
+		bool allDevicesInitialised = true;
+		for (uint8_t iDevice = 0; iDevice < bRehaMove3->stimOptions.numberOfDevices; iDevice++){
+			// the serial number is checked per device
+			bRehaMove3->rmInitSettings.checkDeviceIDs = (strlen(bRehaMove3->stimOptions.deviceIDs[iDevice]) == Smpt_Length_Device_Id);
+			memset(bRehaMove3->rmInitSettings.RequestedDeviceID, 0, sizeof(bRehaMove3->rmInitSettings.RequestedDeviceID));
+			if (bRehaMove3->rmInitSettings.checkDeviceIDs){
+				memcpy(bRehaMove3->rmInitSettings.RequestedDeviceID, bRehaMove3->stimOptions.deviceIDs[iDevice], Smpt_Length_Device_Id);
+			}
+			if (!bRehaMove3->Devices[iDevice]->InitialiseRehaMove3(&bRehaMove3->rmInitSettings, &bRehaMove3->rmResult[iDevice])) {
+				allDevicesInitialised = false;
+			}
+		}
+		if (allDevicesInitialised) {
 			// the initialisation was successful
 			bRehaMove3->rmStatus.deviceIsInitialised = true;
 			bRehaMove3->rmStatus.stimStatus1 = 1;
 		} else {
 			// the initialisation failed
-			if (bRehaMove3->rmResult.finished){
-				printf("%s Error: Initialisation failed!\n\n", bRehaMove3->stimOptions.blockID);
+			for (uint8_t iDevice = 0; iDevice < bRehaMove3->stimOptions.numberOfDevices; iDevice++){
+				if (bRehaMove3->rmResult[iDevice].finished){
+					printf("%s Error: Initialisation failed!\n\n", bRehaMove3->stimOptions.blockID);
+					break;
+				}
 			}
 			bRehaMove3->rmStatus.deviceIsInitialised = false;
 			bRehaMove3->rmStatus.stimStatus1 = (double)block_RehaMove3::blockError_notInitialised;
 			// take care of specific errors
-			switch(bRehaMove3->rmResult.errorCode){
-			case actionError_openingDevice:
-				bRehaMove3->rmStatus.deviceOpeningFailed = true;
-				bRehaMove3->rmStatus.stimStatus1 = (double)block_RehaMove3::blockError_openingDevice;
-				break;
-			case actionError_checkDeviceIDs:
-				bRehaMove3->rmStatus.deviceIDsDidNotMatch = true;
-				bRehaMove3->rmStatus.stimStatus1 = (double)block_RehaMove3::blockError_checkDeviceIDs;
-				break;
-			default:;
+			for (uint8_t iDevice = 0; iDevice < bRehaMove3->stimOptions.numberOfDevices; iDevice++){
+				bRehaMove3->SetInitialisationError(&bRehaMove3->rmResult[iDevice]);
 			}
 		}
 	}
 #endif
 
+	// async mode -> the sequences are build and send by a worker threat
+	if (bRehaMove3->stimOptions.asyncMode && !bRehaMove3->rmStatus.deviceInitialisationAborted){
+		bRehaMove3->StartAsyncWorker();
+	}
+
 	if (bRehaMove3->miscOptions.debugPrintBlockParameter){
 		printf("\n#############################################\nDEBUG OUTPUT for RehaMove3 Init -> STOP\n\n");
 	}
 }
 
 
-void lctRM3_InputOutput( void **work1, double u1[], double u2[], double y1[])
+static void lctRM3_ProcessInputs( block_RehaMove3 *bRehaMove3, double u1[], double u2[], double y1[])
 {
-	block_RehaMove3 *bRehaMove3 = (block_RehaMove3*) *work1;
+	// read the results, build and send the new sequence -> called by the step or by the worker threat (async mode)
 	double *pwIn		= u1;
 	double *currentIn 	= u2;
 
@@ -123,6 +177,12 @@ void lctRM3_InputOutput( void **work1, double u1[], double u2[], double y1[])
 
 #ifdef WITH_HW
 	if (bRehaMove3->rmStatus.deviceIsInitialised){
+		// the connection to the device was lost -> the device is opened and initialised again in the background
+		if (bRehaMove3->IsReconnecting()){
+			y1[0] = (double)block_RehaMove3::blockError_reconnecting;
+			y1[1] = 0.0;
+			return;
+		}
 		/*
 		 * Read the responses
 		 */
@@ -132,10 +192,18 @@ void lctRM3_InputOutput( void **work1, double u1[], double u2[], double y1[])
 		switch(bRehaMove3->stimOptions.rmProtocol){
 		case RM3_LOW_LEVEL_STIMULATION_PROTOCOL1:
 		case RM3_LOW_LEVEL_STIMULATION_PROTOCOL2:
-			LastStimulationSuccessful = bRehaMove3->Device->GetLastLowLevelStimulationResult(&PulseErrors, bRehaMove3->LlSequenceID);
+			if (bRehaMove3->Manager != NULL){
+				LastStimulationSuccessful = bRehaMove3->Manager->GetLastLowLevelStimulationResult(&PulseErrors);
+			} else {
+				LastStimulationSuccessful = rmRegistryGetLastLowLevelStimulationResult(bRehaMove3->Device, bRehaMove3->registryUser, &PulseErrors);
+			}
 			break;
 		case RM3_MID_LEVEL_STIMULATION_PROTOCOL:
-			LastStimulationSuccessful = bRehaMove3->Device->GetLastMidLevelStimulationResult(&PulseErrors);
+			if (bRehaMove3->Manager != NULL){
+				LastStimulationSuccessful = bRehaMove3->Manager->GetLastMidLevelStimulationResult(&PulseErrors);
+			} else {
+				LastStimulationSuccessful = bRehaMove3->Device->GetLastMidLevelStimulationResult(&PulseErrors);
+			}
 			break;
 		}
 
@@ -172,8 +240,13 @@ void lctRM3_InputOutput( void **work1, double u1[], double u2[], double y1[])
 			}
 			bRehaMove3->LlSequenceConfig.NumberOfPulses = j;
 
-			// send the new sequence
-			bRehaMove3->Device->SendNewPreDefinedLowLevelSequence(&bRehaMove3->LlSequenceConfig, &bRehaMove3->LlSequenceID);
+			// send the new sequence -> with several devices the sequence is split by the channels and send synchronised
+			if (bRehaMove3->Manager != NULL){
+				bRehaMove3->Manager->SendNewPreDefinedLowLevelSequence(&bRehaMove3->LlSequenceConfig, NULL);
+			} else {
+				// merged with the sequences of the other blocks using this device
+				rmRegistryPostLowLevelSequence(bRehaMove3->Device, bRehaMove3->registryUser, &bRehaMove3->LlSequenceConfig);
+			}
 			break;}
 
 		case RM3_LOW_LEVEL_STIMULATION_PROTOCOL2:{
@@ -206,39 +279,55 @@ void lctRM3_InputOutput( void **work1, double u1[], double u2[], double y1[])
 			bRehaMove3->LlCustomSequenceConfig.NumberOfPulses = j;
 
 			// send the new sequence
-			bRehaMove3->Device->SendNewCustomLowLevelSequence(&bRehaMove3->LlCustomSequenceConfig, &bRehaMove3->LlSequenceID);
+			if (bRehaMove3->Manager != NULL){
+				bRehaMove3->Manager->SendNewCustomLowLevelSequence(&bRehaMove3->LlCustomSequenceConfig);
+			} else {
+				rmRegistryPostCustomLowLevelSequence(bRehaMove3->Device, bRehaMove3->registryUser, &bRehaMove3->LlCustomSequenceConfig);
+			}
 			break;}
 
 		case RM3_MID_LEVEL_STIMULATION_PROTOCOL:{
-			// MidLevel stimulation
-			memset(&bRehaMove3->MlUpdateConfig, 0, sizeof(RehaMove3::MlUpdateConfig_t));
+			// MidLevel stimulation -> one update per device; the channels 5-8 are the channels 1-4 of the second device, ...
+			memset(&bRehaMove3->MlUpdateConfig, 0, sizeof(bRehaMove3->MlUpdateConfig));
 
 			int8_t iCh = 0;
+			uint8_t iDevice = 0;
 			for (uint8_t i=0; i < bRehaMove3->stimOptions.numberOfActiveChannels; i++){
 				iCh = bRehaMove3->stimOptions.channelsActive[i] -1;
-				if (iCh >= 0 && iCh < REHAMOVE_NUMBER_OF_CHANNELS){
+				if (iCh >= 0 && iCh < REHAMOVE_NUMBER_OF_CHANNELS *bRehaMove3->stimOptions.numberOfDevices){
+					iDevice = iCh /REHAMOVE_NUMBER_OF_CHANNELS;
+					iCh = iCh %REHAMOVE_NUMBER_OF_CHANNELS;
+					RehaMove3::MlUpdateConfig_t *MlUpdateConfig = &bRehaMove3->MlUpdateConfig[iDevice];
 					// check that the pulse width is not 0; the current can be 0
 					if (pwIn[i] != 0.0){
 						// build stimulation configuration
-						bRehaMove3->MlUpdateConfig.ForceUpdate = false;
-						bRehaMove3->MlUpdateConfig.RedoRamp = false;
-						bRehaMove3->MlUpdateConfig.ActiveChannels[iCh] = true;
-						bRehaMove3->MlUpdateConfig.PulseConfig[iCh].Channel = iCh;
-						bRehaMove3->MlUpdateConfig.PulseConfig[iCh].Shape = Shape_Balanced_Symetric_Biphasic;
+						MlUpdateConfig->ForceUpdate = false;
+						MlUpdateConfig->RedoRamp = false;
+						MlUpdateConfig->ActiveChannels[iCh] = true;
+						MlUpdateConfig->PulseConfig[iCh].Channel = iCh;
+						MlUpdateConfig->PulseConfig[iCh].Shape = bRehaMove3->llOptions.channelsPulseForm[i];
 						if (bRehaMove3->rmInitSettings.MidLevelConfig.UseDynamicStimulationFrequncy){
-							bRehaMove3->MlUpdateConfig.PulseConfig[iCh].Frequency =  (uint16_t)pwIn[i*2+0];
-							bRehaMove3->MlUpdateConfig.PulseConfig[iCh].PulseWidth = (uint16_t)pwIn[i*2+1];
+							MlUpdateConfig->PulseConfig[iCh].Frequency =  (uint16_t)pwIn[i*2+0];
+							MlUpdateConfig->PulseConfig[iCh].PulseWidth = (uint16_t)pwIn[i*2+1];
 						} else {
-							bRehaMove3->MlUpdateConfig.PulseConfig[iCh].Frequency = (float)bRehaMove3->rmInitSettings.MidLevelConfig.GeneralStimFrequency;
-							bRehaMove3->MlUpdateConfig.PulseConfig[iCh].PulseWidth = (uint16_t)pwIn[i];
+							MlUpdateConfig->PulseConfig[iCh].Frequency = (float)bRehaMove3->rmInitSettings.MidLevelConfig.GeneralStimFrequency;
+							MlUpdateConfig->PulseConfig[iCh].PulseWidth = (uint16_t)pwIn[i];
 						}
-						bRehaMove3->MlUpdateConfig.PulseConfig[iCh].Current = (float)currentIn[i];
+						MlUpdateConfig->PulseConfig[iCh].Current = (float)currentIn[i];
 					}
 				}
 			}
 
-			// send the update
-			bRehaMove3->Device->SendMidLevelUpdate(&bRehaMove3->MlUpdateConfig);
+			// send the update(s)
+			if (bRehaMove3->Manager != NULL){
+				RehaMove3::MlUpdateConfig_t *MlUpdateConfigs[RM3_N_DEVICES_MAX];
+				for (iDevice = 0; iDevice < bRehaMove3->stimOptions.numberOfDevices; iDevice++){
+					MlUpdateConfigs[iDevice] = &bRehaMove3->MlUpdateConfig[iDevice];
+				}
+				bRehaMove3->Manager->SendMidLevelUpdates(MlUpdateConfigs);
+			} else {
+				rmRegistryPostMidLevelUpdate(bRehaMove3->Device, bRehaMove3->registryUser, &bRehaMove3->MlUpdateConfig[0]);
+			}
 			break;}
 
 		default:
@@ -255,13 +344,20 @@ void lctRM3_InputOutput( void **work1, double u1[], double u2[], double y1[])
 
 	} else {
 		// the device is not initialised -> check if it is initialised now
-		if (bRehaMove3->Device->IsDeviceInitialised(&bRehaMove3->rmResult)) {
+		bool allDevicesInitialised = true, initialisationFinished = false;
+		for (uint8_t iDevice = 0; iDevice < bRehaMove3->stimOptions.numberOfDevices; iDevice++){
+			if (!bRehaMove3->Devices[iDevice]->IsDeviceInitialised(&bRehaMove3->rmResult[iDevice])){
+				allDevicesInitialised = false;
+				initialisationFinished |= bRehaMove3->rmResult[iDevice].finished;
+			}
+		}
+		if (allDevicesInitialised) {
 			// the initialisation was successful
 			bRehaMove3->rmStatus.deviceIsInitialised = true;
 			bRehaMove3->rmStatus.stimStatus1 = (double)block_RehaMove3::blockReturn_initialisationSuccessful_noErrors;
 		} else {
 			// the initialisation failed
-			if (bRehaMove3->rmResult.finished && (bRehaMove3->rmStatus.outputCounter  >= bRehaMove3->rmStatus.outputCounterNext)){
+			if (initialisationFinished && (bRehaMove3->rmStatus.outputCounter  >= bRehaMove3->rmStatus.outputCounterNext)){
 				printf("%s Error: Initialisation failed!\n\n", bRehaMove3->stimOptions.blockID);
 				bRehaMove3->rmStatus.outputCounter = 0;
 				bRehaMove3->rmStatus.outputCounterNext = (bRehaMove3->rmStatus.outputCounterNext +1) *2;
@@ -271,23 +367,38 @@ void lctRM3_InputOutput( void **work1, double u1[], double u2[], double y1[])
 			bRehaMove3->rmStatus.deviceIsInitialised = false;
 			bRehaMove3->rmStatus.stimStatus1 = (double)block_RehaMove3::blockError_notInitialised;
 			// take care of specific errors
-			switch(bRehaMove3->rmResult.errorCode){
-			case actionError_openingDevice:
-				bRehaMove3->rmStatus.deviceOpeningFailed = true;
-				bRehaMove3->rmStatus.stimStatus1 = (double)block_RehaMove3::blockError_openingDevice;
-				break;
-			case actionError_checkDeviceIDs:
-				bRehaMove3->rmStatus.deviceIDsDidNotMatch = true;
-				bRehaMove3->rmStatus.stimStatus1 = (double)block_RehaMove3::blockError_checkDeviceIDs;
-				break;
-			default:;
+			for (uint8_t iDevice = 0; iDevice < bRehaMove3->stimOptions.numberOfDevices; iDevice++){
+				bRehaMove3->SetInitialisationError(&bRehaMove3->rmResult[iDevice]);
 			}
 		}
 		y1[0] = (double)block_RehaMove3::blockError_notInitialised; // stimulator is NOT initialised
 		y1[1] = 0;
 	}
 #endif
+}
 
+void lctRM3_InputOutput( void **work1, double u1[], double u2[], double y1[])
+{
+	block_RehaMove3 *bRehaMove3 = (block_RehaMove3*) *work1;
+	bRehaMove3->StepTimingStart();
+
+	if (bRehaMove3->async.workerActive.Load()){
+		// async mode -> only post the inputs and return the latest status; the worker threat does the rest
+		bRehaMove3->PostAsyncInputs(u1, u2);
+		bRehaMove3->GetAsyncOutputs(y1);
+	} else {
+		lctRM3_ProcessInputs(bRehaMove3, u1, u2, y1);
+	}
+
+	bRehaMove3->StepTimingStop();
+}
+
+void lctRM3_InputOutputTiming( void **work1, double u1[], double u2[], double y1[], double y2[])
+{
+	// same as lctRM3_InputOutput, but with the step timing as additional output
+	lctRM3_InputOutput(work1, u1, u2, y1);
+	block_RehaMove3 *bRehaMove3 = (block_RehaMove3*) *work1;
+	bRehaMove3->GetStepTiming(y2);
 }
 
 void lctRM3_Deinitialise(void **work1 )
@@ -304,14 +415,18 @@ block_RehaMove3::block_RehaMove3(void)
 {
 	// initialise the parameters
 	Device = NULL;
+	memset(&this->Devices, 0, sizeof(this->Devices));
+	Manager = NULL;
+	registryUser = 0;
 	memset(&this->rmStatus, 0, sizeof(rmStatus_t));
 	memset(&this->stimOptions, 0, sizeof(stimOptions_t));
 	memset(&this->llOptions, 0, sizeof(llOptions_t));
 	memset(&this->mlOptions, 0, sizeof(mlOptions_t));
 	memset(&this->miscOptions, 0, sizeof(miscOptions_t));
 	memset(&this->ioSize, 0, sizeof(io_size_t));
+	memset(&this->stepTiming, 0, sizeof(stepTiming_t));
+	memset(&this->async, 0, sizeof(asyncMode_t));
 	this->sampleTime = 0.0;
-	this->LlSequenceID = 0;
 
 	memset(&this->rmResult, 0, sizeof(this->rmResult));
 	memset(&this->rmInitSettings, 0, sizeof(this->rmInitSettings));
@@ -321,12 +436,35 @@ block_RehaMove3::block_RehaMove3(void)
 }
 block_RehaMove3::~block_RehaMove3(void)
 {
+	// the worker threat uses the devices
+	block_RehaMove3::StopAsyncWorker();
+	if (this->miscOptions.debug.printStats){
+		block_RehaMove3::PrintStepTiming();
+	}
 #ifdef WITH_HW
-	if (!this->rmStatus.deviceInitialisationAborted){
-		this->Device->DeInitialiseDevice(this->miscOptions.debug.printInitInfos, this->miscOptions.debug.printStats);
+	if (Manager == NULL){
+		// shared device -> only the last block deinitialises and deletes it
+		if ((Device != NULL) && rmRegistryReleaseDevice(Device, this->registryUser)){
+			if (!this->rmStatus.deviceInitialisationAborted){
+				Device->DeInitialiseDevice(this->miscOptions.debug.printInitInfos, this->miscOptions.debug.printStats);
+			}
+			delete Device;
+		}
+	} else {
+		for (uint8_t iDevice = 0; iDevice < this->stimOptions.numberOfDevices; iDevice++){
+			if (!this->rmStatus.deviceInitialisationAborted){
+				this->Devices[iDevice]->DeInitialiseDevice(this->miscOptions.debug.printInitInfos, this->miscOptions.debug.printStats);
+			}
+		}
+		// the devices remove themselves from the manager
+		for (uint8_t iDevice = 0; iDevice < this->stimOptions.numberOfDevices; iDevice++){
+			delete this->Devices[iDevice];
+		}
+		delete Manager;
 	}
 	this->rmStatus.deviceIsInitialised = false;
-	delete Device;
+	memset(&this->Devices, 0, sizeof(this->Devices));
+	Device = NULL;
 #endif
 }
 
@@ -355,11 +493,33 @@ void block_RehaMove3::TransverStimOptions(uint16_t *parameter, uint16_t paramete
 	this->stimOptions.errorRetestAfter = (uint16_t)parameter[i++];
 	this->stimOptions.useThreadForInit   = (uint8_t)parameter[i++];
 	this->stimOptions.useThreadForAcks   = (uint8_t)parameter[i++];
+	// optional parameters -> not available in older block masks
+	this->stimOptions.threadSchedPolicy   = (i < parameterSize) ? (uint8_t)parameter[i++] : 0;
+	this->stimOptions.threadSchedPriority = (i < parameterSize) ? (uint8_t)parameter[i++] : 0;
+	if (i < parameterSize){
+		block_RehaMove3::CopyStringFromU16(this->stimOptions.threadCpus, &parameter[i+1], (uint16_t)parameter[i]);
+		i += (uint32_t)parameter[i] +1;
+	}
+	this->stimOptions.lockMemory          = (i < parameterSize) ? (uint8_t)parameter[i++] : 0;
+	this->stimOptions.autoReconnect       = (i < parameterSize) ? (uint8_t)parameter[i++] : 0;
+	this->stimOptions.asyncMode           = (i < parameterSize) ? (uint8_t)parameter[i++] : 0;
+
+	// several devices -> comma separated serial numbers and paths
+	uint8_t numberOfDeviceIDs = block_RehaMove3::SplitList(&this->stimOptions.deviceIDs[0][0], sizeof(this->stimOptions.deviceIDs[0]), RM3_N_DEVICES_MAX, this->stimOptions.deviceID);
+	uint8_t numberOfDevicePaths = block_RehaMove3::SplitList(&this->stimOptions.devicePaths[0][0], sizeof(this->stimOptions.devicePaths[0]), RM3_N_DEVICES_MAX, this->stimOptions.devicePath);
+	this->stimOptions.numberOfDevices = (numberOfDeviceIDs > numberOfDevicePaths) ? numberOfDeviceIDs : numberOfDevicePaths;
+	this->stimOptions.threadCpuAffinity = block_RehaMove3::GetCpuMask(this->stimOptions.threadCpus);
+	for (uint8_t i=0; i<this->stimOptions.numberOfActiveChannels; i++){
+		if (this->stimOptions.channelsActive[i] > REHAMOVE_NUMBER_OF_CHANNELS *this->stimOptions.numberOfDevices){
+			printf("%s Warning: The channel %u is not available with %u device(s) -> the channel is not used!\n", this->stimOptions.blockID, this->stimOptions.channelsActive[i], this->stimOptions.numberOfDevices);
+			this->stimOptions.channelsActive[i] = 0;
+		}
+	}
 
 	// update the rm init struct
-	if (strlen(this->stimOptions.deviceID) == 9){
+	if (strlen(this->stimOptions.deviceIDs[0]) == Smpt_Length_Device_Id){
 		this->rmInitSettings.checkDeviceIDs = true;
-		memcpy(this->rmInitSettings.RequestedDeviceID, this->stimOptions.deviceID, strlen(this->stimOptions.deviceID));
+		memcpy(this->rmInitSettings.RequestedDeviceID, this->stimOptions.deviceIDs[0], Smpt_Length_Device_Id);
 	}
 	this->rmInitSettings.StimConfig.rmProtocol 		= this->stimOptions.rmProtocol;
 	this->rmInitSettings.StimConfig.StimFrequency 		= this->stimOptions.stimFrequency;
@@ -369,11 +529,16 @@ void block_RehaMove3::TransverStimOptions(uint16_t *parameter, uint16_t paramete
 	this->rmInitSettings.StimConfig.ErrorRetestAfter   = this->stimOptions.errorRetestAfter;
 	this->rmInitSettings.StimConfig.UseThreadForInit   = (bool)this->stimOptions.useThreadForInit;
 	this->rmInitSettings.StimConfig.UseThreadForAcks   = (bool)this->stimOptions.useThreadForAcks;
+	this->rmInitSettings.StimConfig.ThreadSchedPolicy   = (int)this->stimOptions.threadSchedPolicy;
+	this->rmInitSettings.StimConfig.ThreadSchedPriority = (int)this->stimOptions.threadSchedPriority;
+	this->rmInitSettings.StimConfig.ThreadCpuAffinity   = this->stimOptions.threadCpuAffinity;
+	this->rmInitSettings.StimConfig.LockMemory          = (bool)this->stimOptions.lockMemory;
+	this->rmInitSettings.StimConfig.AutoReconnect       = (bool)this->stimOptions.autoReconnect;
 
 	// print debug output
 	if (this->miscOptions.debugPrintBlockParameter){
-		printf("%s Block Debug: General Parameter (%u values)\n  Block ID: '%s'\n  Device Serial Number: '%s'\n  Device Path: '%s'\n  Number of Active Channels: %u\n  Active Channels: [ ",
-				this->stimOptions.blockID, parameterSize, this->stimOptions.blockID,  this->stimOptions.deviceID, this->stimOptions.devicePath, this->stimOptions.numberOfActiveChannels);
+		printf("%s Block Debug: General Parameter (%u values)\n  Block ID: '%s'\n  Device Serial Number: '%s'\n  Device Path: '%s'\n  Number of Devices: %u\n  Number of Active Channels: %u\n  Active Channels: [ ",
+				this->stimOptions.blockID, parameterSize, this->stimOptions.blockID,  this->stimOptions.deviceID, this->stimOptions.devicePath, this->stimOptions.numberOfDevices, this->stimOptions.numberOfActiveChannels);
 		for (uint8_t i=0; i<this->stimOptions.numberOfActiveChannels; i++){
 			printf("%u ", this->stimOptions.channelsActive[i]);
 		}
@@ -385,8 +550,9 @@ void block_RehaMove3::TransverStimOptions(uint16_t *parameter, uint16_t paramete
 		}
 		printf("]\n  Stimulation Frequency: %u.00 Hz\n  RehaMove3 Protocol: %s\n  Max. Current: %0.1f mA\n  Max. Pulse Width: %u µs\n  Abort after N Errors: %u\n  ReTest after N seconds: %0.2f s\n",
 				this->stimOptions.stimFrequency, rmProtocol, this->stimOptions.maxCurrent, this->stimOptions.maxPulseWidth, this->stimOptions.errorAbortAfter, ((double)this->stimOptions.errorRetestAfter / (double)this->stimOptions.stimFrequency));
-		printf("  Use Thread for Init: %u\n  Use Thread for Data: %u\n",
-				this->stimOptions.useThreadForInit, this->stimOptions.useThreadForAcks);
+		printf("  Use Thread for Init: %u\n  Use Thread for Data: %u\n  Thread Scheduling Policy: %u (Priority: %u)\n  Thread CPUs: '%s' (mask 0x%llx)\n  Lock Memory: %u\n  Auto Reconnect: %u\n  Async Mode: %u\n",
+				this->stimOptions.useThreadForInit, this->stimOptions.useThreadForAcks, this->stimOptions.threadSchedPolicy, this->stimOptions.threadSchedPriority,
+				this->stimOptions.threadCpus, (unsigned long long)this->stimOptions.threadCpuAffinity, this->stimOptions.lockMemory, this->stimOptions.autoReconnect, this->stimOptions.asyncMode);
 	}
 }
 void block_RehaMove3::TransverLlOptions(uint16_t *parameter, uint16_t parameterSize)
@@ -400,10 +566,14 @@ void block_RehaMove3::TransverLlOptions(uint16_t *parameter, uint16_t parameterS
 	}
 	this->llOptions.maxStimVoltage = (uint8_t)parameter[i++];
 	this->llOptions.useDenervation = (uint8_t)parameter[i++];
+	// optional parameters -> not available in older block masks
+	this->llOptions.hybridStableSequences = (i < parameterSize) ? parameter[i++] : 0;
 
 
 	this->rmInitSettings.LowLevelConfig.HighVoltageLevel = this->llOptions.maxStimVoltage;
 	this->rmInitSettings.LowLevelConfig.UseDenervation = false; // TODO add feature if supported
+	this->rmInitSettings.LowLevelConfig.UseHybridMode = (this->llOptions.hybridStableSequences > 0) && (this->stimOptions.rmProtocol == RM3_LOW_LEVEL_STIMULATION_PROTOCOL1);
+	this->rmInitSettings.LowLevelConfig.HybridStableSequences = this->llOptions.hybridStableSequences;
 
 	if (this->miscOptions.debugPrintBlockParameter){
 		uint8_t maxStimVoltage = 0;
@@ -422,8 +592,8 @@ void block_RehaMove3::TransverLlOptions(uint16_t *parameter, uint16_t parameterS
 		for (uint8_t i=0; i<this->stimOptions.numberOfActiveChannels; i++){
 			printf("%u ", this->llOptions.channelsPulseForm[i]);
 		}
-		printf("]\n  Pulse Form given as Input: %u\n  Number of Pulse Parts: %u\n  Max. Stimulation Voltage: %u V\n",
-				this->llOptions.pulseFormGivenAsInput, this->llOptions.numberOfPulseParts, maxStimVoltage);
+		printf("]\n  Pulse Form given as Input: %u\n  Number of Pulse Parts: %u\n  Max. Stimulation Voltage: %u V\n  Hybrid mode after N stable sequences (0 -> off): %u\n",
+				this->llOptions.pulseFormGivenAsInput, this->llOptions.numberOfPulseParts, maxStimVoltage, this->llOptions.hybridStableSequences);
 	}
 }
 void block_RehaMove3::TransverMlOptions(double *parameter, uint16_t parameterSize)
@@ -436,6 +606,9 @@ void block_RehaMove3::TransverMlOptions(double *parameter, uint16_t parameterSiz
 	this->mlOptions.rampsUpdates = parameter[i++];
 	this->mlOptions.rampsZeroUpdates = parameter[i++];
 	this->mlOptions.nKeepAlive = parameter[i++];
+	// optional parameters -> not available in older block masks
+	this->mlOptions.keepAlivePeriod = (i < parameterSize) ? parameter[i++] : 0.0;
+	this->mlOptions.updateMinPeriod = (i < parameterSize) ? parameter[i++] : 0.0;
 
 	this-> rmInitSettings.MidLevelConfig.GeneralStimFrequency = this->mlOptions.fStimML;
 	this-> rmInitSettings.MidLevelConfig.UseDynamicStimulationFrequncy = this->mlOptions.useDynamicStimulationFrequncy;
@@ -446,10 +619,14 @@ void block_RehaMove3::TransverMlOptions(double *parameter, uint16_t parameterSiz
 	this-> rmInitSettings.MidLevelConfig.RampsZeroUpdates = this->mlOptions.rampsZeroUpdates;
 	this-> rmInitSettings.MidLevelConfig.SendKeepAliveSignalDuringPeriodicMlUpdateCall = true;
 	this-> rmInitSettings.MidLevelConfig.KeepAliveNumberOfUpdateCalls = this->mlOptions.nKeepAlive;
+	this-> rmInitSettings.MidLevelConfig.UseTimerForKeepAliveSignal = (this->mlOptions.keepAlivePeriod > 0.0);
+	this-> rmInitSettings.MidLevelConfig.KeepAlivePeriod_ms = this->mlOptions.keepAlivePeriod;
+	this-> rmInitSettings.MidLevelConfig.UseUpdateMailbox = (this->mlOptions.updateMinPeriod > 0.0);
+	this-> rmInitSettings.MidLevelConfig.UpdateMinPeriod_ms = this->mlOptions.updateMinPeriod;
 
 	if (this->miscOptions.debugPrintBlockParameter){
-		printf("%s Block Debug: MidLevel Parameter (%u values)\n  Stimulation Frequency: %f; dynamic: %u\n  Number of In/Out calls until KeepAlive signal is send: %1.0f\n  SoftStart: %u\n  intensity ramp up: %u; during %1.0f updates; re-do the ramp after %1.0f zero updates\n",
-						this->stimOptions.blockID, parameterSize, this->mlOptions.fStimML, this->mlOptions.useDynamicStimulationFrequncy, this->mlOptions.nKeepAlive, this->mlOptions.useSoftStart,
+		printf("%s Block Debug: MidLevel Parameter (%u values)\n  Stimulation Frequency: %f; dynamic: %u\n  Number of In/Out calls until KeepAlive signal is send: %1.0f\n  KeepAlive period (0 -> use In/Out calls): %1.0f ms\n  Min. update period of the update thread (0 -> send directly): %1.1f ms\n  SoftStart: %u\n  intensity ramp up: %u; during %1.0f updates; re-do the ramp after %1.0f zero updates\n",
+						this->stimOptions.blockID, parameterSize, this->mlOptions.fStimML, this->mlOptions.useDynamicStimulationFrequncy, this->mlOptions.nKeepAlive, this->mlOptions.keepAlivePeriod, this->mlOptions.updateMinPeriod, this->mlOptions.useSoftStart,
 						this->mlOptions.useRamps, this->mlOptions.rampsUpdates, this->mlOptions.rampsZeroUpdates);
 	}
 }
@@ -471,6 +648,8 @@ void block_RehaMove3::TransverMiscOptions(uint16_t *parameter, uint16_t paramete
 
 	this->miscOptions.enableAdvancedSettings = (bool)parameter[i++];
 	this->miscOptions.debug.disableVersionCheck = (bool)parameter[i++];
+	// optional parameters -> not available in older block masks
+	this->miscOptions.stepOverrunPercent = (i < parameterSize) ? parameter[i++] : RM3_STEP_TIMING_OVERRUN_DEFAULT;
 
 	memcpy(&this->rmInitSettings.DebugConfig, &this->miscOptions.debug, sizeof(this->rmInitSettings.DebugConfig));
 
@@ -479,12 +658,259 @@ void block_RehaMove3::TransverMiscOptions(uint16_t *parameter, uint16_t paramete
 		if (this->miscOptions.debugPrintBlockParameter){
 			printf("%s Block Debug: Misc Parameter (%u values)\n  Print Block Parameter: %u\n  Print Device Infos: %u\n  Print Init Infos: %u\n  Print Init Settings: %u\n  Print Send CMD Infos: %u\n  Print Received ACK Infos: %u\n  Print Pulse Config; %u\n  Print Sequence Errors: %u\n  Print Timing Errors: %u\n  Print Input Corrections / Unbalanced Charge: %u\n  Print Stats: %u\n  Use Colors for Errors/Warnings: %u\n",
 					this->stimOptions.blockID, parameterSize, this->miscOptions.debugPrintBlockParameter, this->miscOptions.debug.printDeviceInfos, this->miscOptions.debug.printInitInfos, this->miscOptions.debug.printInitSettings, this->miscOptions.debug.printSendCmdInfos, this->miscOptions.debug.printReceivedAckInfos, this->miscOptions.debug.printStimInfos, this->miscOptions.debug.printErrorsSequence, this->miscOptions.debug.printErrorsTiming, this->miscOptions.debug.printCorrectionChargeWarnings, this->miscOptions.debug.printStats, this->miscOptions.debug.useColors);
-			printf("  Enable Advanced Settings: %u\n  Disable Version Check: %u\n",
-					this->miscOptions.enableAdvancedSettings, this->miscOptions.disableVersionCheck);
+			printf("  Enable Advanced Settings: %u\n  Disable Version Check: %u\n  Step Overrun after: %u%% of the sample time\n",
+					this->miscOptions.enableAdvancedSettings, this->miscOptions.disableVersionCheck, this->miscOptions.stepOverrunPercent);
+		}
+	}
+}
+
+
+void *lctRM3_AsyncWorkerFunc(void *data)
+{
+	block_RehaMove3 *bRehaMove3 = (block_RehaMove3 *) data;
+	bRehaMove3->RunAsyncWorker();
+	pthread_exit(NULL);
+}
+
+bool block_RehaMove3::StartAsyncWorker(void)
+{
+	// double buffer for the inputs and one buffer for the worker
+	this->async.sizeInput1 = (uint32_t)this->ioSize.sizeStimIn1 *(uint32_t)this->ioSize.sizeStimIn2_1;
+	this->async.sizeInput2 = (uint32_t)this->ioSize.sizeStimIn1 *(uint32_t)this->ioSize.sizeStimIn2_2;
+	for (uint8_t i = 0; i < 3; i++){
+		this->async.inputs1[i] = (double *)calloc(this->async.sizeInput1 +1, sizeof(double));
+		this->async.inputs2[i] = (double *)calloc(this->async.sizeInput2 +1, sizeof(double));
+		if ((this->async.inputs1[i] == NULL) || (this->async.inputs2[i] == NULL)){
+			printf("%s Error: The buffers for the async mode could not be allocated! -> The inputs are processed in the step.\n", this->stimOptions.blockID);
+			block_RehaMove3::StopAsyncWorker();
+			return false;
 		}
 	}
+	// status until the worker processed the first inputs
+	this->async.outputs[0] = this->rmStatus.stimStatus1;
+	this->async.outputs[1] = 0.0;
+	this->async.inputCounter.Store(0);
+	sem_init(&this->async.newInputs, 0, 0);
+	this->async.semaphoreCreated = true;
+
+	this->async.workerActive.Store(true);
+	// the worker sends the stimulation -> same scheduling policy, priority and CPU affinity as the threats of the device
+	int returnValue = nsRehaMove3_SMPT_32X_01::RehaMove3::CreateThreadWithAttributes(&this->async.workerThread, lctRM3_AsyncWorkerFunc, (void *)this,
+			(int)this->stimOptions.threadSchedPolicy, (int)this->stimOptions.threadSchedPriority, (uint64_t)this->stimOptions.threadCpuAffinity);
+	if (returnValue != 0){
+		// the attributes are not allowed (e.g. no root) -> default attributes
+		printf("%s Warning: The worker threat for the async mode could not be started with the scheduling policy %d (priority %d) and the CPU mask 0x%lx:\n     -> %s (%d)\n     -> Using the default attributes instead.\n",
+				this->stimOptions.blockID, (int)this->stimOptions.threadSchedPolicy, (int)this->stimOptions.threadSchedPriority, (unsigned long)this->stimOptions.threadCpuAffinity,
+				strerror(returnValue), returnValue);
+		returnValue = pthread_create(&this->async.workerThread, NULL, lctRM3_AsyncWorkerFunc, (void *)this);
+	}
+	if (returnValue != 0){
+		printf("%s Error: The worker threat for the async mode could not be started:\n     -> %s (%d)\n     -> The inputs are processed in the step.\n", this->stimOptions.blockID, strerror(returnValue), returnValue);
+		this->async.workerActive.Store(false);
+		block_RehaMove3::StopAsyncWorker();
+		return false;
+	}
+	this->async.workerStarted = true;
+	return true;
 }
 
+void block_RehaMove3::StopAsyncWorker(void)
+{
+	this->async.workerActive.Store(false);
+	if (this->async.workerStarted){
+		// wake the worker and wait until it is done
+		sem_post(&this->async.newInputs);
+		pthread_join(this->async.workerThread, NULL);
+		this->async.workerStarted = false;
+		if (this->miscOptions.debug.printStats){
+			printf("%s: Async mode -> inputs processed: %" PRIu64 "; inputs skipped (overwritten by a newer step): %" PRIu64 "\n",
+					this->stimOptions.blockID, this->async.inputsProcessed, this->async.inputsSkipped);
+		}
+	}
+	if (this->async.semaphoreCreated){
+		sem_destroy(&this->async.newInputs);
+		this->async.semaphoreCreated = false;
+	}
+	for (uint8_t i = 0; i < 3; i++){
+		free(this->async.inputs1[i]);
+		free(this->async.inputs2[i]);
+		this->async.inputs1[i] = NULL;
+		this->async.inputs2[i] = NULL;
+	}
+}
+
+void block_RehaMove3::PostAsyncInputs(double *u1, double *u2)
+{
+	// write the slot, which is not published -> the worker reads the other one
+	uint32_t counter = this->async.inputCounter.Load() +1;
+	memcpy(this->async.inputs1[counter & 1], u1, this->async.sizeInput1 *sizeof(double));
+	memcpy(this->async.inputs2[counter & 1], u2, this->async.sizeInput2 *sizeof(double));
+	this->async.inputCounter.Store(counter);
+	sem_post(&this->async.newInputs);
+}
+
+void block_RehaMove3::GetAsyncOutputs(double *y1)
+{
+	uint32_t start;
+	do {
+		start = this->async.outputLock.ReadBegin();
+		y1[0] = this->async.outputs[0];
+		y1[1] = this->async.outputs[1];
+	} while (this->async.outputLock.ReadRetry(start));
+}
+
+void block_RehaMove3::RunAsyncWorker(void)
+{
+	uint32_t counterProcessed = 0;
+	double y1[2] = {0.0, 0.0};
+	this->async.workerRunning.Store(true);
+
+	while (this->async.workerActive.Load()){
+		if (sem_wait(&this->async.newInputs) != 0){
+			continue;
+		}
+		if (!this->async.workerActive.Load()){
+			break;
+		}
+		// the step was faster than the worker -> only the latest inputs are processed
+		while (sem_trywait(&this->async.newInputs) == 0) {}
+
+		// copy the latest slot; it is only written again after the step published the next inputs -> retry then
+		uint32_t counter;
+		do {
+			counter = this->async.inputCounter.Load();
+			memcpy(this->async.inputs1[2], this->async.inputs1[counter & 1], this->async.sizeInput1 *sizeof(double));
+			memcpy(this->async.inputs2[2], this->async.inputs2[counter & 1], this->async.sizeInput2 *sizeof(double));
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		} while (this->async.inputCounter.Load() != counter);
+		if (counter == counterProcessed){
+			continue;
+		}
+		this->async.inputsSkipped += counter - counterProcessed -1;
+		this->async.inputsProcessed++;
+		counterProcessed = counter;
+
+		lctRM3_ProcessInputs(this, this->async.inputs1[2], this->async.inputs2[2], y1);
+
+		this->async.outputLock.WriteBegin();
+		this->async.outputs[0] = y1[0];
+		this->async.outputs[1] = y1[1];
+		this->async.outputLock.WriteEnd();
+	}
+
+	// done
+	this->async.workerRunning.Store(false);
+}
+
+void block_RehaMove3::StepTimingStart(void)
+{
+	uint64_t timeNow_ns = block_RehaMove3::GetMonotonicTime_ns();
+	uint64_t sampleTime_ns = (uint64_t)(this->sampleTime *1e9);
+
+	// call-to-call period
+	if (this->stepTiming.lastStart_ns != 0){
+		uint64_t period_ns = timeNow_ns - this->stepTiming.lastStart_ns;
+		uint64_t jitter_ns = (period_ns > sampleTime_ns) ? (period_ns - sampleTime_ns) : (sampleTime_ns - period_ns);
+		this->stepTiming.lastPeriod_ns = period_ns;
+		if ((this->stepTiming.numberOfPeriods == 0) || (period_ns < this->stepTiming.minPeriod_ns)){
+			this->stepTiming.minPeriod_ns = period_ns;
+		}
+		if (period_ns > this->stepTiming.maxPeriod_ns){
+			this->stepTiming.maxPeriod_ns = period_ns;
+		}
+		if (jitter_ns > this->stepTiming.maxPeriodJitter_ns){
+			this->stepTiming.maxPeriodJitter_ns = jitter_ns;
+		}
+		if ((double)jitter_ns > ((double)this->miscOptions.stepOverrunPercent /100.0) *(double)sampleTime_ns){
+			this->stepTiming.periodOverruns++;
+		}
+		this->stepTiming.sumPeriod_ns += (double)period_ns;
+		this->stepTiming.numberOfPeriods++;
+		this->stepTiming.histogramPeriod[block_RehaMove3::GetStepTimingBin(period_ns)]++;
+	}
+	this->stepTiming.lastStart_ns = timeNow_ns;
+}
+
+void block_RehaMove3::StepTimingStop(void)
+{
+	uint64_t exec_ns = block_RehaMove3::GetMonotonicTime_ns() - this->stepTiming.lastStart_ns;
+	uint64_t sampleTime_ns = (uint64_t)(this->sampleTime *1e9);
+
+	this->stepTiming.lastExec_ns = exec_ns;
+	if (exec_ns > this->stepTiming.maxExec_ns){
+		this->stepTiming.maxExec_ns = exec_ns;
+	}
+	if ((double)exec_ns > ((double)this->miscOptions.stepOverrunPercent /100.0) *(double)sampleTime_ns){
+		this->stepTiming.execOverruns++;
+	}
+	this->stepTiming.sumExec_ns += (double)exec_ns;
+	this->stepTiming.numberOfSteps++;
+	this->stepTiming.histogramExec[block_RehaMove3::GetStepTimingBin(exec_ns)]++;
+}
+
+void block_RehaMove3::GetStepTiming(double *timing)
+{
+	// [execution time (ms), period (ms), max. execution time (ms), max. period jitter (ms), execution overruns, period overruns]
+	timing[0] = (double)this->stepTiming.lastExec_ns /1e6;
+	timing[1] = (double)this->stepTiming.lastPeriod_ns /1e6;
+	timing[2] = (double)this->stepTiming.maxExec_ns /1e6;
+	timing[3] = (double)this->stepTiming.maxPeriodJitter_ns /1e6;
+	timing[4] = (double)this->stepTiming.execOverruns;
+	timing[5] = (double)this->stepTiming.periodOverruns;
+}
+
+void block_RehaMove3::PrintStepTiming(void)
+{
+	if (this->stepTiming.numberOfSteps == 0){
+		return;
+	}
+	printf("%s: Statistic Report Step Timing (sample time %0.3f ms; overrun after %u%% of the sample time):\n     -> Steps: %" PRIu64 "\n     -> Execution time: mean %0.3f ms; max. %0.3f ms; overruns: %" PRIu64 "\n",
+			this->stimOptions.blockID, this->sampleTime *1e3, this->miscOptions.stepOverrunPercent, this->stepTiming.numberOfSteps,
+			this->stepTiming.sumExec_ns /(double)this->stepTiming.numberOfSteps /1e6, (double)this->stepTiming.maxExec_ns /1e6, this->stepTiming.execOverruns);
+	if (this->stepTiming.numberOfPeriods > 0){
+		printf("     -> Period: mean %0.3f ms; min. %0.3f ms; max. %0.3f ms; max. jitter %0.3f ms; overruns: %" PRIu64 "\n",
+				this->stepTiming.sumPeriod_ns /(double)this->stepTiming.numberOfPeriods /1e6, (double)this->stepTiming.minPeriod_ns /1e6, (double)this->stepTiming.maxPeriod_ns /1e6,
+				(double)this->stepTiming.maxPeriodJitter_ns /1e6, this->stepTiming.periodOverruns);
+	}
+	printf("     -> Histogram (in %% of the sample time):      execution time         period\n");
+	for (uint8_t i = 0; i < RM3_STEP_TIMING_HISTOGRAM_BINS; i++){
+		if ((this->stepTiming.histogramExec[i] == 0) && (this->stepTiming.histogramPeriod[i] == 0)){
+			continue;
+		}
+		if (i < RM3_STEP_TIMING_HISTOGRAM_BINS -1){
+			printf("        -> %3u%% - %3u%%: %25lu %14lu\n", i*10, (i+1)*10, (unsigned long)this->stepTiming.histogramExec[i], (unsigned long)this->stepTiming.histogramPeriod[i]);
+		} else {
+			printf("        -> >= %3u%%:     %25lu %14lu\n", i*10, (unsigned long)this->stepTiming.histogramExec[i], (unsigned long)this->stepTiming.histogramPeriod[i]);
+		}
+	}
+}
+
+
+void block_RehaMove3::SetInitialisationError(RehaMove3::actionResult_t *result)
+{
+	// take care of specific errors
+	switch(result->errorCode){
+	case actionError_openingDevice:
+		this->rmStatus.deviceOpeningFailed = true;
+		this->rmStatus.stimStatus1 = (double)block_RehaMove3::blockError_openingDevice;
+		break;
+	case actionError_checkDeviceIDs:
+		this->rmStatus.deviceIDsDidNotMatch = true;
+		this->rmStatus.stimStatus1 = (double)block_RehaMove3::blockError_checkDeviceIDs;
+		break;
+	default:;
+	}
+}
+
+bool block_RehaMove3::IsReconnecting(void)
+{
+	for (uint8_t iDevice = 0; iDevice < this->stimOptions.numberOfDevices; iDevice++){
+		if (this->Devices[iDevice]->IsReconnecting()){
+			return true;
+		}
+	}
+	return false;
+}
 
 void block_RehaMove3::CopyStringFromU16(char *to, uint16_t *from, uint16_t numberOfLetters)
 {
@@ -492,3 +918,81 @@ void block_RehaMove3::CopyStringFromU16(char *to, uint16_t *from, uint16_t numbe
 		to[i] = (uint8_t)from[i];
 	}
 }
+
+uint8_t block_RehaMove3::SplitList(char *list, uint16_t itemSize, uint8_t maxItems, const char *from)
+{
+	// comma separated list -> an empty list is one empty item
+	uint8_t numberOfItems = 1;
+	uint16_t iLetter = 0;
+	memset(list, 0, itemSize *maxItems);
+	for (uint16_t i=0; from[i] != 0; i++){
+		if (from[i] == ','){
+			if (numberOfItems >= maxItems){
+				break;
+			}
+			numberOfItems++;
+			iLetter = 0;
+			continue;
+		}
+		if ((from[i] == ' ') || (iLetter >= itemSize -1)){
+			continue;
+		}
+		list[(numberOfItems -1) *itemSize + iLetter++] = from[i];
+	}
+	return numberOfItems;
+}
+
+uint64_t block_RehaMove3::GetCpuMask(const char *cpuList)
+{
+	// CPU list, e.g. "2,4-7" -> bit mask; the library supports the CPUs 0-63
+	uint64_t mask = 0;
+	const char *position = cpuList;
+	while (*position != 0){
+		if ((*position == ' ') || (*position == ',')){
+			position++;
+			continue;
+		}
+		char *end = NULL;
+		unsigned long first = strtoul(position, &end, 10);
+		if (end == position){
+			printf("%s Warning: The CPU list '%s' is invalid -> the threats use all CPUs!\n", this->stimOptions.blockID, cpuList);
+			return 0;
+		}
+		unsigned long last = first;
+		position = end;
+		if (*position == '-'){
+			last = strtoul(position +1, &end, 10);
+			if ((end == position +1) || (last < first)){
+				printf("%s Warning: The CPU list '%s' is invalid -> the threats use all CPUs!\n", this->stimOptions.blockID, cpuList);
+				return 0;
+			}
+			position = end;
+		}
+		for (unsigned long iCpu=first; iCpu<=last; iCpu++){
+			if (iCpu >= 64){
+				printf("%s Warning: Only the CPUs 0-63 can be used for the threats -> the CPU %lu is ignored!\n", this->stimOptions.blockID, iCpu);
+				break;
+			}
+			mask |= ((uint64_t)1) << iCpu;
+		}
+	}
+	return mask;
+}
+
+uint64_t block_RehaMove3::GetMonotonicTime_ns(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return ((uint64_t)time.tv_sec *1000000000) + (uint64_t)time.tv_nsec;
+}
+
+uint8_t block_RehaMove3::GetStepTimingBin(uint64_t time_ns)
+{
+	// 10% of the sample time per bin
+	double binWidth_ns = this->sampleTime *1e8;
+	if (binWidth_ns <= 0.0){
+		return RM3_STEP_TIMING_HISTOGRAM_BINS -1;
+	}
+	double bin = floor((double)time_ns /binWidth_ns);
+	return (bin >= (double)(RM3_STEP_TIMING_HISTOGRAM_BINS -1)) ? (RM3_STEP_TIMING_HISTOGRAM_BINS -1) : (uint8_t)bin;
+}
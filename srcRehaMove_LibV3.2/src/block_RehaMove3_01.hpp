@@ -22,26 +22,35 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <cmath>
+#include <semaphore.h>
 
 #ifndef BLOCK_REHAMOVE3_01_HPP
 #define BLOCK_REHAMOVE3_01_HPP
 
 #include <RehaMove3Interface_SMPT32X.hpp>
+#include <RehaMove3Manager.hpp>
+#include <RehaMove3Registry.hpp>
 using namespace nsRehaMove3_SMPT_32X_01;
 
 
 // Constants
 #define RM3_N_PULSES_MAX					10
+#define RM3_N_DEVICES_MAX					3		// the channels 1-4 are on the first device, 5-8 on the second device, ...
 #define RM3_STRING_SIZE_MAX					512
 
 #define RM3_LOW_LEVEL_STIMULATION_PROTOCOL1	1
 #define RM3_LOW_LEVEL_STIMULATION_PROTOCOL2	2
 #define RM3_MID_LEVEL_STIMULATION_PROTOCOL	3
 
+#define RM3_STEP_TIMING_HISTOGRAM_BINS		21		// bins of 10% of the sample time; the last bin counts everything >= 200%
+#define RM3_STEP_TIMING_OUTPUTS				6
+#define RM3_STEP_TIMING_OVERRUN_DEFAULT		50		// in % of the sample time
+
 
 //sfunc_RehaMove3_XX
 void lctRM3_Initialise(  void **work1, uint16_t stimOptions[], uint16_t sizeStimOptions, uint16_t llOptions[], uint16_t sizeLlOptions, double mlOptions[], uint16_t sizeMlOptions, uint16_t miscOptions[], uint16_t sizeMiscOptions, uint16_t inputSize1, uint16_t inputSize2_1, uint16_t inputSize2_2, double sampleTime );
 void lctRM3_InputOutput( void **work1, double u1[], double u2[], double y1[]);
+void lctRM3_InputOutputTiming( void **work1, double u1[], double u2[], double y1[], double y2[]);
 void lctRM3_Deinitialise(void **work1);
 
 
@@ -60,12 +69,16 @@ public:
 		blockError_initLL           = -7,
 		blockError_initML			= -8,
 		blockError_initAborted		= -10,
+		blockError_reconnecting		= -11,
 		blockError_customPF_ChannelMismatch	= -20,
 		blockError_unknownProtocol	= -21
 	};
 
 	//public variables
-	RehaMove3 *Device;
+	RehaMove3 *Device;		// first device
+	RehaMove3 *Devices[RM3_N_DEVICES_MAX];
+	RehaMove3Manager *Manager;	// only with several devices -> reads the acknowledgements and splits the sequences
+	uint8_t registryUser;		// one device -> the device is shared with the other blocks using the same device path (registry)
 
 	struct rmStatus_t {
 		bool deviceInitialisationAborted;
@@ -79,12 +92,18 @@ public:
 		uint32_t outputCounterNext;
 	} rmStatus;
 
-	// stimOptions = [size(stimDeviceID,2), uint8(stimDeviceID), size(stimDevicePath,2), uint8(stimDevicePath),
-	// size(stimChannels,2), uint8(stimChannels), stimFrequency, stimRMrotocol, stimMaxCurrent, stimMaxPulsWidth];
+	// stimOptions = [size(stimDeviceID,2), uint8(stimDeviceID), size(stimDevicePath,2), uint8(stimDevicePath), -> stimDevicePath = '' -> the device is searched by stimDeviceID
+	// -> several devices: comma separated lists, e.g. stimDevicePath = '/dev/ttyUSB0,/dev/ttyUSB1' -> channels 1-4 and 5-8
+	// size(stimChannels,2), uint8(stimChannels), stimFrequency, stimRMrotocol, stimMaxCurrent, stimMaxPulsWidth,
+	// (stimThreadPolicy -1, stimThreadPriority, size(stimThreadCpus,2), uint8(stimThreadCpus), stimLockMemory, stimAutoReconnect, stimAsyncMode)];
+	// -> stimThreadCpus: CPU list, e.g. '2,4-7'; '' -> all CPUs
 	struct stimOptions_t{
 		char    blockID[RM3_STRING_SIZE_MAX];
 		char    deviceID[RM3_STRING_SIZE_MAX];
 		char    devicePath[RM3_STRING_SIZE_MAX];
+		uint8_t numberOfDevices;
+		char    deviceIDs[RM3_N_DEVICES_MAX][Smpt_Length_Device_Id+1];
+		char    devicePaths[RM3_N_DEVICES_MAX][RM3_STRING_SIZE_MAX];
 		uint8_t numberOfActiveChannels;
 		uint8_t channelsActive[RM3_N_PULSES_MAX];
 		uint8_t stimFrequency;
@@ -95,16 +114,24 @@ public:
 		uint16_t errorRetestAfter;
 		uint8_t useThreadForInit;
 		uint8_t useThreadForAcks;
+		uint8_t threadSchedPolicy;
+		uint8_t threadSchedPriority;
+		char    threadCpus[RM3_STRING_SIZE_MAX];
+		uint64_t threadCpuAffinity;	// mask of threadCpus -> CPUs 0-63
+		uint8_t lockMemory;
+		uint8_t autoReconnect;
+		uint8_t asyncMode;		// the step only posts the inputs; a worker threat reads the results and sends the sequences
 	} stimOptions;
-	//llOptions = [ size(llPulseShape,2), uint16(llPulseShape), llNumberOfParts, uint16(llMaxStimVoltageValue) ];
+	//llOptions = [ size(llPulseShape,2), uint16(llPulseShape), llNumberOfParts, uint16(llMaxStimVoltageValue), llUseDenervation, (llHybridStableSequences) ];
 	struct llOptions_t{
 		uint8_t channelsPulseForm[RM3_N_PULSES_MAX];
 		bool	pulseFormGivenAsInput;
 		uint8_t	numberOfPulseParts;
 		uint8_t	maxStimVoltage;
 		uint8_t useDenervation;
+		uint16_t hybridStableSequences;
 	} llOptions;
-	// mlOptions = [ double(mlFStim), mlFStimDynamic, mlUseSoftStart, mlUseRamps, mlRampsUpdates, mlRampsZeroUpdates ];
+	// mlOptions = [ double(mlFStim), mlFStimDynamic, mlUseSoftStart, mlUseRamps, mlRampsUpdates, mlRampsZeroUpdates, mlNKeepAlive, (mlKeepAlivePeriod), (mlUpdateMinPeriod) ];
 	struct mlOptions_t{
 		double fStimML;
 		bool   useDynamicStimulationFrequncy;
@@ -113,29 +140,67 @@ public:
 		double rampsUpdates;
 		double rampsZeroUpdates;
 		double nKeepAlive;
+		double keepAlivePeriod;
+		double updateMinPeriod;
 	} mlOptions;
 	// miscOptions= [uint8(miscPrintBlockParam), miscPrintDeviceInfos, miscPrintInitInfos, miscPrintRMInitSettings,
 	// miscPrintSendInfos, miscPrintReceiveInfos, miscPrintStimInfos, miscPrintSequenceErrors,
-	// miscPrintCorrectionChargeWarnings, miscPrintStats, miscUseColors,   miscEnableAdvancedSettings, miscDisableVersionCheck];
+	// miscPrintCorrectionChargeWarnings, miscPrintStats, miscUseColors,   miscEnableAdvancedSettings, miscDisableVersionCheck, (miscStepOverrunPercent)];
 	struct miscOptions_t{
 		bool debugPrintBlockParameter;
 		RehaMove3::rmDebugSettings_t debug;
 		bool enableAdvancedSettings;
 		bool disableVersionCheck;
+		uint16_t stepOverrunPercent;
 	} miscOptions;
+	// timing of the InputOutput calls -> execution time and call-to-call period
+	struct stepTiming_t {
+		uint64_t lastStart_ns;
+		uint64_t lastPeriod_ns;
+		uint64_t lastExec_ns;
+		uint64_t minPeriod_ns;
+		uint64_t maxPeriod_ns;
+		uint64_t maxPeriodJitter_ns;
+		uint64_t maxExec_ns;
+		double	 sumPeriod_ns;
+		double	 sumExec_ns;
+		uint64_t numberOfSteps;
+		uint64_t numberOfPeriods;
+		uint64_t execOverruns;
+		uint64_t periodOverruns;
+		uint64_t histogramExec[RM3_STEP_TIMING_HISTOGRAM_BINS];
+		uint64_t histogramPeriod[RM3_STEP_TIMING_HISTOGRAM_BINS];
+	} stepTiming;
+	// async mode -> the step writes the inputs into the free slot of a double buffer and returns the latest status of the worker
+	struct asyncMode_t {
+		double	*inputs1[3];			// slot (inputCounter & 1) holds the latest inputs; slot 2 is the copy of the worker
+		double	*inputs2[3];
+		uint32_t sizeInput1;
+		uint32_t sizeInput2;
+		rmAtomic<uint32_t> inputCounter;
+		sem_t	 newInputs;
+		bool	 semaphoreCreated;
+		pthread_t workerThread;
+		bool	 workerStarted;
+		rmAtomic<bool> workerRunning;
+		rmAtomic<bool> workerActive;
+		rmSeqLock outputLock;			// written by the worker
+		double	 outputs[2];
+		uint64_t inputsProcessed;
+		uint64_t inputsSkipped;			// overwritten by a newer step before the worker took them
+	} async;
 	struct io_size_t {
 		uint16_t sizeStimIn1;
 		uint16_t sizeStimIn2_1;
 		uint16_t sizeStimIn2_2;
 	} ioSize;
 	double sampleTime;
-	uint64_t LlSequenceID;
 
-	RehaMove3::actionResult_t 			rmResult;
+	RehaMove3::actionResult_t 			rmResult[RM3_N_DEVICES_MAX];
 	RehaMove3::rmInitSettings_t 		rmInitSettings;
 	RehaMove3::LlSequenceConfig_t		LlSequenceConfig;
 	RehaMove3::CustomLlSequenceConfig_t	LlCustomSequenceConfig;
-	RehaMove3::MlUpdateConfig_t			MlUpdateConfig;
+	RehaMove3::MlUpdateConfig_t			MlUpdateConfig[RM3_N_DEVICES_MAX];
 
 	//public functions
 	block_RehaMove3(void);
@@ -146,11 +211,29 @@ public:
 	void	TransverMlOptions(double *parameter, uint16_t parameterSize);
 	void	TransverMiscOptions(uint16_t *parameter, uint16_t parameterSize, bool printDebugInfo);
 
+	void	SetInitialisationError(RehaMove3::actionResult_t *result);
+
+	bool	StartAsyncWorker(void);
+	void	StopAsyncWorker(void);
+	void	PostAsyncInputs(double *u1, double *u2);
+	void	GetAsyncOutputs(double *y1);
+	void	RunAsyncWorker(void);
+	bool	IsReconnecting(void);
+
+	void	StepTimingStart(void);
+	void	StepTimingStop(void);
+	void	GetStepTiming(double *timing);
+	void	PrintStepTiming(void);
+
 private:
 	//private variables
 
 	//private functions
 	void	CopyStringFromU16(char *to, uint16_t *from, uint16_t numberOfLetters);
+	uint8_t	SplitList(char *list, uint16_t itemSize, uint8_t maxItems, const char *from);
+	uint64_t GetCpuMask(const char *cpuList);
+	uint64_t GetMonotonicTime_ns(void);
+	uint8_t	GetStepTimingBin(uint64_t time_ns);
 };
 
 #endif // BLOCK_REHAMOVE3_01_HPP